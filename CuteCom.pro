@@ -22,6 +22,11 @@ greaterThan(QT_MAJOR_VERSION, 4){
 TARGET = CuteCom
 TEMPLATE = app
 
+# plugin libraries resolve the Plugin class from the executable
+unix:QMAKE_LFLAGS += -rdynamic
+# openpty() of the PTY multiplexer
+unix:!macx: LIBS += -lutil
+
 
 SOURCES += main.cpp\
         mainwindow.cpp \
@@ -42,7 +47,32 @@ SOURCES += main.cpp\
     netproxyplugin.cpp \
     netproxysettings.cpp \
     counterplugin.cpp \
-    controlpanel.cpp
+    controlpanel.cpp \
+    captureclock.cpp \
+    patternmatcher.cpp \
+    sendexpect.cpp \
+    sendexpectplugin.cpp \
+    autoresponder.cpp \
+    autoresponderplugin.cpp \
+    pluginrxqueue.cpp \
+    throughputmeter.cpp \
+    framedecoder.cpp \
+    framedecoderplugin.cpp \
+    modbusrtu.cpp \
+    modbusplugin.cpp \
+    utf8decoder.cpp \
+    terminalemulator.cpp \
+    terminalview.cpp \
+    triggercapture.cpp \
+    triggercaptureplugin.cpp \
+    netproxybridge.cpp \
+    rfc2217.cpp \
+    ptymux.cpp \
+    ptymuxplugin.cpp \
+    timeline.cpp \
+    timelinewindow.cpp \
+    headlesscapture.cpp \
+    txencoder.cpp
 
 HEADERS  += mainwindow.h \
     controlpanel.h \
@@ -63,7 +93,33 @@ HEADERS  += mainwindow.h \
     netproxyplugin.h \
     netproxysettings.h \
     counterplugin.h \
-    counterplugin.h
+    counterplugin.h \
+    captureclock.h \
+    patternmatcher.h \
+    sendexpect.h \
+    sendexpectplugin.h \
+    autoresponder.h \
+    autoresponderplugin.h \
+    pluginrxqueue.h \
+    plugininterface.h \
+    throughputmeter.h \
+    framedecoder.h \
+    framedecoderplugin.h \
+    modbusrtu.h \
+    modbusplugin.h \
+    utf8decoder.h \
+    terminalemulator.h \
+    terminalview.h \
+    triggercapture.h \
+    triggercaptureplugin.h \
+    netproxybridge.h \
+    rfc2217.h \
+    ptymux.h \
+    ptymuxplugin.h \
+    timeline.h \
+    timelinewindow.h \
+    headlesscapture.h \
+    txencoder.h
 
 
 FORMS    += mainwindow.ui \
@@ -75,7 +131,14 @@ FORMS    += mainwindow.ui \
     netproxyplugin.ui \
     macrosettings.ui \
     netproxysettings.ui \
-    counterplugin.ui
+    counterplugin.ui \
+    sendexpectplugin.ui \
+    autoresponderplugin.ui \
+    framedecoderplugin.ui \
+    modbusplugin.ui \
+    triggercaptureplugin.ui \
+    ptymuxplugin.ui \
+    timelinewindow.ui
 
 RESOURCES += \
     resources.qrc
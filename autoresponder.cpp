@@ -0,0 +1,109 @@
+/*
+ * Copyright (c) 2026 CuteCom contributors
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 675 Mass Ave, Cambridge, MA 02139, USA.
+ *
+ * For more information on the GPL, please go to:
+ * http://www.gnu.org/copyleft/gpl.html
+ */
+
+#include "autoresponder.h"
+
+#include <QObject>
+#include <QStringList>
+
+QVector<AutoResponder::Rule> AutoResponder::parseRules(QTextStream &in, QString *error)
+{
+    QVector<Rule> rules;
+    int lineNumber = 0;
+    while (!in.atEnd()) {
+        QString line = in.readLine();
+        lineNumber++;
+        int comment = line.indexOf('#');
+        if (comment >= 0)
+            line = line.left(comment);
+        if (line.trimmed().isEmpty())
+            continue;
+
+        QStringList fields = line.split('|');
+        if (fields.size() != 2) {
+            if (error)
+                *error = QObject::tr("Line %1: expected 'pattern | response'").arg(lineNumber);
+            return QVector<Rule>();
+        }
+        Rule rule;
+        rule.pattern = PatternMatcher::fromEscaped(fields.at(0).trimmed());
+        rule.response = PatternMatcher::fromEscaped(fields.at(1).trimmed());
+        if (rule.pattern.isEmpty()) {
+            if (error)
+                *error = QObject::tr("Line %1: empty pattern").arg(lineNumber);
+            return QVector<Rule>();
+        }
+        rules.append(rule);
+    }
+    return rules;
+}
+
+/**
+ * @brief Escape a field of a rule so parseRules() reads it back as is:
+ *  '|' separates the fields, '#' starts a comment and the fields are
+ *  trimmed, so none of them may show up unescaped
+ */
+static QString escapeField(const QByteArray &bytes)
+{
+    QString text = PatternMatcher::toEscaped(bytes);
+    text.replace('|', QStringLiteral("\\x7c")).replace('#', QStringLiteral("\\x23"));
+    int leading = 0;
+    while (leading < text.size() && text.at(leading) == QLatin1Char(' '))
+        leading++;
+    if (leading == text.size())
+        return QStringLiteral("\\x20").repeated(leading);
+    int trailing = 0;
+    while (text.at(text.size() - 1 - trailing) == QLatin1Char(' '))
+        trailing++;
+    text.chop(trailing);
+    return QStringLiteral("\\x20").repeated(leading) + text.mid(leading)
+           + QStringLiteral("\\x20").repeated(trailing);
+}
+
+void AutoResponder::writeRules(QTextStream &out, const QVector<Rule> &rules)
+{
+    out << "# pattern | response\n";
+    foreach (const Rule &rule, rules)
+        out << escapeField(rule.pattern) << " | " << escapeField(rule.response) << "\n";
+}
+
+void AutoResponder::setRules(const QVector<Rule> &rules)
+{
+    m_rules = rules;
+    m_ruleOfPattern.clear();
+    m_matcher.clear();
+    for (int i = 0; i < m_rules.size(); i++) {
+        int id = m_matcher.addPattern(m_rules.at(i).pattern);
+        if (id == m_ruleOfPattern.size())
+            m_ruleOfPattern.append(i);
+    }
+    m_matcher.build();
+    clearStatistics();
+}
+
+void AutoResponder::clearStatistics()
+{
+    for (int i = 0; i < m_rules.size(); i++) {
+        m_rules[i].hits = 0;
+        m_rules[i].lastLatency = 0;
+        m_rules[i].totalLatency = 0;
+    }
+}
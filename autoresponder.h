@@ -0,0 +1,114 @@
+/*
+ * Copyright (c) 2026 CuteCom contributors
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 675 Mass Ave, Cambridge, MA 02139, USA.
+ *
+ * For more information on the GPL, please go to:
+ * http://www.gnu.org/copyleft/gpl.html
+ */
+
+/**
+ * Table of pattern -> response rules. All patterns are compiled into one
+ * PatternMatcher, so the received data is scanned exactly once no matter
+ * how many rules there are. The responses are handed to a writer callback
+ * immediately when a pattern has been completed.
+ */
+
+#ifndef AUTORESPONDER_H
+#define AUTORESPONDER_H
+
+#include "captureclock.h"
+#include "patternmatcher.h"
+
+#include <QTextStream>
+#include <QVector>
+
+class AutoResponder
+{
+public:
+    struct Rule {
+        Rule()
+            : hits(0)
+            , lastLatency(0)
+            , totalLatency(0)
+        {
+        }
+        QByteArray pattern;
+        QByteArray response;
+        quint64 hits;
+        /* reaction times in ns, from reading the request until the
+         * response has been written */
+        qint64 lastLatency;
+        qint64 totalLatency;
+    };
+
+    /**
+     * @brief Parse rules, one per line: pattern | response
+     *  Escapes are the ones of PatternMatcher::fromEscaped(), '#' starts a comment.
+     */
+    static QVector<Rule> parseRules(QTextStream &in, QString *error);
+    static void writeRules(QTextStream &out, const QVector<Rule> &rules);
+
+    /**
+     * @brief Replace the rules and recompile the automaton. This resets
+     *  the statistics.
+     */
+    void setRules(const QVector<Rule> &rules);
+    const QVector<Rule> &rules() const { return m_rules; }
+
+    void clearStatistics();
+
+    /**
+     * @brief Scan received data and answer every completed request
+     * @param data The received bytes
+     * @param len Number of bytes
+     * @param timestamp CaptureClock time the data has been read
+     * @param write Called as write(const QByteArray &response), the response
+     *  must have been written to the device when it returns, the latency is
+     *  taken afterwards
+     * @return Number of responses written
+     */
+    template <typename Writer> int processRx(const char *data, int len, qint64 timestamp, Writer write);
+
+private:
+    QVector<Rule> m_rules;
+    /**
+     * Maps the pattern ids of the matcher to rules. Several rules
+     * with the same pattern are answered by the first one.
+     * @brief m_ruleOfPattern
+     */
+    QVector<int> m_ruleOfPattern;
+    PatternMatcher m_matcher;
+};
+
+template <typename Writer> int AutoResponder::processRx(const char *data, int len, qint64 timestamp, Writer write)
+{
+    int responses = 0;
+    m_matcher.feed(data, len, [&](int id, int) {
+        Rule &rule = m_rules[m_ruleOfPattern.at(id)];
+        if (!rule.response.isEmpty())
+            write(rule.response);
+        // after write() returned, i.e. the response has left
+        const qint64 latency = CaptureClock::nsecsElapsed() - timestamp;
+        rule.hits++;
+        rule.lastLatency = latency;
+        rule.totalLatency += latency;
+        responses++;
+        return true;
+    });
+    return responses;
+}
+
+#endif // AUTORESPONDER_H
@@ -0,0 +1,243 @@
+/*
+ * Copyright (c) 2026 CuteCom contributors
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 675 Mass Ave, Cambridge, MA 02139, USA.
+ *
+ * For more information on the GPL, please go to:
+ * http://www.gnu.org/copyleft/gpl.html
+ */
+
+#include "autoresponderplugin.h"
+#include "ui_autoresponderplugin.h"
+#include <QFile>
+#include <QFileDialog>
+#include <QHeaderView>
+#include <QMessageBox>
+
+#include <algorithm>
+
+#define TRACE                                                                                                          \
+    if (!debug) {                                                                                                      \
+    } else                                                                                                             \
+        qDebug()
+
+static bool debug = false;
+
+AutoResponderPlugin::AutoResponderPlugin(QFrame *parent, Settings *settings)
+    : QFrame(parent)
+    , ui(new Ui::AutoResponderPlugin)
+    , m_settings(settings)
+    , m_statisticsChanged(false)
+{
+    ui->setupUi(this);
+    /* Has QFrame, no injection process cmd, answers received data right away */
+    m_plugin = new Plugin(this, "Auto responder", this);
+    m_plugin->processRx = &AutoResponderPlugin::processRx;
+
+    ui->m_table_rules->horizontalHeader()->setSectionResizeMode(QHeaderView::Stretch);
+    ui->m_table_rules->verticalHeader()->hide();
+
+    connect(ui->m_bt_unload, &QPushButton::clicked, this, &AutoResponderPlugin::removePlugin);
+    connect(ui->m_bt_help, &QPushButton::clicked, this, &AutoResponderPlugin::helpMsg);
+    connect(ui->m_bt_add, &QPushButton::clicked, this, &AutoResponderPlugin::addRule);
+    connect(ui->m_bt_remove, &QPushButton::clicked, this, &AutoResponderPlugin::removeRules);
+    connect(ui->m_bt_load, &QPushButton::clicked, this, &AutoResponderPlugin::loadRules);
+    connect(ui->m_bt_save, &QPushButton::clicked, this, &AutoResponderPlugin::saveRules);
+    connect(ui->m_bt_clear, &QPushButton::clicked, this, [=]() {
+        m_responder.clearStatistics();
+        m_statisticsChanged = true;
+        updateStatistics();
+    });
+    connect(ui->m_table_rules, &QTableWidget::itemChanged, this, &AutoResponderPlugin::rulesEdited);
+    connect(&m_statisticsTimer, &QTimer::timeout, this, &AutoResponderPlugin::updateStatistics);
+    m_statisticsTimer.start(250);
+
+    TRACE << "[AutoResponderPlugin::AutoResponderPlugin]";
+}
+
+AutoResponderPlugin::~AutoResponderPlugin() { delete ui; }
+
+/**
+ * @brief Called by the plugin manager with the data read from the device
+ *  before it is being displayed. Responses are written to the device
+ *  without a detour through the event loop.
+ */
+void AutoResponderPlugin::processRx(QObject *owner, const QByteArray &data, qint64 timestamp)
+{
+    AutoResponderPlugin *self = static_cast<AutoResponderPlugin *>(owner);
+    if (!self->ui->m_cb_active->isChecked())
+        return;
+
+    int responses = self->m_responder.processRx(data.constData(), data.size(), timestamp,
+                                                [self](const QByteArray &response) { emit self->writeData(response); });
+    if (responses)
+        self->m_statisticsChanged = true;
+}
+
+void AutoResponderPlugin::appendRow(const AutoResponder::Rule &rule)
+{
+    const int row = ui->m_table_rules->rowCount();
+    ui->m_table_rules->insertRow(row);
+    ui->m_table_rules->setItem(row, COL_PATTERN, new QTableWidgetItem(PatternMatcher::toEscaped(rule.pattern)));
+    ui->m_table_rules->setItem(row, COL_RESPONSE, new QTableWidgetItem(PatternMatcher::toEscaped(rule.response)));
+    for (int col = COL_HITS; col <= COL_AVG; col++) {
+        QTableWidgetItem *item = new QTableWidgetItem();
+        item->setFlags(item->flags() & ~Qt::ItemIsEditable);
+        ui->m_table_rules->setItem(row, col, item);
+    }
+}
+
+void AutoResponderPlugin::setRules(const QVector<AutoResponder::Rule> &rules)
+{
+    ui->m_table_rules->blockSignals(true);
+    ui->m_table_rules->setRowCount(0);
+    foreach (const AutoResponder::Rule &rule, rules) {
+        appendRow(rule);
+    }
+    ui->m_table_rules->blockSignals(false);
+    m_responder.setRules(rules);
+    m_statisticsChanged = true;
+    updateStatistics();
+}
+
+void AutoResponderPlugin::addRule()
+{
+    ui->m_table_rules->blockSignals(true);
+    appendRow(AutoResponder::Rule());
+    ui->m_table_rules->blockSignals(false);
+    ui->m_table_rules->editItem(ui->m_table_rules->item(ui->m_table_rules->rowCount() - 1, COL_PATTERN));
+}
+
+void AutoResponderPlugin::removeRules()
+{
+    QList<QTableWidgetSelectionRange> ranges = ui->m_table_rules->selectedRanges();
+    // remove from the bottom, so the row numbers stay valid
+    std::sort(ranges.begin(), ranges.end(), [](const QTableWidgetSelectionRange &a,
+                                               const QTableWidgetSelectionRange &b) { return a.topRow() > b.topRow(); });
+    ui->m_table_rules->blockSignals(true);
+    foreach (const QTableWidgetSelectionRange &range, ranges) {
+        for (int row = range.bottomRow(); row >= range.topRow(); row--)
+            ui->m_table_rules->removeRow(row);
+    }
+    ui->m_table_rules->blockSignals(false);
+    rulesEdited();
+}
+
+/**
+ * @brief The user changed a pattern or response: recompile all rules
+ */
+void AutoResponderPlugin::rulesEdited()
+{
+    QVector<AutoResponder::Rule> rules;
+    for (int row = 0; row < ui->m_table_rules->rowCount(); row++) {
+        AutoResponder::Rule rule;
+        rule.pattern = PatternMatcher::fromEscaped(ui->m_table_rules->item(row, COL_PATTERN)->text());
+        rule.response = PatternMatcher::fromEscaped(ui->m_table_rules->item(row, COL_RESPONSE)->text());
+        rules.append(rule);
+    }
+    m_responder.setRules(rules);
+    m_statisticsChanged = true;
+    updateStatistics();
+}
+
+void AutoResponderPlugin::updateStatistics()
+{
+    if (!m_statisticsChanged)
+        return;
+    m_statisticsChanged = false;
+
+    const QVector<AutoResponder::Rule> &rules = m_responder.rules();
+    ui->m_table_rules->blockSignals(true);
+    for (int row = 0; row < rules.size() && row < ui->m_table_rules->rowCount(); row++) {
+        const AutoResponder::Rule &rule = rules.at(row);
+        ui->m_table_rules->item(row, COL_HITS)->setText(QString::number(rule.hits));
+        if (rule.hits) {
+            ui->m_table_rules->item(row, COL_LAST)->setText(QString::number(rule.lastLatency / 1000.0, 'f', 1));
+            ui->m_table_rules->item(row, COL_AVG)
+                ->setText(QString::number(rule.totalLatency / 1000.0 / rule.hits, 'f', 1));
+        } else {
+            ui->m_table_rules->item(row, COL_LAST)->setText(QString());
+            ui->m_table_rules->item(row, COL_AVG)->setText(QString());
+        }
+    }
+    ui->m_table_rules->blockSignals(false);
+}
+
+void AutoResponderPlugin::loadRules()
+{
+    QString filename = QFileDialog::getOpenFileName(this, tr("Open responder rules"), m_settings->getSendStartDir());
+    if (filename.isEmpty())
+        return;
+
+    QFile file(filename);
+    if (!file.open(QIODevice::ReadOnly | QIODevice::Text)) {
+        QMessageBox::warning(this, tr("Opening file failed"), tr("Could not open file %1").arg(filename));
+        return;
+    }
+    QTextStream in(&file);
+    QString error;
+    QVector<AutoResponder::Rule> rules = AutoResponder::parseRules(in, &error);
+    if (!error.isEmpty()) {
+        QMessageBox::warning(this, tr("Invalid rules"), error);
+        return;
+    }
+    setRules(rules);
+}
+
+void AutoResponderPlugin::saveRules()
+{
+    QString filename = QFileDialog::getSaveFileName(this, tr("Save responder rules"), m_settings->getSendStartDir());
+    if (filename.isEmpty())
+        return;
+
+    QFile file(filename);
+    if (!file.open(QIODevice::WriteOnly | QIODevice::Text | QIODevice::Truncate)) {
+        QMessageBox::warning(this, tr("Opening file failed"), tr("Could not open file %1").arg(filename));
+        return;
+    }
+    QTextStream out(&file);
+    AutoResponder::writeRules(out, m_responder.rules());
+}
+
+/**
+ * @brief Return a pointer to the plugin data
+ * @return
+ */
+const Plugin *AutoResponderPlugin::plugin() { return m_plugin; }
+
+/**
+ * @brief [SLOT] Send unload command to the plugin manager
+ */
+void AutoResponderPlugin::removePlugin(bool) { emit unload(m_plugin); }
+
+/**
+ * @brief Help message for the auto responder plugin
+ */
+void AutoResponderPlugin::helpMsg(void)
+{
+    QString help_str = tr("This plugin answers requests of the device, e.g. to\n"
+                          "emulate the counterpart of the device.\n\n"
+                          "Whenever a pattern has been received, the response is\n"
+                          "written to the device right away without waiting for\n"
+                          "the display or the event loop.\n"
+                          "Supported escapes are \\r \\n \\t \\0 \\\\ and \\xNN.\n\n"
+                          "For each rule the number of hits and the reaction time\n"
+                          "from reading the request until writing the response\n"
+                          "are shown.\n\n"
+                          "Rules files contain one rule per line:\n"
+                          "    AT+X? | OK\\r\\n\n");
+
+    QMessageBox::information(this, tr("How to use the auto responder"), help_str);
+}
@@ -0,0 +1,82 @@
+/*
+ * Copyright (c) 2026 CuteCom contributors
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 675 Mass Ave, Cambridge, MA 02139, USA.
+ *
+ * For more information on the GPL, please go to:
+ * http://www.gnu.org/copyleft/gpl.html
+ */
+
+#ifndef AUTORESPONDERPLUGIN_H
+#define AUTORESPONDERPLUGIN_H
+
+#include "autoresponder.h"
+#include "plugin.h"
+#include "settings.h"
+#include <QDebug>
+#include <QFrame>
+#include <QTimer>
+
+namespace Ui
+{
+class AutoResponderPlugin;
+}
+
+class AutoResponderPlugin : public QFrame
+{
+    Q_OBJECT
+
+public:
+    explicit AutoResponderPlugin(QFrame *parent, Settings *settings);
+    ~AutoResponderPlugin();
+    const Plugin *plugin();
+
+signals:
+    void writeData(QByteArray);
+    void unload(Plugin *);
+
+public slots:
+    void removePlugin(bool);
+    void helpMsg(void);
+
+private slots:
+    void addRule();
+    void removeRules();
+    void loadRules();
+    void saveRules();
+    void rulesEdited();
+    void updateStatistics();
+
+private:
+    enum Columns { COL_PATTERN, COL_RESPONSE, COL_HITS, COL_LAST, COL_AVG };
+
+    static void processRx(QObject *owner, const QByteArray &data, qint64 timestamp);
+    void setRules(const QVector<AutoResponder::Rule> &rules);
+    void appendRow(const AutoResponder::Rule &rule);
+
+    Ui::AutoResponderPlugin *ui;
+    Plugin *m_plugin;
+    Settings *m_settings;
+    AutoResponder m_responder;
+    /**
+     * The counters are updated by the responder on every hit,
+     * the table is refreshed by this timer only
+     * @brief m_statisticsTimer
+     */
+    QTimer m_statisticsTimer;
+    bool m_statisticsChanged;
+};
+
+#endif // AUTORESPONDERPLUGIN_H
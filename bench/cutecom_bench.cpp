@@ -0,0 +1,337 @@
+/*
+ * Copyright (c) 2026 CuteCom contributors
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 675 Mass Ave, Cambridge, MA 02139, USA.
+ *
+ * For more information on the GPL, please go to:
+ * http://www.gnu.org/copyleft/gpl.html
+ */
+
+/**
+ * Hot paths of the display and of sending: DataDisplay::displayData() with
+ * the line and hex formatting behind it, DataHighlighter::highlightBlock()
+ * and the encoding of the input line by TxEncoder. The data are generated
+ * corpora (printable text, binary, NUL runs, long and short lines) fed in
+ * chunks of 1 B up to 64 KB. Each row prints MB/s and the allocations per
+ * MB of input, e.g.
+ *
+ *     ./bench/cutecom_bench --json before.json
+ *     ./bench/cutecom_bench --json after.json displayData
+ *
+ * The JSON file holds one entry per row, so the results of two commits can
+ * be compared row by row. The display runs on the offscreen platform unless
+ * QT_QPA_PLATFORM says otherwise.
+ */
+
+#include "datadisplay.h"
+#include "datahighlighter.h"
+#include "txencoder.h"
+#include "version.h"
+#include <QApplication>
+#include <QAtomicInteger>
+#include <QDateTime>
+#include <QElapsedTimer>
+#include <QFile>
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QTextDocument>
+#include <QtTest>
+
+#include <cstdlib>
+#include <new>
+
+/* every allocation of the process, the difference is taken around the measured code */
+static QAtomicInteger<quint64> s_allocations;
+
+void *operator new(std::size_t size)
+{
+    s_allocations.fetchAndAddRelaxed(1);
+    void *p = std::malloc(size ? size : 1);
+    if (!p)
+        throw std::bad_alloc();
+    return p;
+}
+
+void operator delete(void *p) noexcept { std::free(p); }
+
+void operator delete(void *p, std::size_t) noexcept { std::free(p); }
+
+class CuteComBench : public QObject
+{
+    Q_OBJECT
+
+public:
+    explicit CuteComBench(const QString &jsonFile)
+        : m_jsonFile(jsonFile)
+    {
+    }
+
+private slots:
+    void initTestCase();
+    void cleanupTestCase();
+    void displayData_data();
+    void displayData();
+    void highlightBlock_data();
+    void highlightBlock();
+    void encode_data();
+    void encode();
+
+private:
+    enum { CORPUS_SIZE = 256 * 1024 };
+
+    static QByteArray corpus(const QString &name);
+    void report(qint64 bytes, qint64 nsecs, quint64 allocations);
+
+    QString m_jsonFile;
+    QJsonArray m_results;
+};
+
+/**
+ * @brief CORPUS_SIZE bytes of one kind of data, the same for every run
+ */
+QByteArray CuteComBench::corpus(const QString &name)
+{
+    qsrand(1);
+    QByteArray data;
+    data.reserve(CORPUS_SIZE);
+    while (data.size() < CORPUS_SIZE) {
+        if (name == QLatin1String("text")) {
+            // log lines of varying length
+            const int length = 20 + qrand() % 100;
+            for (int i = 0; i < length; i++)
+                data.append(char(' ' + qrand() % 95));
+            data.append("\r\n", 2);
+        } else if (name == QLatin1String("binary")) {
+            data.append(char(qrand()));
+        } else if (name == QLatin1String("nul")) {
+            // runs of NUL bytes, e.g. an idle line or padding
+            data.append(QByteArray(64 + qrand() % 512, '\0'));
+            data.append(char(qrand()));
+        } else if (name == QLatin1String("long")) {
+            for (int i = 0; i < 16 * 1024; i++)
+                data.append(char('a' + qrand() % 26));
+            data.append('\n');
+        } else if (name == QLatin1String("short")) {
+            data.append(char('0' + qrand() % 10));
+            data.append('\n');
+        }
+    }
+    data.resize(CORPUS_SIZE);
+    return data;
+}
+
+void CuteComBench::report(qint64 bytes, qint64 nsecs, quint64 allocations)
+{
+    const double megabytes = bytes / (1024.0 * 1024.0);
+    const double mbPerSecond = megabytes * 1e9 / qMax<qint64>(1, nsecs);
+    const double allocationsPerMB = megabytes > 0 ? allocations / megabytes : 0;
+    qDebug("%.2f MB/s, %.0f allocations/MB", mbPerSecond, allocationsPerMB);
+
+    QJsonObject result;
+    result.insert(QStringLiteral("test"), QString::fromLatin1(QTest::currentTestFunction()));
+    result.insert(QStringLiteral("row"), QString::fromLatin1(QTest::currentDataTag()));
+    result.insert(QStringLiteral("bytes"), double(bytes));
+    result.insert(QStringLiteral("mbPerSecond"), mbPerSecond);
+    result.insert(QStringLiteral("allocationsPerMB"), allocationsPerMB);
+    m_results.append(result);
+}
+
+void CuteComBench::initTestCase() { m_results = QJsonArray(); }
+
+void CuteComBench::cleanupTestCase()
+{
+    if (m_jsonFile.isEmpty())
+        return;
+    QJsonObject root;
+    root.insert(QStringLiteral("benchmark"), QStringLiteral("cutecom_bench"));
+    root.insert(QStringLiteral("version"), QStringLiteral("%1").arg(CuteCom_VERSION));
+    root.insert(QStringLiteral("qt"), QString::fromLatin1(qVersion()));
+    root.insert(QStringLiteral("date"), QDateTime::currentDateTimeUtc().toString(Qt::ISODate));
+    root.insert(QStringLiteral("results"), m_results);
+
+    QFile file(m_jsonFile);
+    QVERIFY2(file.open(QIODevice::WriteOnly | QIODevice::Truncate), qPrintable(file.errorString()));
+    file.write(QJsonDocument(root).toJson());
+}
+
+void CuteComBench::displayData_data()
+{
+    QTest::addColumn<QString>("corpus");
+    QTest::addColumn<int>("chunk");
+    QTest::addColumn<bool>("hex");
+
+    const char *corpora[] = {"text", "binary", "nul", "long", "short"};
+    const int chunks[] = {1, 16, 256, 4096, 65536};
+    for (const char *name : corpora) {
+        for (int chunk : chunks) {
+            QTest::newRow(qPrintable(QString("%1/%2").arg(name).arg(chunk))) << QString(name) << chunk << false;
+            QTest::newRow(qPrintable(QString("%1/%2/hex").arg(name).arg(chunk))) << QString(name) << chunk << true;
+        }
+    }
+}
+
+/**
+ * @brief Formatting of the chunks and inserting the rows into the
+ *  document, as done by the timer of the display
+ */
+void CuteComBench::displayData()
+{
+    QFETCH(QString, corpus);
+    QFETCH(int, chunk);
+    QFETCH(bool, hex);
+
+    const QByteArray data = CuteComBench::corpus(corpus);
+    // the chunks are prepared up front, like the buffers read from the device
+    QList<QByteArray> chunks;
+    for (int pos = 0; pos < data.size(); pos += chunk)
+        chunks.append(data.mid(pos, chunk));
+
+    DataDisplay display;
+    display.resize(800, 600);
+    display.setDisplayHex(hex);
+    display.setDisplayCtrlCharacters(true);
+
+    qint64 bytes = 0;
+    qint64 nsecs = 0;
+    quint64 allocations = 0;
+    QBENCHMARK
+    {
+        display.clear();
+        QElapsedTimer timer;
+        const quint64 before = s_allocations.load();
+        timer.start();
+        qint64 timestamp = 0;
+        foreach (const QByteArray &c, chunks) {
+            display.displayData(c, timestamp);
+            timestamp += 1000;
+        }
+        QMetaObject::invokeMethod(&display, "displayDataFromBuffer", Qt::DirectConnection);
+        nsecs += timer.nsecsElapsed();
+        allocations += s_allocations.load() - before;
+        bytes += data.size();
+    }
+    report(bytes, nsecs, allocations);
+}
+
+void CuteComBench::highlightBlock_data()
+{
+    QTest::addColumn<QString>("corpus");
+    QTest::addColumn<QString>("search");
+
+    QTest::newRow("text") << QString("text") << QString();
+    QTest::newRow("text/search") << QString("text") << QString("abc");
+    QTest::newRow("short") << QString("short") << QString();
+    QTest::newRow("long") << QString("long") << QString();
+}
+
+/**
+ * @brief Highlighting of every block of a document holding the corpus
+ */
+void CuteComBench::highlightBlock()
+{
+    QFETCH(QString, corpus);
+    QFETCH(QString, search);
+
+    const QByteArray data = CuteComBench::corpus(corpus);
+    QTextDocument document;
+    document.setPlainText(QString::fromLatin1(data));
+    DataHighlighter highlighter(&document);
+    highlighter.setSearchString(search);
+
+    qint64 nsecs = 0;
+    qint64 bytes = 0;
+    quint64 allocations = 0;
+    QBENCHMARK
+    {
+        QElapsedTimer timer;
+        const quint64 before = s_allocations.load();
+        timer.start();
+        highlighter.rehighlight();
+        nsecs += timer.nsecsElapsed();
+        allocations += s_allocations.load() - before;
+        bytes += data.size();
+    }
+    report(bytes, nsecs, allocations);
+}
+
+void CuteComBench::encode_data()
+{
+    QTest::addColumn<QString>("input");
+    QTest::addColumn<int>("lineMode");
+
+    QString shortHex;
+    QString longHex;
+    for (int i = 0; i < 8; i++)
+        shortHex += QString("%1 ").arg(i * 37 % 256, 2, 16, QLatin1Char('0'));
+    for (int i = 0; i < 1024; i++)
+        longHex += QString("%1 ").arg(i * 37 % 256, 2, 16, QLatin1Char('0'));
+    QTest::newRow("hex/short") << shortHex << int(Settings::HEX);
+    QTest::newRow("hex/long") << longHex << int(Settings::HEX);
+    QTest::newRow("hex/quoted") << QString("0x02 \"AT+CGMI?\" 0d 0a \"AT+CGSN\" 03") << int(Settings::HEX);
+    QTest::newRow("text/crlf") << QString("AT+CGMI?;+CGSN;+CSQ").repeated(8) << int(Settings::CRLF);
+}
+
+/**
+ * @brief Turning the input line into the bytes sent
+ */
+void CuteComBench::encode()
+{
+    QFETCH(QString, input);
+    QFETCH(int, lineMode);
+
+    QByteArray bytes;
+    QString error;
+    QVERIFY(TxEncoder::encode(input, static_cast<Settings::LineTerminator>(lineMode), &bytes, &error));
+
+    qint64 nsecs = 0;
+    qint64 total = 0;
+    quint64 allocations = 0;
+    QBENCHMARK
+    {
+        QElapsedTimer timer;
+        const quint64 before = s_allocations.load();
+        timer.start();
+        for (int i = 0; i < 1000; i++) {
+            TxEncoder::encode(input, static_cast<Settings::LineTerminator>(lineMode), &bytes, &error);
+            total += bytes.size();
+        }
+        nsecs += timer.nsecsElapsed();
+        allocations += s_allocations.load() - before;
+    }
+    report(total, nsecs, allocations);
+}
+
+int main(int argc, char *argv[])
+{
+    // no display is needed to render into the documents
+    if (qEnvironmentVariableIsEmpty("QT_QPA_PLATFORM"))
+        qputenv("QT_QPA_PLATFORM", "offscreen");
+    QApplication app(argc, argv);
+
+    // --json <file> is ours, everything else goes to QTest
+    QStringList arguments = app.arguments();
+    QString jsonFile;
+    const int json = arguments.indexOf(QStringLiteral("--json"));
+    if (json > 0 && json + 1 < arguments.size()) {
+        jsonFile = arguments.at(json + 1);
+        arguments.erase(arguments.begin() + json, arguments.begin() + json + 2);
+    }
+
+    CuteComBench bench(jsonFile);
+    return QTest::qExec(&bench, arguments);
+}
+
+#include "cutecom_bench.moc"
@@ -0,0 +1,196 @@
+/*
+ * Copyright (c) 2026 CuteCom contributors
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 675 Mass Ave, Cambridge, MA 02139, USA.
+ *
+ * For more information on the GPL, please go to:
+ * http://www.gnu.org/copyleft/gpl.html
+ */
+
+/**
+ * Throughput of the FrameDecoder. 3 Mbaud are about 300 kB/s, the decoder
+ * has to stay well above that on one core. Each benchmark decodes 4 MB of
+ * random frames fed in chunks of typical read sizes and prints the rate.
+ */
+
+#include "framedecoder.h"
+#include <QElapsedTimer>
+#include <QtTest>
+
+class FrameDecoderBench : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void initTestCase();
+    void decode_data();
+    void decode();
+
+private:
+    static QByteArray slipEncode(const QByteArray &frame);
+    static QByteArray cobsEncode(const QByteArray &frame);
+    static QByteArray lengthEncode(const QByteArray &frame);
+
+    QList<QByteArray> m_frames;
+};
+
+QByteArray FrameDecoderBench::slipEncode(const QByteArray &frame)
+{
+    QByteArray out;
+    foreach (char c, frame) {
+        if (c == '\xc0')
+            out.append("\xdb\xdc", 2);
+        else if (c == '\xdb')
+            out.append("\xdb\xdd", 2);
+        else
+            out.append(c);
+    }
+    out.append('\xc0');
+    return out;
+}
+
+QByteArray FrameDecoderBench::cobsEncode(const QByteArray &frame)
+{
+    // the code byte of a block is filled in when the block ends
+    QByteArray out(1, '\0');
+    int code = 0;
+    int codePos = 0;
+    for (int i = 0; i < frame.size(); i++) {
+        if (frame.at(i) == 0) {
+            out[codePos] = char(code + 1);
+            codePos = out.size();
+            out.append('\0');
+            code = 0;
+            continue;
+        }
+        out.append(frame.at(i));
+        // a full block without implicit zero, a new one only if more input follows
+        if (++code == 254 && i + 1 < frame.size()) {
+            out[codePos] = '\xff';
+            codePos = out.size();
+            out.append('\0');
+            code = 0;
+        }
+    }
+    out[codePos] = char(code + 1);
+    out.append('\0');
+    return out;
+}
+
+QByteArray FrameDecoderBench::lengthEncode(const QByteArray &frame)
+{
+    QByteArray out;
+    out.append(char(frame.size() >> 8));
+    out.append(char(frame.size() & 0xff));
+    out.append(frame);
+    return out;
+}
+
+void FrameDecoderBench::initTestCase()
+{
+    qsrand(1);
+    int total = 0;
+    while (total < 4 * 1024 * 1024) {
+        QByteArray frame(8 + qrand() % 248, 0);
+        for (int i = 0; i < frame.size(); i++)
+            frame[i] = static_cast<char>(qrand());
+        m_frames.append(frame);
+        total += frame.size();
+    }
+}
+
+void FrameDecoderBench::decode_data()
+{
+    QTest::addColumn<int>("mode");
+    QTest::addColumn<int>("chunk");
+
+    const int chunks[] = {32, 512, 4096};
+    for (int chunk : chunks) {
+        QTest::newRow(qPrintable(QString("slip/%1").arg(chunk))) << int(FrameDecoder::SLIP) << chunk;
+        QTest::newRow(qPrintable(QString("cobs/%1").arg(chunk))) << int(FrameDecoder::COBS) << chunk;
+        QTest::newRow(qPrintable(QString("length/%1").arg(chunk))) << int(FrameDecoder::LENGTH_PREFIX) << chunk;
+        QTest::newRow(qPrintable(QString("delimiter/%1").arg(chunk))) << int(FrameDecoder::DELIMITER) << chunk;
+    }
+}
+
+void FrameDecoderBench::decode()
+{
+    QFETCH(int, mode);
+    QFETCH(int, chunk);
+
+    QByteArray stream;
+    foreach (const QByteArray &frame, m_frames) {
+        switch (mode) {
+        case FrameDecoder::SLIP:
+            stream.append(slipEncode(frame));
+            break;
+        case FrameDecoder::COBS:
+            stream.append(cobsEncode(frame));
+            break;
+        case FrameDecoder::LENGTH_PREFIX:
+            stream.append(lengthEncode(frame));
+            break;
+        case FrameDecoder::DELIMITER:
+            // random data, the frames are whatever lies between the delimiters
+            stream.append(frame);
+            stream.append("\r\n", 2);
+            break;
+        }
+    }
+
+    FrameDecoder decoder;
+    decoder.setMode(static_cast<FrameDecoder::Mode>(mode));
+    FrameDecoder::LengthRule rule;
+    rule.size = 2;
+    decoder.setLengthRule(rule);
+    decoder.setDelimiter("\r\n");
+
+    // the encoded corpus must decode to the frames again
+    if (mode != FrameDecoder::DELIMITER) {
+        QList<QByteArray> decoded;
+        decoder.feed(stream.constData(), stream.size(), [&](const QByteArray &frame) { decoded.append(frame); });
+        QCOMPARE(decoder.errors(), quint64(0));
+        QCOMPARE(decoded.size(), m_frames.size());
+        // the header of length prefixed frames is part of the frame
+        for (int i = 0; i < decoded.size(); i++) {
+            const QByteArray &frame = m_frames.at(i);
+            QCOMPARE(decoded.at(i), mode == FrameDecoder::LENGTH_PREFIX ? lengthEncode(frame) : frame);
+        }
+    }
+
+    qint64 bytes = 0;
+    qint64 nsecs = 0;
+    int runs = 0;
+    QBENCHMARK
+    {
+        QElapsedTimer timer;
+        timer.start();
+        decoder.reset();
+        for (int pos = 0; pos < stream.size(); pos += chunk) {
+            decoder.feed(stream.constData() + pos, qMin(chunk, stream.size() - pos),
+                         [&](const QByteArray &frame) { bytes += frame.size(); });
+        }
+        nsecs += timer.nsecsElapsed();
+        runs++;
+    }
+    QVERIFY(bytes > 0);
+    if (mode != FrameDecoder::DELIMITER)
+        QCOMPARE(decoder.errors(), quint64(0));
+    qDebug("%.1f MB/s", 1000.0 * stream.size() * runs / qMax<qint64>(1, nsecs));
+}
+
+QTEST_APPLESS_MAIN(FrameDecoderBench)
+
+#include "framedecoder_bench.moc"
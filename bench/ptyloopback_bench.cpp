@@ -0,0 +1,375 @@
+/*
+ * Copyright (c) 2026 CuteCom contributors
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 675 Mass Ave, Cambridge, MA 02139, USA.
+ *
+ * For more information on the GPL, please go to:
+ * http://www.gnu.org/copyleft/gpl.html
+ */
+
+/**
+ * End to end throughput and latency through a pseudo terminal: the
+ * benchmark writes a known byte stream into the master side while the
+ * capture reads the slave side like a serial port. Every row runs for a
+ * few seconds at a fixed write rate (0 writes as fast as the PTY takes
+ * it) and prints the received MB/s, lost and corrupted bytes and the
+ * latency from writing a block until it has been captured, e.g.
+ *
+ *     ./bench/ptyloopback_bench --json before.json
+ *     ./bench/ptyloopback_bench --json after.json loopback:display/text/0
+ *
+ * In "headless" rows the data only go through HeadlessCapture, the log
+ * file and the throughput meter. "display" rows feed the data to a
+ * DataDisplay as well and also report the latency until the document has
+ * been updated and the intervals of a 16 ms timer, which grow whenever
+ * the display blocks the event loop.
+ */
+
+#include "captureclock.h"
+#include "datadisplay.h"
+#include "headlesscapture.h"
+#include "version.h"
+#include <QApplication>
+#include <QDateTime>
+#include <QElapsedTimer>
+#include <QEventLoop>
+#include <QFile>
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QPlainTextEdit>
+#include <QTemporaryDir>
+#include <QTimer>
+#include <QtTest>
+
+#include <algorithm>
+
+#include <errno.h>
+#include <string.h>
+
+#ifdef Q_OS_UNIX
+#include <fcntl.h>
+#include <termios.h>
+#include <unistd.h>
+#if defined(Q_OS_LINUX)
+#include <pty.h>
+#elif defined(Q_OS_FREEBSD)
+#include <libutil.h>
+#else
+#include <util.h>
+#endif
+#endif
+
+class PtyLoopbackBench : public QObject
+{
+    Q_OBJECT
+
+public:
+    explicit PtyLoopbackBench(const QString &jsonFile)
+        : m_jsonFile(jsonFile)
+    {
+    }
+
+private slots:
+    void initTestCase();
+    void cleanupTestCase();
+    void loopback_data();
+    void loopback();
+
+private:
+    enum {
+        CORPUS_SIZE = 64 * 1024,
+        RUN_MS = 2000,
+        DRAIN_MS = 5000,
+        WRITE_INTERVAL_MS = 1,
+        FRAME_INTERVAL_MS = 16,
+        MAX_WRITE = 64 * 1024
+    };
+
+    /* end of a block in the stream and when it has been written */
+    struct Write {
+        qint64 end;
+        qint64 time;
+    };
+
+    static QByteArray corpus(const QString &name);
+    static double percentile(QVector<qint64> values, double p);
+
+    QString m_jsonFile;
+    QJsonArray m_results;
+};
+
+/**
+ * @brief CORPUS_SIZE bytes, written over and over again
+ */
+QByteArray PtyLoopbackBench::corpus(const QString &name)
+{
+    qsrand(1);
+    QByteArray data;
+    data.reserve(CORPUS_SIZE);
+    while (data.size() < CORPUS_SIZE) {
+        if (name == QLatin1String("text")) {
+            const int length = 20 + qrand() % 100;
+            for (int i = 0; i < length; i++)
+                data.append(char(' ' + qrand() % 95));
+            data.append("\r\n", 2);
+        } else {
+            data.append(char(qrand()));
+        }
+    }
+    data.resize(CORPUS_SIZE);
+    return data;
+}
+
+/**
+ * @brief The value below which \a p percent of \a values are
+ */
+double PtyLoopbackBench::percentile(QVector<qint64> values, double p)
+{
+    if (values.isEmpty())
+        return 0;
+    std::sort(values.begin(), values.end());
+    const int index = qBound(0, int(values.size() * p / 100.0), values.size() - 1);
+    return values.at(index);
+}
+
+void PtyLoopbackBench::initTestCase() { m_results = QJsonArray(); }
+
+void PtyLoopbackBench::cleanupTestCase()
+{
+    if (m_jsonFile.isEmpty())
+        return;
+    QJsonObject root;
+    root.insert(QStringLiteral("benchmark"), QStringLiteral("ptyloopback_bench"));
+    root.insert(QStringLiteral("version"), QStringLiteral("%1").arg(CuteCom_VERSION));
+    root.insert(QStringLiteral("qt"), QString::fromLatin1(qVersion()));
+    root.insert(QStringLiteral("date"), QDateTime::currentDateTimeUtc().toString(Qt::ISODate));
+    root.insert(QStringLiteral("results"), m_results);
+
+    QFile file(m_jsonFile);
+    QVERIFY2(file.open(QIODevice::WriteOnly | QIODevice::Truncate), qPrintable(file.errorString()));
+    file.write(QJsonDocument(root).toJson());
+}
+
+void PtyLoopbackBench::loopback_data()
+{
+    QTest::addColumn<QString>("mode");
+    QTest::addColumn<QString>("pattern");
+    QTest::addColumn<int>("rate");
+
+    // 115200 baud, 1 MB/s and as fast as possible
+    const QList<int> rates = QList<int>() << 11520 << 1024 * 1024 << 0;
+    foreach (const QString &mode, QStringList() << "headless"
+                                                << "display") {
+        foreach (const QString &pattern, QStringList() << "text"
+                                                       << "binary") {
+            foreach (int rate, rates) {
+                QTest::newRow(qPrintable(QString("%1/%2/%3").arg(mode).arg(pattern).arg(rate)))
+                    << mode << pattern << rate;
+            }
+        }
+    }
+}
+
+void PtyLoopbackBench::loopback()
+{
+#ifdef Q_OS_UNIX
+    QFETCH(QString, mode);
+    QFETCH(QString, pattern);
+    QFETCH(int, rate);
+
+    int master;
+    int slave;
+    QVERIFY2(::openpty(&master, &slave, NULL, NULL, NULL) == 0, strerror(errno));
+    // the bytes must go through as they are
+    struct termios tio;
+    if (::tcgetattr(slave, &tio) == 0) {
+        ::cfmakeraw(&tio);
+        ::tcsetattr(slave, TCSANOW, &tio);
+    }
+    ::fcntl(master, F_SETFL, ::fcntl(master, F_GETFL) | O_NONBLOCK);
+    char name[128];
+    QVERIFY(::ttyname_r(slave, name, sizeof(name)) == 0);
+
+    QTemporaryDir dir;
+    QVERIFY(dir.isValid());
+    HeadlessCapture::Options options;
+    options.device = QString::fromLocal8Bit(name);
+    options.logFile = dir.filePath(QStringLiteral("loopback.log"));
+
+    const QByteArray data = corpus(pattern);
+    qint64 written = 0;
+    qint64 received = 0;
+    qint64 corrupted = 0;
+    QVector<Write> writes;
+    int firstPending = 0;
+    QVector<qint64> latencies;
+    QVector<qint64> displayPending;
+    QVector<qint64> displayLatencies;
+    QVector<qint64> frames;
+
+    {
+        HeadlessCapture capture;
+        QVERIFY(capture.start(options));
+
+        DataDisplay *display = 0;
+        if (mode == QLatin1String("display")) {
+            display = new DataDisplay;
+            display->resize(800, 600);
+            display->setDisplayCtrlCharacters(true);
+            display->show();
+            // every change of the document has all data captured until then
+            QPlainTextEdit *edit = display->findChild<QPlainTextEdit *>();
+            QVERIFY(edit);
+            connect(edit->document(), &QTextDocument::contentsChanged, this, [&]() {
+                const qint64 now = CaptureClock::nsecsElapsed();
+                foreach (qint64 time, displayPending)
+                    displayLatencies.append(now - time);
+                displayPending.clear();
+            });
+        }
+
+        connect(&capture, &HeadlessCapture::captured, this, [&](const QByteArray &chunk, qint64 timestamp) {
+            for (int i = 0; i < chunk.size(); i++) {
+                if (chunk.at(i) != data.at((received + i) % CORPUS_SIZE))
+                    corrupted++;
+            }
+            received += chunk.size();
+            while (firstPending < writes.size() && writes.at(firstPending).end <= received) {
+                latencies.append(timestamp - writes.at(firstPending).time);
+                if (display)
+                    displayPending.append(writes.at(firstPending).time);
+                firstPending++;
+            }
+            if (display)
+                display->displayData(chunk, timestamp);
+        });
+
+        QElapsedTimer elapsed;
+        QTimer writeTimer;
+        writeTimer.setTimerType(Qt::PreciseTimer);
+        connect(&writeTimer, &QTimer::timeout, this, [&]() {
+            if (elapsed.elapsed() >= RUN_MS) {
+                writeTimer.stop();
+                return;
+            }
+            qint64 budget = MAX_WRITE;
+            if (rate > 0)
+                budget = qMin<qint64>(budget, rate * elapsed.nsecsElapsed() / 1000000000 - written);
+            while (budget > 0) {
+                const int offset = written % CORPUS_SIZE;
+                const int length = int(qMin<qint64>(budget, CORPUS_SIZE - offset));
+                const ssize_t n = ::write(master, data.constData() + offset, length);
+                if (n <= 0)
+                    break; // the PTY is full, the rest goes with the next tick
+                written += n;
+                budget -= n;
+                writes.append(Write{written, CaptureClock::nsecsElapsed()});
+            }
+        });
+
+        QTimer frameTimer;
+        frameTimer.setTimerType(Qt::PreciseTimer);
+        qint64 lastFrame = CaptureClock::nsecsElapsed();
+        connect(&frameTimer, &QTimer::timeout, this, [&]() {
+            const qint64 now = CaptureClock::nsecsElapsed();
+            frames.append(now - lastFrame);
+            lastFrame = now;
+        });
+
+        // run until everything written has been captured or the drain time is over
+        QEventLoop loop;
+        QTimer doneTimer;
+        connect(&doneTimer, &QTimer::timeout, &loop, [&]() {
+            const bool drained = !writeTimer.isActive() && received >= written
+                                 && (!display || displayPending.isEmpty());
+            if (drained || elapsed.elapsed() >= RUN_MS + DRAIN_MS)
+                loop.quit();
+        });
+        elapsed.start();
+        writeTimer.start(WRITE_INTERVAL_MS);
+        frameTimer.start(FRAME_INTERVAL_MS);
+        doneTimer.start(10);
+        loop.exec();
+
+        const qint64 nsecs = elapsed.nsecsElapsed();
+        delete display;
+        display = 0;
+        ::close(master);
+        ::close(slave);
+
+        const qint64 lost = written - received;
+        const double mbPerSecond = received / (1024.0 * 1024.0) * 1e9 / qMax<qint64>(1, nsecs);
+        qDebug("%.2f MB/s, %lld of %lld bytes lost, %lld corrupted", mbPerSecond, lost, written, corrupted);
+        qDebug("latency p50 %.0f us, p99 %.0f us, max %.0f us", percentile(latencies, 50) / 1000,
+               percentile(latencies, 99) / 1000, percentile(latencies, 100) / 1000);
+        if (mode == QLatin1String("display")) {
+            qDebug("display latency p50 %.0f us, p99 %.0f us, max %.0f us", percentile(displayLatencies, 50) / 1000,
+                   percentile(displayLatencies, 99) / 1000, percentile(displayLatencies, 100) / 1000);
+            qDebug("frame interval p50 %.1f ms, p99 %.1f ms, max %.1f ms", percentile(frames, 50) / 1e6,
+                   percentile(frames, 99) / 1e6, percentile(frames, 100) / 1e6);
+        }
+
+        QJsonObject result;
+        result.insert(QStringLiteral("row"), QString::fromLatin1(QTest::currentDataTag()));
+        result.insert(QStringLiteral("written"), double(written));
+        result.insert(QStringLiteral("received"), double(received));
+        result.insert(QStringLiteral("lost"), double(lost));
+        result.insert(QStringLiteral("corrupted"), double(corrupted));
+        result.insert(QStringLiteral("mbPerSecond"), mbPerSecond);
+        result.insert(QStringLiteral("latencyP50Us"), percentile(latencies, 50) / 1000);
+        result.insert(QStringLiteral("latencyP99Us"), percentile(latencies, 99) / 1000);
+        result.insert(QStringLiteral("latencyMaxUs"), percentile(latencies, 100) / 1000);
+        if (mode == QLatin1String("display")) {
+            result.insert(QStringLiteral("displayLatencyP50Us"), percentile(displayLatencies, 50) / 1000);
+            result.insert(QStringLiteral("displayLatencyP99Us"), percentile(displayLatencies, 99) / 1000);
+            result.insert(QStringLiteral("displayLatencyMaxUs"), percentile(displayLatencies, 100) / 1000);
+            result.insert(QStringLiteral("frameP50Ms"), percentile(frames, 50) / 1e6);
+            result.insert(QStringLiteral("frameP99Ms"), percentile(frames, 99) / 1e6);
+            result.insert(QStringLiteral("frameMaxMs"), percentile(frames, 100) / 1e6);
+        }
+        m_results.append(result);
+
+        QCOMPARE(corrupted, qint64(0));
+        QCOMPARE(lost, qint64(0));
+    }
+#else
+    QSKIP("Pseudo terminals are not supported on this platform");
+#endif
+}
+
+int main(int argc, char *argv[])
+{
+    if (qEnvironmentVariableIsEmpty("QT_QPA_PLATFORM"))
+        qputenv("QT_QPA_PLATFORM", "offscreen");
+    QApplication app(argc, argv);
+    // the settings of the benchmark are kept apart from the sessions of the user
+    QCoreApplication::setOrganizationName(QStringLiteral("CuteCom"));
+    QCoreApplication::setApplicationName(QStringLiteral("ptyloopback_bench"));
+
+    // --json <file> is ours, everything else goes to QTest
+    QStringList arguments = app.arguments();
+    QString jsonFile;
+    const int json = arguments.indexOf(QStringLiteral("--json"));
+    if (json > 0 && json + 1 < arguments.size()) {
+        jsonFile = arguments.at(json + 1);
+        arguments.erase(arguments.begin() + json, arguments.begin() + json + 2);
+    }
+
+    PtyLoopbackBench bench(jsonFile);
+    return QTest::qExec(&bench, arguments);
+}
+
+#include "ptyloopback_bench.moc"
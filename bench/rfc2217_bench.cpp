@@ -0,0 +1,221 @@
+/*
+ * Copyright (c) 2026 CuteCom contributors
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 675 Mass Ave, Cambridge, MA 02139, USA.
+ *
+ * For more information on the GPL, please go to:
+ * http://www.gnu.org/copyleft/gpl.html
+ */
+
+/**
+ * RFC 2217 server mode of the net proxy. The codec benchmarks escape the
+ * data for the clients and parse the Telnet stream of a client, both are
+ * compared to a plain copy. The loopback benchmark forwards 4 MB from
+ * NetProxyBridge to a client on 127.0.0.1 with and without RFC 2217 and
+ * prints the rate. The negotiation is checked by tests/rfc2217_test.
+ */
+
+#include "captureclock.h"
+#include "netproxybridge.h"
+#include "rfc2217.h"
+#include <QElapsedTimer>
+#include <QTcpSocket>
+#include <QtTest>
+
+class Rfc2217Bench : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void initTestCase();
+    void escape_data();
+    void escape();
+    void parse_data();
+    void parse();
+    void forward_data();
+    void forward();
+
+private:
+    static void connectClient(NetProxyBridge &bridge, QTcpSocket &client, bool telnet);
+    static QByteArray receive(QTcpSocket &client, int size);
+
+    QByteArray m_data;
+    QTimer m_wakeup;
+};
+
+void Rfc2217Bench::initTestCase()
+{
+    qsrand(1);
+    m_data.resize(4 * 1024 * 1024);
+    for (int i = 0; i < m_data.size(); i++)
+        m_data[i] = static_cast<char>(qrand());
+    // processEvents() below waits for events, this makes sure there are some
+    m_wakeup.start(100);
+}
+
+void Rfc2217Bench::escape_data()
+{
+    QTest::addColumn<bool>("telnet");
+    QTest::addColumn<int>("chunk");
+
+    const int chunks[] = {32, 512, 4096};
+    for (int chunk : chunks) {
+        QTest::newRow(qPrintable(QString("copy/%1").arg(chunk))) << false << chunk;
+        QTest::newRow(qPrintable(QString("rfc2217/%1").arg(chunk))) << true << chunk;
+    }
+}
+
+void Rfc2217Bench::escape()
+{
+    QFETCH(bool, telnet);
+    QFETCH(int, chunk);
+
+    qint64 nsecs = 0;
+    int runs = 0;
+    QByteArray out;
+    QBENCHMARK
+    {
+        QElapsedTimer timer;
+        timer.start();
+        out.clear();
+        for (int pos = 0; pos < m_data.size(); pos += chunk) {
+            const int len = qMin(chunk, m_data.size() - pos);
+            if (telnet)
+                Rfc2217Server::escape(m_data.constData() + pos, len, &out);
+            else
+                out.append(m_data.constData() + pos, len);
+        }
+        nsecs += timer.nsecsElapsed();
+        runs++;
+    }
+    QVERIFY(out.size() >= m_data.size());
+    qDebug("%.1f MB/s", 1000.0 * m_data.size() * runs / qMax<qint64>(1, nsecs));
+}
+
+void Rfc2217Bench::parse_data() { escape_data(); }
+
+void Rfc2217Bench::parse()
+{
+    QFETCH(bool, telnet);
+    QFETCH(int, chunk);
+
+    QByteArray stream;
+    Rfc2217Server::escape(m_data.constData(), m_data.size(), &stream);
+    if (!telnet)
+        stream = m_data;
+
+    qint64 nsecs = 0;
+    int runs = 0;
+    QByteArray data;
+    QBENCHMARK
+    {
+        QElapsedTimer timer;
+        timer.start();
+        Rfc2217Server server;
+        QByteArray reply;
+        QVector<Rfc2217Server::Request> requests;
+        data.clear();
+        for (int pos = 0; pos < stream.size(); pos += chunk) {
+            const int len = qMin(chunk, stream.size() - pos);
+            if (telnet)
+                server.feed(stream.constData() + pos, len, &data, &reply, &requests);
+            else
+                data.append(stream.constData() + pos, len);
+        }
+        nsecs += timer.nsecsElapsed();
+        runs++;
+    }
+    QCOMPARE(data, m_data);
+    qDebug("%.1f MB/s", 1000.0 * stream.size() * runs / qMax<qint64>(1, nsecs));
+}
+
+QByteArray Rfc2217Bench::receive(QTcpSocket &client, int size)
+{
+    QByteArray data;
+    QElapsedTimer timer;
+    timer.start();
+    while (data.size() < size && timer.elapsed() < 5000) {
+        QCoreApplication::processEvents(QEventLoop::WaitForMoreEvents);
+        data.append(client.readAll());
+    }
+    return data;
+}
+
+void Rfc2217Bench::connectClient(NetProxyBridge &bridge, QTcpSocket &client, bool telnet)
+{
+    bridge.setRfc2217(telnet);
+    bridge.startTcpServer(0);
+    QVERIFY(bridge.tcpPort() != 0);
+
+    client.connectToHost(QHostAddress::LocalHost, bridge.tcpPort());
+    QElapsedTimer timer;
+    timer.start();
+    while (client.state() != QAbstractSocket::ConnectedState && timer.elapsed() < 5000)
+        QCoreApplication::processEvents(QEventLoop::WaitForMoreEvents);
+    QCOMPARE(client.state(), QAbstractSocket::ConnectedState);
+    if (telnet)
+        QCOMPARE(receive(client, Rfc2217Server::greeting().size()), Rfc2217Server::greeting());
+}
+
+void Rfc2217Bench::forward_data()
+{
+    QTest::addColumn<bool>("telnet");
+    QTest::addColumn<int>("chunk");
+
+    const int chunks[] = {64, 4096};
+    for (int chunk : chunks) {
+        QTest::newRow(qPrintable(QString("raw/%1").arg(chunk))) << false << chunk;
+        QTest::newRow(qPrintable(QString("rfc2217/%1").arg(chunk))) << true << chunk;
+    }
+}
+
+void Rfc2217Bench::forward()
+{
+    QFETCH(bool, telnet);
+    QFETCH(int, chunk);
+
+    NetProxyBridge bridge;
+    // nothing may be dropped
+    bridge.setQueuePolicy(NetProxyBridge::DROP_NEWEST, Q_INT64_C(1) << 30);
+    QTcpSocket client;
+    connectClient(bridge, client, telnet);
+
+    QByteArray expected = m_data;
+    if (telnet)
+        expected = Rfc2217Server::escape(m_data);
+
+    QByteArray received;
+    received.reserve(expected.size());
+    QElapsedTimer timer;
+    timer.start();
+    for (int pos = 0; pos < m_data.size(); pos += chunk) {
+        bridge.proxyCmd(m_data.mid(pos, chunk), CaptureClock::nsecsElapsed());
+        // let both sides of the connection work now and then
+        if ((pos / chunk) % 16 == 15) {
+            QCoreApplication::processEvents();
+            received.append(client.readAll());
+        }
+    }
+    received.append(receive(client, expected.size() - received.size()));
+    const qint64 nsecs = timer.nsecsElapsed();
+
+    QCOMPARE(received.size(), expected.size());
+    QVERIFY(received == expected);
+    qDebug("%.1f MB/s", 1000.0 * m_data.size() / qMax<qint64>(1, nsecs));
+}
+
+QTEST_GUILESS_MAIN(Rfc2217Bench)
+
+#include "rfc2217_bench.moc"
@@ -0,0 +1,119 @@
+/*
+ * Copyright (c) 2026 CuteCom contributors
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 675 Mass Ave, Cambridge, MA 02139, USA.
+ *
+ * For more information on the GPL, please go to:
+ * http://www.gnu.org/copyleft/gpl.html
+ */
+
+/**
+ * Cost of the merged timeline of several ports with a million lines each.
+ * The view asks for the rows it shows only: jumping to a random row has
+ * to stay in the microseconds, scrolling on from there even less.
+ */
+
+#include "timeline.h"
+#include <QElapsedTimer>
+#include <QtTest>
+
+class TimelineBench : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void initTestCase();
+    void order();
+    void seek();
+    void scroll();
+
+private:
+    enum { PORTS = 4, LINES = 1000000, VISIBLE = 50 };
+
+    TimelineIndex m_ports[PORTS];
+    TimelineMerge m_merge;
+};
+
+void TimelineBench::initTestCase()
+{
+    qsrand(1);
+    QVector<qint64> time(PORTS, 0);
+    QVector<const TimelineIndex *> sources;
+    for (int port = 0; port < PORTS; port++) {
+        m_ports[port].setCapacity(Q_INT64_C(1) << 30);
+        // reads of up to 4 lines, the lines of one read share the timestamp
+        for (int lines = 0; lines < LINES; lines += 4) {
+            time[port] += qrand() % 2000000;
+            m_ports[port].append(QByteArrayLiteral("port line with some data\r\n").repeated(4), time.at(port));
+        }
+        QCOMPARE(m_ports[port].lineCount(), int(LINES));
+        sources.append(&m_ports[port]);
+    }
+    m_merge.setSources(sources);
+}
+
+void TimelineBench::order()
+{
+    QVector<TimelineMerge::Row> rows = m_merge.rows(m_merge.rowCount() / 2, 10000);
+    QCOMPARE(rows.size(), 10000);
+    for (int i = 1; i < rows.size(); i++) {
+        const TimelineMerge::Row &a = rows.at(i - 1);
+        const TimelineMerge::Row &b = rows.at(i);
+        const qint64 ta = m_ports[a.source].timestamp(a.line);
+        const qint64 tb = m_ports[b.source].timestamp(b.line);
+        // lines read at the same time are in the order of the ports
+        QVERIFY(ta < tb || (ta == tb && (a.source < b.source || (a.source == b.source && a.line + 1 == b.line))));
+    }
+}
+
+void TimelineBench::seek()
+{
+    qint64 nsecs = 0;
+    int runs = 0;
+    QBENCHMARK
+    {
+        QElapsedTimer timer;
+        timer.start();
+        for (int i = 0; i < 1000; i++) {
+            const qint64 row = (qint64(qrand()) * qrand()) % m_merge.rowCount();
+            m_merge.invalidate();
+            QVERIFY(!m_merge.rows(row, VISIBLE).isEmpty());
+        }
+        nsecs += timer.nsecsElapsed();
+        runs++;
+    }
+    qDebug("%.1f us per jump", nsecs / 1000.0 / 1000 / qMax(1, runs));
+}
+
+void TimelineBench::scroll()
+{
+    qint64 nsecs = 0;
+    qint64 pages = 0;
+    QBENCHMARK
+    {
+        QElapsedTimer timer;
+        timer.start();
+        for (qint64 row = 0; row < 1000 * VISIBLE; row += VISIBLE) {
+            QCOMPARE(m_merge.rows(row, VISIBLE).size(), int(VISIBLE));
+            pages++;
+        }
+        nsecs += timer.nsecsElapsed();
+    }
+    qDebug("%.1f us per page", nsecs / 1000.0 / qMax<qint64>(1, pages));
+}
+
+QTEST_APPLESS_MAIN(TimelineBench)
+
+#include "timeline_bench.moc"
@@ -0,0 +1,197 @@
+/*
+ * Copyright (c) 2026 CuteCom contributors
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 675 Mass Ave, Cambridge, MA 02139, USA.
+ *
+ * For more information on the GPL, please go to:
+ * http://www.gnu.org/copyleft/gpl.html
+ */
+
+/**
+ * UDP forwarding of the net proxy. Small chunks of serial data are sent
+ * over loopback, one datagram per chunk and coalesced with and without the
+ * header; the datagrams received, their mean size and the rate are printed.
+ * The deadline test checks that a datagram that doesn't fill up is sent
+ * after the max. latency and a full one right away.
+ */
+
+#include "captureclock.h"
+#include "netproxybridge.h"
+#include <QElapsedTimer>
+#include <QUdpSocket>
+#include <QtEndian>
+#include <QtTest>
+
+class UdpCoalescingBench : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void initTestCase();
+    void forward_data();
+    void forward();
+    void deadline();
+
+private:
+    static void bind(NetProxyBridge &bridge, QUdpSocket &receiver);
+    /* read the datagrams, waiting up to timeout ms for the first one */
+    static QList<QByteArray> receive(QUdpSocket &receiver, int timeout);
+    static void readPending(QUdpSocket &receiver, QList<QByteArray> *datagrams);
+
+    QByteArray m_data;
+    QTimer m_wakeup;
+};
+
+void UdpCoalescingBench::initTestCase()
+{
+    qsrand(1);
+    m_data.resize(1024 * 1024);
+    for (int i = 0; i < m_data.size(); i++)
+        m_data[i] = static_cast<char>(qrand());
+    // processEvents() below waits for events, this makes sure there are some
+    m_wakeup.start(100);
+}
+
+void UdpCoalescingBench::bind(NetProxyBridge &bridge, QUdpSocket &receiver)
+{
+    QVERIFY(receiver.bind(QHostAddress::LocalHost, 0));
+    receiver.setSocketOption(QAbstractSocket::ReceiveBufferSizeSocketOption, 16 * 1024 * 1024);
+    bridge.bindUdp(QStringLiteral("127.0.0.1"), 0, QStringLiteral("127.0.0.1"), receiver.localPort());
+}
+
+QList<QByteArray> UdpCoalescingBench::receive(QUdpSocket &receiver, int timeout)
+{
+    QList<QByteArray> datagrams;
+    QElapsedTimer timer;
+    timer.start();
+    while (!receiver.hasPendingDatagrams() && timer.elapsed() < timeout)
+        QCoreApplication::processEvents(QEventLoop::WaitForMoreEvents);
+    QCoreApplication::processEvents();
+    readPending(receiver, &datagrams);
+    return datagrams;
+}
+
+void UdpCoalescingBench::readPending(QUdpSocket &receiver, QList<QByteArray> *datagrams)
+{
+    while (receiver.hasPendingDatagrams()) {
+        QByteArray datagram;
+        datagram.resize(receiver.pendingDatagramSize());
+        receiver.readDatagram(datagram.data(), datagram.size());
+        datagrams->append(datagram);
+    }
+}
+
+void UdpCoalescingBench::forward_data()
+{
+    QTest::addColumn<int>("chunk");
+    QTest::addColumn<int>("latency");
+    QTest::addColumn<bool>("header");
+
+    const int chunks[] = {16, 64, 512};
+    for (int chunk : chunks) {
+        QTest::newRow(qPrintable(QString("immediate/%1").arg(chunk))) << chunk << 0 << false;
+        QTest::newRow(qPrintable(QString("coalesced/%1").arg(chunk))) << chunk << 5 << false;
+        QTest::newRow(qPrintable(QString("header/%1").arg(chunk))) << chunk << 5 << true;
+    }
+}
+
+void UdpCoalescingBench::forward()
+{
+    QFETCH(int, chunk);
+    QFETCH(int, latency);
+    QFETCH(bool, header);
+
+    NetProxyBridge bridge;
+    QUdpSocket receiver;
+    bind(bridge, receiver);
+    // without coalescing every chunk is a datagram of its own
+    bridge.setUdpCoalescing(latency ? 1472 : chunk + (header ? int(NetProxyBridge::UDP_HEADER_SIZE) : 0), latency,
+                            header);
+
+    QList<QByteArray> datagrams;
+    QElapsedTimer timer;
+    timer.start();
+    for (int pos = 0; pos < m_data.size(); pos += chunk) {
+        bridge.proxyCmd(m_data.mid(pos, chunk), CaptureClock::nsecsElapsed());
+        if ((pos / chunk) % 64 == 63) {
+            QCoreApplication::processEvents();
+            readPending(receiver, &datagrams);
+        }
+    }
+    datagrams.append(receive(receiver, latency + 100));
+    const qint64 nsecs = timer.nsecsElapsed();
+
+    QByteArray received;
+    quint32 expected = 0;
+    int lost = 0;
+    qint64 lastTime = 0;
+    foreach (const QByteArray &datagram, datagrams) {
+        if (!header) {
+            received.append(datagram);
+            continue;
+        }
+        QVERIFY(datagram.size() > NetProxyBridge::UDP_HEADER_SIZE);
+        const uchar *bytes = reinterpret_cast<const uchar *>(datagram.constData());
+        const quint32 sequence = qFromBigEndian<quint32>(bytes);
+        const qint64 time = qFromBigEndian<qint64>(bytes + 4);
+        QVERIFY(sequence >= expected);
+        QVERIFY(time >= lastTime);
+        lost += sequence - expected;
+        expected = sequence + 1;
+        lastTime = time;
+        received.append(datagram.mid(NetProxyBridge::UDP_HEADER_SIZE));
+    }
+    if (header)
+        QCOMPARE(int(expected), datagrams.size() + lost);
+    // nothing may be lost over loopback once the data are coalesced
+    if (latency)
+        QVERIFY(received == m_data);
+
+    qDebug("%d datagrams, %.0f bytes each, %d lost, %.1f MB/s", datagrams.size(),
+           double(received.size()) / qMax(1, datagrams.size()), lost, 1000.0 * m_data.size() / qMax<qint64>(1, nsecs));
+}
+
+void UdpCoalescingBench::deadline()
+{
+    NetProxyBridge bridge;
+    QUdpSocket receiver;
+    bind(bridge, receiver);
+    bridge.setUdpCoalescing(1472, 20, true);
+
+    // a small chunk waits for the max. latency
+    QElapsedTimer timer;
+    timer.start();
+    bridge.proxyCmd(QByteArray("0123456789"), CaptureClock::nsecsElapsed());
+    QList<QByteArray> datagrams = receive(receiver, 1000);
+    QCOMPARE(datagrams.size(), 1);
+    QVERIFY(timer.elapsed() >= 15);
+    QCOMPARE(datagrams.at(0).mid(NetProxyBridge::UDP_HEADER_SIZE), QByteArray("0123456789"));
+
+    // a full datagram goes out right away, the rest waits
+    timer.restart();
+    bridge.proxyCmd(m_data.left(1472 - NetProxyBridge::UDP_HEADER_SIZE + 1), CaptureClock::nsecsElapsed());
+    datagrams = receive(receiver, 1000);
+    QCOMPARE(datagrams.size(), 1);
+    QVERIFY(timer.elapsed() < 15);
+    QCOMPARE(datagrams.at(0).size(), 1472);
+    QCOMPARE(qFromBigEndian<quint32>(reinterpret_cast<const uchar *>(datagrams.at(0).constData())), quint32(1));
+    datagrams = receive(receiver, 1000);
+    QCOMPARE(datagrams.size(), 1);
+    QCOMPARE(datagrams.at(0).size(), NetProxyBridge::UDP_HEADER_SIZE + 1);
+}
+
+QTEST_GUILESS_MAIN(UdpCoalescingBench)
+
+#include "udpcoalescing_bench.moc"
@@ -0,0 +1,52 @@
+/*
+ * Copyright (c) 2026 CuteCom contributors
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 675 Mass Ave, Cambridge, MA 02139, USA.
+ *
+ * For more information on the GPL, please go to:
+ * http://www.gnu.org/copyleft/gpl.html
+ */
+
+#include "captureclock.h"
+
+#include <QElapsedTimer>
+
+namespace
+{
+struct ClockBase {
+    ClockBase()
+        : wallClock(QDateTime::currentDateTime())
+        , epochMSecs(wallClock.toMSecsSinceEpoch())
+    {
+        timer.start();
+    }
+    QElapsedTimer timer;
+    QDateTime wallClock;
+    qint64 epochMSecs;
+};
+
+// function local static: initialisation is thread safe with C++11
+ClockBase &clockBase()
+{
+    static ClockBase base;
+    return base;
+}
+}
+
+qint64 CaptureClock::nsecsElapsed() { return clockBase().timer.nsecsElapsed(); }
+
+QDateTime CaptureClock::toDateTime(qint64 nsecs) { return clockBase().wallClock.addMSecs(nsecs / 1000000); }
+
+qint64 CaptureClock::toUSecsSinceEpoch(qint64 nsecs) { return clockBase().epochMSecs * 1000 + nsecs / 1000; }
@@ -0,0 +1,59 @@
+/*
+ * Copyright (c) 2026 CuteCom contributors
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 675 Mass Ave, Cambridge, MA 02139, USA.
+ *
+ * For more information on the GPL, please go to:
+ * http://www.gnu.org/copyleft/gpl.html
+ */
+
+#ifndef CAPTURECLOCK_H
+#define CAPTURECLOCK_H
+
+#include <QDateTime>
+#include <QtGlobal>
+
+/**
+ * Monotonic time base shared by everything that needs to timestamp
+ * data at the moment it has been read from (or written to) the device.
+ * All timestamps are nanoseconds since the first use of the clock,
+ * so values taken by different components can be compared directly.
+ */
+class CaptureClock
+{
+public:
+    /**
+     * @brief Nanoseconds elapsed since the clock has been started
+     */
+    static qint64 nsecsElapsed();
+
+    /**
+     * @brief Convert a timestamp taken with nsecsElapsed() to wall clock time
+     */
+    static QDateTime toDateTime(qint64 nsecs);
+
+    /**
+     * @brief Convert a timestamp taken with nsecsElapsed() to a time of day
+     */
+    static QTime toTime(qint64 nsecs) { return toDateTime(nsecs).time(); }
+
+    /**
+     * @brief Convert a timestamp taken with nsecsElapsed() to microseconds
+     *  since 1970-01-01T00:00:00 UTC
+     */
+    static qint64 toUSecsSinceEpoch(qint64 nsecs);
+};
+
+#endif // CAPTURECLOCK_H
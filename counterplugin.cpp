@@ -20,6 +20,7 @@
  */
 
 #include "counterplugin.h"
+#include "captureclock.h"
 #include "ui_counterplugin.h"
 #include <QMessageBox>
 
@@ -29,85 +30,103 @@
         qDebug()
 
 static bool debug = false;
-static CounterPlugin *m_counter = NULL;
-static int processCmd(const QString *text, QString *new_text);
 
 CounterPlugin::CounterPlugin(QFrame *parent, Settings *settings)
     : QFrame(parent)
     , ui(new Ui::CounterPlugin)
     , m_settings(settings)
+    , m_rxCleared(0)
+    , m_txCleared(0)
+    , m_rxMemory(0)
+    , m_txMemory(0)
 {
     ui->setupUi(this);
-    /* Plugin by default disabled, no injection, has QFrame, no injection process cmd */
-    m_plugin = new Plugin(this, "Byte Counter", this, (Plugin::processCmd_fp)&processCmd);
-    /* reset values */
-    ui->m_lbl_rx_value->setText("0");
-    ui->m_lbl_tx_value->setText("0");
-    ui->m_lbl_mrx_value->setText("0");
-    ui->m_lbl_mtx_value->setText("0");
+    /* Has QFrame, counts the sent bytes in the TX hook without changing them */
+    m_plugin = new Plugin(this, "Byte Counter", this, &CounterPlugin::processTx);
+    /* counting is cheap enough to be done right in the read handler */
+    m_plugin->processRx = &CounterPlugin::processRx;
 
     connect(ui->m_bt_unload, &QPushButton::clicked, this, &CounterPlugin::removePlugin);
     connect(ui->m_bt_help, &QPushButton::clicked, this, &CounterPlugin::helpMsg);
     connect(ui->m_bt_clear, &QPushButton::clicked, this, [=]() {
-        ui->m_lbl_rx_value->setText("0");
-        ui->m_lbl_tx_value->setText("0");
+        m_rxCleared = m_rx.bytes();
+        m_txCleared = m_tx.bytes();
+        m_rx.clearPeak();
+        m_tx.clearPeak();
+        updateLabels();
     });
     connect(ui->m_bt_clear_memory, &QPushButton::clicked, this, [=]() {
-        ui->m_lbl_mrx_value->setText("0");
-        ui->m_lbl_mtx_value->setText("0");
+        m_rxMemory = 0;
+        m_txMemory = 0;
+        updateLabels();
     });
     connect(ui->m_bt_memory, &QPushButton::clicked, this, [=]() {
-        ui->m_lbl_mrx_value->setText(ui->m_lbl_rx_value->text());
-        ui->m_lbl_mtx_value->setText(ui->m_lbl_tx_value->text());
+        m_rxMemory = m_rx.bytes() - m_rxCleared;
+        m_txMemory = m_tx.bytes() - m_txCleared;
+        updateLabels();
     });
-    m_counter = this;
+    connect(&m_renderTimer, &QTimer::timeout, this, &CounterPlugin::updateLabels);
+    m_renderTimer.start(250);
+    updateLabels();
 
     TRACE << "[CounterPlugin::CounterPlugin]";
 }
 
-CounterPlugin::~CounterPlugin()
-{
-    delete ui;
-    if (m_counter)
-        m_counter = NULL;
-}
+CounterPlugin::~CounterPlugin() { delete ui; }
 
 /**
  * @brief Static function to use as proxy to call public
  *          member funtions from this object
- * @param text The data that are about to be sent
- * @param new_text The new data
- * @return int Always retutn 0 in this case
+ * @param owner The counter plugin
+ * @param data The data that are about to be sent
+ * @return Plugin::TX_UNCHANGED The data are only counted
  */
-int processCmd(const QString *text, QString *new_text)
+Plugin::TxResult CounterPlugin::processTx(QObject *owner, QByteArray &data)
 {
-    m_counter->txBytes(text->length());
+    static_cast<CounterPlugin *>(owner)->m_tx.add(data.size());
 
-    TRACE << "[CounterPlugin::processCmd] " << text->toLatin1();
-    return 0;
+    TRACE << "[CounterPlugin::processTx] " << data.size();
+    return Plugin::TX_UNCHANGED;
 }
 
 /**
- * @brief Handle Tx bytes.
- * @param len The number of received bytes
+ * @brief Called by the plugin manager with the received data. Only
+ *  the counters are updated, the labels follow with the render timer.
  */
-void CounterPlugin::txBytes(int len)
+void CounterPlugin::processRx(QObject *owner, const QByteArray &data, qint64)
 {
-    int value = m_counter->ui->m_lbl_tx_value->text().toInt();
-    value += len;
-    ui->m_lbl_tx_value->setText(QString::number(value));
+    static_cast<CounterPlugin *>(owner)->m_rx.add(data.size());
+}
+
+QString CounterPlugin::formatRate(const ThroughputMeter &meter, double maxBytesPerSecond)
+{
+    QString text = tr("%1 B/s  %2 frames/s  peak %3 B/s")
+                       .arg(meter.bytesPerSecond(), 0, 'f', 0)
+                       .arg(meter.framesPerSecond(), 0, 'f', 1)
+                       .arg(meter.peakBytesPerSecond(), 0, 'f', 0);
+    if (maxBytesPerSecond > 0)
+        text += tr("  load %1 %").arg(100.0 * meter.bytesPerSecond() / maxBytesPerSecond, 0, 'f', 1);
+    return text;
 }
 
 /**
- * @brief
- * @param data
+ * @brief Render the counters and rates, called a few times per second
  */
-void CounterPlugin::rxBytes(QByteArray data)
+void CounterPlugin::updateLabels()
 {
-    TRACE << "[CounterPlugin::rxBytes]: " << data.length();
-    int value = ui->m_lbl_rx_value->text().toInt();
-    value += data.length();
-    ui->m_lbl_rx_value->setText(QString::number(value));
+    const qint64 now = CaptureClock::nsecsElapsed();
+    m_rx.sample(now);
+    m_tx.sample(now);
+
+    const Settings::Session session = m_settings->getCurrentSession();
+    const double maxBytesPerSecond = session.baudRate / session.bitsPerCharacter();
+
+    ui->m_lbl_rx_value->setText(QString::number(m_rx.bytes() - m_rxCleared));
+    ui->m_lbl_tx_value->setText(QString::number(m_tx.bytes() - m_txCleared));
+    ui->m_lbl_mrx_value->setText(QString::number(m_rxMemory));
+    ui->m_lbl_mtx_value->setText(QString::number(m_txMemory));
+    ui->m_lbl_rx_rate_value->setText(formatRate(m_rx, maxBytesPerSecond));
+    ui->m_lbl_tx_rate_value->setText(formatRate(m_tx, maxBytesPerSecond));
 }
 
 /**
@@ -134,7 +153,11 @@ void CounterPlugin::helpMsg(void)
                           "the MTx/MRx. Also, you can clear those values independently.\n\n"
                           "Press 'C' to clear the Tx/Rx values\n"
                           "Press 'M' to store the Tx/Rx to MTx/MRx\n"
-                          "Press 'CM' to clear the MTx/Rx values\n");
+                          "Press 'CM' to clear the MTx/Rx values\n\n"
+                          "The rates are averaged over the last second. A frame is\n"
+                          "one chunk read from or written to the device. The load\n"
+                          "is the rate relative to the maximum of the configured\n"
+                          "baud rate, data, parity and stop bits.\n");
 
     QMessageBox::information(this, tr("How to use TCP forwarding"), help_str);
 }
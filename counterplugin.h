@@ -24,8 +24,10 @@
 
 #include "plugin.h"
 #include "settings.h"
+#include "throughputmeter.h"
 #include <QDebug>
 #include <QFrame>
+#include <QTimer>
 
 namespace Ui
 {
@@ -40,22 +42,36 @@ public:
     explicit CounterPlugin(QFrame *parent, Settings *settings);
     ~CounterPlugin();
     const Plugin *plugin();
-    //    int processCmd(const QString *text, QString *new_text);
 
 signals:
     void sendCmd(QByteArray);
     void unload(Plugin *);
 
 public slots:
-    void txBytes(int);
-    void rxBytes(QByteArray);
     void removePlugin(bool);
     void helpMsg(void);
 
 private:
+    static Plugin::TxResult processTx(QObject *owner, QByteArray &data);
+    static void processRx(QObject *owner, const QByteArray &data, qint64 timestamp);
+    QString formatRate(const ThroughputMeter &meter, double maxBytesPerSecond);
+    void updateLabels();
+
     Ui::CounterPlugin *ui;
     Plugin *m_plugin;
     Settings *m_settings;
+    ThroughputMeter m_rx;
+    ThroughputMeter m_tx;
+    /* the counters are never reset, clearing only moves the base */
+    qint64 m_rxCleared;
+    qint64 m_txCleared;
+    qint64 m_rxMemory;
+    qint64 m_txMemory;
+    /**
+     * The labels are only rendered by this timer, not for every chunk
+     * @brief m_renderTimer
+     */
+    QTimer m_renderTimer;
 };
 
 #endif // COUNTERPLUGIN_H
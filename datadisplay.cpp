@@ -24,6 +24,7 @@
  */
 
 #include "datadisplay.h"
+#include "captureclock.h"
 #include "datahighlighter.h"
 #include "searchpanel.h"
 #include "timeview.h"
@@ -41,11 +42,30 @@ DataDisplay::DataDisplay(QWidget *parent)
     , m_hexLeftOver(0)
     , m_displayHex(false)
     , m_displayCtrlCharacters(false)
-    , m_linebreakChar('\n')
+    , m_decodeUtf8(false)
+    , m_foldRepeatedLines(false)
+    , m_paused(false)
+    , m_pausedByUser(false)
+    , m_suspended(false)
+    , m_pausedBytes(0)
+    , m_skipped(false)
+    , m_skippedSince(0)
+    , m_catchingUp(false)
+    , m_lineBytes(0)
+    , m_idleGap(0)
+    , m_characterTime(0)
+    , m_lastRead(0)
+    , m_rowBytes(0)
     , m_previous_ended_with_nl(true)
     , m_redisplay(false)
 {
     setupTextFormats();
+    m_fold.changed = false;
+    m_fold.newRow = false;
+    m_fold.suffixLength = 0;
+    m_fold.removePartialLine = false;
+    resetFold();
+    setLinebreak(QStringLiteral("\\n"));
     m_timestamps = m_dataDisplay->timestamps();
     m_highlighter = new DataHighlighter(m_dataDisplay->document());
 
@@ -68,6 +88,20 @@ DataDisplay::DataDisplay(QWidget *parent)
 void DataDisplay::clear()
 {
     m_hexBytes = 0;
+    m_hexLeftOver.clear();
+    m_rowBytes = 0;
+    m_lineBytes = 0;
+    m_linebreakMatcher.reset();
+    m_utf8Decoder.reset();
+    m_previous_ended_with_nl = true;
+    m_fold.changed = false;
+    m_fold.newRow = false;
+    m_fold.suffixLength = 0;
+    m_fold.removePartialLine = false;
+    resetFold();
+    m_pausedReads.clear();
+    m_pausedBytes = 0;
+    m_skipped = false;
     m_timestamps->clear();
     m_dataDisplay->clear();
 }
@@ -86,7 +120,7 @@ void DataDisplay::setUndoRedoEnabled(bool enable) { m_dataDisplay->setUndoRedoEn
  */
 void DataDisplay::displayDataFromBuffer(void)
 {
-    if (m_data.isEmpty())
+    if (m_data.isEmpty() && !m_fold.changed && !m_fold.removePartialLine)
         return;
 
     // Store selection position before appending new data
@@ -100,6 +134,8 @@ void DataDisplay::displayDataFromBuffer(void)
     int save_scroll = sb->value();
     bool save_max = (save_scroll == sb->maximum());
 
+    displayFold();
+
     m_dataDisplay->moveCursor(QTextCursor::End);
     if (!m_displayHex) {
         m_dataDisplay->textCursor().beginEditBlock();
@@ -107,6 +143,9 @@ void DataDisplay::displayDataFromBuffer(void)
         // each part of the line with it's set format
         foreach (DisplayLine line, m_data) {
             m_dataDisplay->textCursor().insertText(line.data, *m_format_data);
+            // the counter of a row folded while catching up
+            if (!line.trailer.isEmpty())
+                m_dataDisplay->textCursor().insertText(line.trailer, *m_format_ascii);
         }
         m_dataDisplay->textCursor().endEditBlock();
     } else {
@@ -115,6 +154,9 @@ void DataDisplay::displayDataFromBuffer(void)
         // with the current data added
         if (m_redisplay) {
             m_dataDisplay->moveCursor(QTextCursor::End, QTextCursor::MoveAnchor);
+            // a complete line leaves an empty block behind, redraw the one before
+            if (m_dataDisplay->textCursor().block().length() == 1)
+                m_dataDisplay->moveCursor(QTextCursor::PreviousBlock, QTextCursor::MoveAnchor);
             m_dataDisplay->moveCursor(QTextCursor::StartOfLine, QTextCursor::MoveAnchor);
             m_dataDisplay->moveCursor(QTextCursor::End, QTextCursor::KeepAnchor);
             m_dataDisplay->textCursor().removeSelectedText();
@@ -131,6 +173,11 @@ void DataDisplay::displayDataFromBuffer(void)
     //        qDebug() << "last TextBlock # " << blockCount() << " length: " << m_timestamps.length();
     //        Q_ASSERT(blockCount() == m_timestamps.length());
     m_data.clear();
+    m_fold.dataIndex = -1;
+    if (m_fold.newRow) {
+        m_fold.suffixLength = 0;
+        m_fold.newRow = false;
+    }
 
     // if any text was selected before appending new data then restore that selection
     if (selLength > 0) {
@@ -151,52 +198,61 @@ void DataDisplay::displayDataFromBuffer(void)
  * \brief DataDisplay::displayData
  * \param data
  */
-void DataDisplay::displayData(const QByteArray &data)
+void DataDisplay::displayData(const QByteArray &data) { displayData(data, CaptureClock::nsecsElapsed()); }
+
+/*!
+ * Prepare data and buffer them in m_data.
+ * \brief DataDisplay::displayData
+ * \param data
+ * \param timestamp CaptureClock time the data have been read
+ */
+void DataDisplay::displayData(const QByteArray &data, qint64 timestamp)
 {
-    m_timestamp = QTime::currentTime();
+    if (m_paused) {
+        PausedRead read;
+        read.data = data;
+        read.timestamp = timestamp;
+        m_pausedReads.append(read);
+        m_pausedBytes += data.size();
+        while (m_pausedBytes - m_pausedReads.first().data.size() >= PAUSE_BUFFER_SIZE) {
+            if (!m_skipped)
+                m_skippedSince = m_pausedReads.first().timestamp;
+            m_skipped = true;
+            m_pausedBytes -= m_pausedReads.takeFirst().data.size();
+        }
+        return;
+    }
+    if (m_idleGap) {
+        displayIdleGapData(data, timestamp);
+        return;
+    }
+    m_timestamp = CaptureClock::toTime(timestamp);
 
     if (m_displayHex) {
         bool isFirst = m_data.isEmpty();
         bool redisplay = formatHexData(data);
         if (isFirst)
             m_redisplay = redisplay;
-    } else if (!data.contains(m_linebreakChar)) {
-        constructDisplayLine(data);
     } else {
-        // display multiple lines
-
-        // split line at m_linebreakChar (e.g.'\n') but do not remove them
-        // ToDo: Testing needed to verify that the display will not be messed up
-        // if
-        //   - m_linebreakChar is setup with `\r` AND
-        //   - line contains '\n' AND
-        //   - timeview is enabled :(
-        QList<QByteArray> lines;
+        // single pass: the matcher reports the end of each delimiter and
+        // the bytes up to there are formatted right from the read buffer
+        const char *inData = data.constData();
         int start = 0;
-        int end;
-        while ((end = data.indexOf(m_linebreakChar, start)) != -1) {
-            end++; // include separator
-            lines.append(data.mid(start, end - start));
-            start = end;
-        }
-        if (start < data.size()) {
-            lines.append(data.mid(start));
-            // ends_with_lf = false;
-        }
-
-        // if the last line of the previous junk of data
-        // was less than 16 bytes of data, it needs to
-        // be rewritten
-        // in this case, the last line was not removed
-        // test if last line of previous junk was complete
-        // append the first line of the current junk
-        // if (m_displayHex && m_data.size() > 0) {
-        //    constructDisplayLine(lines.takeFirst(), true);
-        // }
-
-        foreach (QByteArray line, lines) {
-            constructDisplayLine(line);
-        }
+        m_linebreakMatcher.feed(inData, data.size(), [&](int id, int end) {
+            // several delimiters may end at the same byte, the longest one breaks the line.
+            // A delimiter starting before the current line overlaps the previous break,
+            // the line starts m_lineBytes before start, possibly in the previous read
+            const int size = m_linebreakMatcher.pattern(id).size();
+            if (end + 1 - size < start - m_lineBytes)
+                return true;
+            if (m_linebreakAnchored.at(id) && m_lineBytes + end + 1 - start != size)
+                return true;
+            constructDisplayLine(inData + start, end + 1 - start, true);
+            start = end + 1;
+            return true;
+        });
+        if (start < data.size())
+            constructDisplayLine(inData + start, data.size() - start, false);
     }
 
     // now the new data is appended to m_data buffer, and will be
@@ -205,36 +261,157 @@ void DataDisplay::displayData(const QByteArray &data)
         m_bufferingIncomingDataTimer.start(70);
 }
 
+/*!
+ * Rows are split by the idle time between the reads instead of
+ * line breaks. The gap is measured from the end of the previous read
+ * to the estimated arrival of the first byte of this one, i.e. the
+ * read time minus the transmission time of the data.
+ * \brief DataDisplay::displayIdleGapData
+ * \param data
+ * \param timestamp CaptureClock time the data have been read
+ */
+void DataDisplay::displayIdleGapData(const QByteArray &data, qint64 timestamp)
+{
+    const qint64 start = qMax(timestamp - data.size() * m_characterTime, m_lastRead);
+    if (m_rowBytes && start - m_lastRead >= m_idleGap)
+        closeRow();
+    m_lastRead = timestamp;
+
+    if (!m_rowBytes) {
+        // a line left over from before the idle splitting was enabled
+        terminateLine(QString());
+        m_timestamp = CaptureClock::toTime(start);
+        // the hex offsets count from the start of the row
+        m_hexBytes = 0;
+    }
+    m_rowBytes += data.size();
+
+    if (m_displayHex) {
+        bool isFirst = m_data.isEmpty();
+        bool redisplay = formatHexData(data);
+        if (isFirst)
+            m_redisplay = redisplay;
+    } else {
+        constructDisplayLine(data.constData(), data.size(), false);
+    }
+
+    if (!m_bufferingIncomingDataTimer.isActive())
+        m_bufferingIncomingDataTimer.start(70);
+}
+
+/*!
+ * End the current row with its length
+ * \brief DataDisplay::closeRow
+ */
+void DataDisplay::closeRow()
+{
+    if (!m_rowBytes)
+        return;
+    terminateLine(QString("  (%1 bytes)").arg(m_rowBytes));
+    m_rowBytes = 0;
+}
+
+/*!
+ * Append \a suffix and a line break to the last line. In hex
+ * mode the last line gets redrawn, even if it was complete.
+ * \brief DataDisplay::terminateLine
+ */
+void DataDisplay::terminateLine(const QString &suffix)
+{
+    if (m_displayHex) {
+        if (m_hexLeftOver.isEmpty() || (suffix.isEmpty() && m_previous_ended_with_nl))
+            return;
+        if (m_data.isEmpty())
+            m_redisplay = true;
+        else
+            m_data.removeLast();
+        DisplayLine line = formatHexLine(m_hexLeftOver, m_hexBytes - m_hexLeftOver.size());
+        line.trailer += suffix + '\n';
+        m_data.append(line);
+        m_hexLeftOver.clear();
+    } else {
+        if (m_previous_ended_with_nl)
+            return;
+        DisplayLine line;
+        line.data = suffix + '\n';
+        m_data.append(line);
+    }
+    m_previous_ended_with_nl = true;
+
+    if (!m_bufferingIncomingDataTimer.isActive())
+        m_bufferingIncomingDataTimer.start(70);
+}
+
 /*!
  * \brief OutputTerminal::constructDisplayLine
- * \param inData
+ * \param inData The bytes of (a part of) one line
+ * \param len Number of bytes
+ * \param lineBreak The bytes end with a delimiter, start a new line afterwards
  */
-void DataDisplay::constructDisplayLine(const QByteArray &inData)
+void DataDisplay::constructDisplayLine(const char *inData, int len, bool lineBreak)
 {
     DisplayLine line;
+    // rows split by idle time have no line breaks, show the characters instead
+    const bool breakLines = !m_idleGap;
+    const bool showCtrlCharacters = m_displayCtrlCharacters || !breakLines;
+    const bool fold = m_foldRepeatedLines && breakLines;
+
+    if (fold) {
+        if (!m_lineBytes) {
+            m_fold.hash = 0;
+            m_fold.bytes = 0;
+            m_fold.foldable = m_previous_ended_with_nl;
+            m_fold.dataIndex = m_data.size();
+            m_fold.timestampIndex = m_timestamps->size();
+            m_fold.time = m_timestamp;
+        }
+        // FNV-1a, continued over the reads, so comparing lines costs the same no matter how long they are
+        for (int i = 0; i < len; i++)
+            m_fold.hash = (m_fold.hash ^ static_cast<uchar>(inData[i])) * Q_UINT64_C(0x100000001b3);
+        m_fold.bytes += len;
+    }
 
     if (m_previous_ended_with_nl) {
         m_timestamps->append(m_timestamp);
+        m_previous_ended_with_nl = false;
     }
+    m_lineBytes = lineBreak ? 0 : m_lineBytes + len;
+
+    auto appendInvalid = [&line](uchar b) { line.data += QString("<0x%1>").arg(static_cast<uint>(b), 2, 16, QChar('0')); };
+    auto appendCharacter = [&line](uint ucs4) {
+        if (!QChar::isPrint(ucs4)) {
+            line.data += QString("<U+%1>").arg(ucs4, 4, 16, QChar('0'));
+        } else if (QChar::requiresSurrogates(ucs4)) {
+            line.data += QChar(QChar::highSurrogate(ucs4));
+            line.data += QChar(QChar::lowSurrogate(ucs4));
+        } else {
+            line.data += QChar(ucs4);
+        }
+    };
+
+    for (int i = 0; i < len; i++) {
+        // printable ASCII is the same in all encodings and taken over in blocks
+        if (!m_utf8Decoder.isPending()) {
+            const int run = Utf8Decoder::printableAsciiRun(inData + i, len - i);
+            if (run) {
+                line.data += QLatin1String(inData + i, run);
+                i += run;
+                if (i == len)
+                    break;
+            }
+        }
+        unsigned int b = static_cast<uchar>(inData[i]);
+        if (m_decodeUtf8 && m_utf8Decoder.feed(b, appendCharacter, appendInvalid))
+            continue;
 
-    for (int i = 0; i < inData.size(); i++) {
-        unsigned int b = inData.at(i);
-        // print newline depending on m_linebreakChar
         if ((isprint(b)) || (b == '\n') || (b == '\r') || (b == '\t')) {
 
             if (b == '\r') {
-                if (m_displayCtrlCharacters)
+                if (showCtrlCharacters)
                     line.data += QChar(0x240D);
-                if (m_linebreakChar == '\r') {
-                    line.data += '\n';
-                }
             } else if (b == '\n') {
-                if (m_displayCtrlCharacters)
+                if (showCtrlCharacters)
                     line.data += QChar(0x240A);
-                if (m_linebreakChar == '\n') {
-                    line.data += '\n';
-                }
-                Q_ASSERT(i != (inData.size()));
             } else if (b == '\t') {
                 if (m_displayCtrlCharacters)
                     line.data += QChar(0x21E5);
@@ -255,12 +432,13 @@ void DataDisplay::constructDisplayLine(const QByteArray &inData)
              *   abc0z plus all above (2-3) with leading abc and trailing z
              */
 
-            if (b == '\0') {
+            if (b == '\0' && breakLines) {
+                m_fold.foldable = false;
                 // Check if we have multiple zeros here -- concatenate them to a single printe
                 int nbreaks = 0;
 
-                for (int nbreaks_loop = i; nbreaks_loop < inData.size(); nbreaks_loop++) {
-                    if (inData.at(nbreaks_loop) != (int)b)
+                for (int nbreaks_loop = i; nbreaks_loop < len; nbreaks_loop++) {
+                    if (inData[nbreaks_loop] != (int)b)
                         break;
 
                     nbreaks += 1;
@@ -283,21 +461,241 @@ void DataDisplay::constructDisplayLine(const QByteArray &inData)
                     i += (nbreaks - 1);
                 }
 
-                if (i < (inData.size() - 1)) {
+                if (i < (len - 1)) {
                     // append line as there are trailing characters after the break
                     m_data.append(line);
                     line = DisplayLine();
                     m_timestamps->append(m_timestamp);
                 }
             } else {
-                line.data += QString("<0x%1>").arg(b & 0xff, 2, 16, QChar('0'));
+                appendInvalid(b);
             }
         }
     }
+    // a sequence does not continue on the next line
+    if (lineBreak)
+        m_utf8Decoder.flush(appendInvalid);
+    if (lineBreak && !line.data.endsWith('\n'))
+        line.data += '\n';
     if (!line.data.isEmpty()) {
         m_data.append(line);
         m_previous_ended_with_nl = line.data.endsWith('\n');
     }
+    if (fold && lineBreak)
+        foldLine();
+}
+
+/*!
+ * A line has been completed: if it repeats the line before, drop it
+ * and count it on the row of the line before instead.
+ * \brief DataDisplay::foldLine
+ */
+void DataDisplay::foldLine()
+{
+    const bool repeated = m_fold.foldable && m_fold.previousFoldable && m_fold.hash == m_fold.previousHash
+                          && m_fold.bytes == m_fold.previousBytes;
+    if (!repeated) {
+        m_fold.previousHash = m_fold.hash;
+        m_fold.previousBytes = m_fold.bytes;
+        m_fold.previousFoldable = m_fold.foldable;
+        m_fold.count = 1;
+        m_fold.first = m_fold.time;
+        m_fold.newRow = true;
+        return;
+    }
+
+    if (m_fold.dataIndex >= 0) {
+        while (m_data.size() > m_fold.dataIndex)
+            m_data.removeLast();
+    } else {
+        // the start of the line is shown already
+        m_data.clear();
+        m_fold.removePartialLine = true;
+    }
+    m_timestamps->resize(m_fold.timestampIndex);
+
+    m_fold.count++;
+    m_fold.last = m_fold.time;
+    m_fold.suffix = QString("  [x%1  %2 - %3]")
+                        .arg(m_fold.count)
+                        .arg(m_fold.first.toString(QStringLiteral("HH:mm:ss:zzz")))
+                        .arg(m_fold.last.toString(QStringLiteral("HH:mm:ss:zzz")));
+    if (m_catchingUp) {
+        // the rows are trimmed to the view before anything is shown, the
+        // counter goes with the row into the buffer
+        DisplayLine &row = m_data.last();
+        if (row.trailer.isEmpty())
+            row.data.chop(1);
+        row.trailer = m_fold.suffix + '\n';
+        return;
+    }
+
+    // the row taking the counter has to be in the document
+    if (!m_data.isEmpty())
+        displayDataFromBuffer();
+    m_fold.changed = true;
+
+    if (!m_bufferingIncomingDataTimer.isActive())
+        m_bufferingIncomingDataTimer.start(70);
+}
+
+/*!
+ * Stop changing the view, e.g. to read something while the device
+ * keeps sending. The data are still read, logged and passed to the
+ * plugins. When the display goes on, only the rows filling the view
+ * are shown, anything before is replaced by a note.
+ * \brief DataDisplay::setPaused
+ */
+void DataDisplay::setPaused(bool paused)
+{
+    m_pausedByUser = paused;
+    updatePaused();
+}
+
+/*!
+ * Nothing is rendered while the window cannot be seen, the data are
+ * kept like while paused.
+ * \brief DataDisplay::setSuspended
+ */
+void DataDisplay::setSuspended(bool suspended)
+{
+    m_suspended = suspended;
+    updatePaused();
+}
+
+void DataDisplay::updatePaused()
+{
+    const bool paused = m_pausedByUser || m_suspended;
+    if (paused == m_paused)
+        return;
+    if (paused) {
+        // what has been received until now is still shown
+        displayDataFromBuffer();
+        m_bufferingIncomingDataTimer.stop();
+        m_paused = true;
+    } else {
+        m_paused = false;
+        catchUp();
+    }
+}
+
+/*!
+ * Show the tail of the data received while paused. The rows are
+ * formatted and folded as usual, but only the ones filling the view
+ * are inserted into the document.
+ * \brief DataDisplay::catchUp
+ */
+void DataDisplay::catchUp()
+{
+    if (m_pausedReads.isEmpty())
+        return;
+
+    // the data before and after the pause are not continued on one row
+    closeRow();
+    terminateLine(QString());
+    m_linebreakMatcher.reset();
+    m_utf8Decoder.reset();
+    m_lineBytes = 0;
+    m_hexBytes = 0;
+    m_hexLeftOver.clear();
+    resetFold();
+
+    const int firstLine = m_data.size();
+    const int firstTimestamp = m_timestamps->size();
+    m_catchingUp = true;
+    foreach (const PausedRead &read, m_pausedReads) {
+        displayData(read.data, read.timestamp);
+    }
+    m_catchingUp = false;
+    m_pausedReads.clear();
+    m_pausedBytes = 0;
+    // rows started after formatting the paused data are compared again
+    resetFold();
+
+    // every row got a timestamp, the last one may be incomplete
+    int rows = 0;
+    for (int i = firstLine; i < m_data.size(); i++) {
+        const DisplayLine &line = m_data.at(i);
+        if (line.data.endsWith('\n') || line.trailer.endsWith('\n') || i == m_data.size() - 1)
+            rows++;
+    }
+    int skippedRows = rows - visibleRows();
+    QTime skippedSince = CaptureClock::toTime(m_skippedSince);
+    if (skippedRows > 0) {
+        if (!m_skipped)
+            skippedSince = m_timestamps->at(firstTimestamp);
+        m_skipped = true;
+        m_timestamps->remove(firstTimestamp, skippedRows);
+        while (skippedRows) {
+            const DisplayLine line = m_data.takeAt(firstLine);
+            if (line.data.endsWith('\n') || line.trailer.endsWith('\n'))
+                skippedRows--;
+        }
+    }
+    if (m_skipped) {
+        DisplayLine note;
+        note.data = QStringLiteral("<skipped while paused>\n");
+        m_data.insert(firstLine, note);
+        m_timestamps->insert(firstTimestamp, skippedSince);
+        m_skipped = false;
+    }
+
+    displayDataFromBuffer();
+    m_bufferingIncomingDataTimer.stop();
+    m_dataDisplay->verticalScrollBar()->setValue(m_dataDisplay->verticalScrollBar()->maximum());
+}
+
+/*!
+ * Number of text rows the view has room for
+ * \brief DataDisplay::visibleRows
+ */
+int DataDisplay::visibleRows() const
+{
+    const int lineSpacing = QFontMetrics(m_format_data->font()).lineSpacing();
+    return qMax(1, m_dataDisplay->viewport()->height() / qMax(1, lineSpacing) + 1);
+}
+
+/*!
+ * Start over with folding, the next line will not be
+ * compared with the lines before
+ * \brief DataDisplay::resetFold
+ */
+void DataDisplay::resetFold()
+{
+    m_fold.hash = 0;
+    m_fold.bytes = 0;
+    m_fold.foldable = false;
+    m_fold.dataIndex = -1;
+    m_fold.timestampIndex = 0;
+    m_fold.previousHash = 0;
+    m_fold.previousBytes = 0;
+    m_fold.previousFoldable = false;
+    m_fold.count = 0;
+}
+
+/*!
+ * Bring the document up to date with the folded lines: remove the start
+ * of a repeated line and redraw the counter of the last complete row
+ * \brief DataDisplay::displayFold
+ */
+void DataDisplay::displayFold()
+{
+    QTextCursor cursor(m_dataDisplay->document());
+    if (m_fold.removePartialLine) {
+        cursor.movePosition(QTextCursor::End);
+        cursor.movePosition(QTextCursor::StartOfBlock, QTextCursor::KeepAnchor);
+        cursor.removeSelectedText();
+        m_fold.removePartialLine = false;
+    }
+    if (m_fold.changed) {
+        cursor.movePosition(QTextCursor::End);
+        cursor.movePosition(QTextCursor::PreviousBlock);
+        cursor.movePosition(QTextCursor::EndOfBlock);
+        cursor.movePosition(QTextCursor::Left, QTextCursor::KeepAnchor, m_fold.suffixLength);
+        cursor.insertText(m_fold.suffix, *m_format_ascii);
+        m_fold.suffixLength = m_fold.suffix.length();
+        m_fold.changed = false;
+    }
 }
 
 void DataDisplay::setDisplayTime(bool displayTime) { m_dataDisplay->setDisplayTime(displayTime); }
@@ -308,6 +706,11 @@ void DataDisplay::setDisplayTime(bool displayTime) { m_dataDisplay->setDisplayTi
  */
 void DataDisplay::setDisplayHex(bool displayHex)
 {
+    // rows split by idle time are not continued in the other format
+    closeRow();
+    resetFold();
+    m_hexLeftOver.clear();
+    m_linebreakMatcher.reset();
     if (displayHex) {
         if (!m_previous_ended_with_nl) {
             displayData(QByteArray(1, '\n'));
@@ -338,12 +741,77 @@ void DataDisplay::setDisplayCtrlCharacters(bool displayCtrlCharacters)
     m_displayCtrlCharacters = displayCtrlCharacters;
 }
 
-void DataDisplay::setLinebreakChar(const QString &chars)
+/*!
+ * Decode the text as UTF-8 instead of Latin-1. Invalid bytes are
+ * shown as <0xNN> like other non printable bytes.
+ * \brief DataDisplay::setDecodeUtf8
+ */
+void DataDisplay::setDecodeUtf8(bool decodeUtf8)
 {
-    if (chars.size() > 0)
-        m_linebreakChar = chars.data()[chars.size() - 1].toLatin1();
-    else
-        m_linebreakChar = '\n';
+    m_decodeUtf8 = decodeUtf8;
+    m_utf8Decoder.reset();
+}
+
+/*!
+ * Show consecutive identical lines on one row, followed by the
+ * number of repeats and the times of the first and the last one.
+ * Applies to text lines split at the line break delimiters.
+ * \brief DataDisplay::setFoldRepeatedLines
+ */
+void DataDisplay::setFoldRepeatedLines(bool foldRepeatedLines)
+{
+    m_foldRepeatedLines = foldRepeatedLines;
+    resetFold();
+}
+
+/*!
+ * Set the delimiters at which the text output starts a new line.
+ * Several delimiters are separated by '|', each one may contain the
+ * escapes of PatternMatcher::fromEscaped(). A leading '^' anchors a
+ * delimiter to the start of a line, e.g. a prompt that ends the line
+ * only if nothing has been received in front of it.
+ * Examples: "\\r\\n", "\\n|\\r\\n> ", "^> "
+ * \brief DataDisplay::setLinebreak
+ * \param delimiters Falls back to "\\n" if no valid delimiter is given
+ */
+void DataDisplay::setLinebreak(const QString &delimiters)
+{
+    resetFold();
+    m_linebreakMatcher.clear();
+    m_linebreakAnchored.clear();
+    foreach (QString delimiter, delimiters.split('|')) {
+        const bool anchored = delimiter.startsWith('^');
+        if (anchored)
+            delimiter.remove(0, 1);
+        const int id = m_linebreakMatcher.addPattern(PatternMatcher::fromEscaped(delimiter));
+        if (id == m_linebreakAnchored.size())
+            m_linebreakAnchored.append(anchored);
+        else if (id >= 0)
+            m_linebreakAnchored[id] = m_linebreakAnchored.at(id) && anchored;
+    }
+    if (m_linebreakMatcher.isEmpty()) {
+        m_linebreakMatcher.addPattern(QByteArray(1, '\n'));
+        m_linebreakAnchored.append(false);
+    }
+    m_linebreakMatcher.build();
+}
+
+/*!
+ * Start a new row whenever the line has been idle for at least
+ * \a gap instead of breaking lines at the line break character.
+ * Meant for binary protocols without delimiters.
+ * \brief DataDisplay::setIdleGap
+ * \param gap Idle time in ns, 0 breaks lines at the line break character again
+ * \param characterTime Time to transmit one character in ns
+ */
+void DataDisplay::setIdleGap(qint64 gap, qint64 characterTime)
+{
+    if (!gap)
+        closeRow();
+    if (gap != m_idleGap)
+        resetFold();
+    m_idleGap = gap;
+    m_characterTime = characterTime;
 }
 
 QTextDocument *DataDisplay::getTextDocument() { return m_dataDisplay->document(); }
@@ -418,6 +886,57 @@ void DataDisplay::insertSpaces(QString &data, unsigned int step)
     }
 }
 
+/*!
+ * Printable representation of the bytes for the ASCII column
+ * of the hex view, control characters are shown as symbols
+ * \brief DataDisplay::asciiColumn
+ */
+QString DataDisplay::asciiColumn(const QByteArray &data)
+{
+    QString asciiText;
+    asciiText.reserve(data.size() + 3);
+    for (char c : data) {
+        unsigned int b = static_cast<uchar>(c);
+        if (b < 0x20) {
+            b += 0x2400;
+        } else if (0x7F <= b) {
+            b = '.';
+        }
+        asciiText += QChar(b);
+    }
+    return asciiText;
+}
+
+/*!
+ * Show a complete frame, e.g. from a protocol decoder, on a row of its
+ * own: length, hex bytes and the ASCII column. Meant for displays
+ * that show frames only and have hex display enabled.
+ * \brief DataDisplay::displayFrame
+ * \param frame The frame
+ * \param time The time the frame has been received
+ */
+void DataDisplay::displayFrame(const QByteArray &frame, const QTime &time)
+{
+    if (m_data.isEmpty())
+        m_redisplay = false;
+    resetFold();
+
+    QString hex = QString(frame.toHex());
+    if (!hex.isEmpty())
+        insertSpaces(hex, 2);
+
+    DisplayLine line;
+    line.data = QString("%1  %2  ").arg(frame.size(), 5).arg(hex);
+    line.trailer = asciiColumn(frame);
+    line.trailer.append('\n');
+    m_timestamps->append(time);
+    m_data.append(line);
+    m_previous_ended_with_nl = true;
+
+    if (!m_bufferingIncomingDataTimer.isActive())
+        m_bufferingIncomingDataTimer.start(70);
+}
+
 /*!
  * \brief OutputTerminal::formatHexData
  * \param inData
@@ -451,34 +970,18 @@ bool DataDisplay::formatHexData(const QByteArray &inData)
     while (pos < data.size()) {
         junk = data.mid(pos, 16);
         junkSize = junk.size();
-        QString hexJunk = QString(junk.toHex());
-        QString asciiText;
-        for (char c : junk) {
-            unsigned int b = c;
-            if (b < 0x20) {
-                b += 0x2400;
-            } else if (0x7F <= b) {
-                b = '.';
-            }
-            asciiText += QChar(b);
-        }
+        DisplayLine line = formatHexLine(junk, m_hexBytes);
         if (junkSize == 16)
-            asciiText.append('\n');
-        insertSpaces(hexJunk, 2);
-        if (asciiText.size() > 8)
-            asciiText.insert(8, QStringLiteral("  "));
-
-        DisplayLine line;
-        line.data = QString("%1 %2\t").arg(m_hexBytes, 8, 10, QChar('0')).arg(hexJunk, -50);
-        line.trailer = QString(asciiText);
+            line.trailer.append('\n');
         if (!redisplay || pos > 0)
             m_timestamps->append(m_timestamp);
         m_data.append(line);
         pos += 16;
         m_hexBytes += junk.size();
     }
+    // kept even if complete, rows split by idle time redraw their last line
+    m_hexLeftOver = junk;
     if (junkSize < 16) {
-        m_hexLeftOver = junk;
         m_previous_ended_with_nl = false;
     } else {
         m_previous_ended_with_nl = true;
@@ -487,6 +990,25 @@ bool DataDisplay::formatHexData(const QByteArray &inData)
     return redisplay;
 }
 
+/*!
+ * One line of the hex view: offset, up to 16 hex bytes and the
+ * ASCII column, without line break
+ * \brief DataDisplay::formatHexLine
+ */
+DataDisplay::DisplayLine DataDisplay::formatHexLine(const QByteArray &junk, quint64 offset)
+{
+    QString hexJunk = QString(junk.toHex());
+    QString asciiText = asciiColumn(junk);
+    insertSpaces(hexJunk, 2);
+    if (asciiText.size() > 8)
+        asciiText.insert(8, QStringLiteral("  "));
+
+    DisplayLine line;
+    line.data = QString("%1 %2\t").arg(offset, 8, 10, QChar('0')).arg(hexJunk, -50);
+    line.trailer = asciiText;
+    return line;
+}
+
 /* ****************************************************************************************************
  *
  *                  P R I V A T E
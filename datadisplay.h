@@ -22,6 +22,9 @@
 #ifndef DATADISPLAY_H
 #define DATADISPLAY_H
 
+#include "patternmatcher.h"
+#include "utf8decoder.h"
+
 #include <QPlainTextEdit>
 #include <QTime>
 #include <QTimer>
@@ -41,6 +44,45 @@ class DataDisplay : public QWidget
         QString trailer;
     };
 
+    /* data read while the display is paused */
+    struct PausedRead {
+        QByteArray data;
+        qint64 timestamp;
+    };
+
+    /* folding of consecutive identical lines into one row */
+    struct LineFold {
+        /* hash and length of the current line so far */
+        quint64 hash;
+        qint64 bytes;
+        /* the line started on a row of its own and has no <break>s */
+        bool foldable;
+        /* first entry of the current line in m_data, -1 if it started
+         * before the last flush and is partly in the document already */
+        int dataIndex;
+        /* size of m_timestamps before the current line */
+        int timestampIndex;
+        QTime time;
+
+        /* the last complete line, the row the repeats are folded into */
+        quint64 previousHash;
+        qint64 previousBytes;
+        bool previousFoldable;
+        quint64 count;
+        QTime first;
+        QTime last;
+
+        QString suffix;
+        /* the counter of the row needs to be redrawn */
+        bool changed;
+        /* the last complete line is not in the document yet */
+        bool newRow;
+        /* characters of the counter shown at the end of the row */
+        int suffixLength;
+        /* remove the start of a repeated line from the document */
+        bool removePartialLine;
+    };
+
 public:
     explicit DataDisplay(QWidget *parent = 0);
 
@@ -54,13 +96,27 @@ public:
 
     void displayData(const QByteArray &data);
 
+    void displayData(const QByteArray &data, qint64 timestamp);
+
+    void displayFrame(const QByteArray &frame, const QTime &time);
+
     void setDisplayTime(bool displayTime);
 
     void setDisplayHex(bool displayHex);
 
     void setDisplayCtrlCharacters(bool displayCtrlCharacters);
 
-    void setLinebreakChar(const QString &chars);
+    void setDecodeUtf8(bool decodeUtf8);
+
+    void setFoldRepeatedLines(bool foldRepeatedLines);
+
+    void setPaused(bool paused);
+
+    void setSuspended(bool suspended);
+
+    void setLinebreak(const QString &delimiters);
+
+    void setIdleGap(qint64 gap, qint64 characterTime);
 
     QTextDocument *getTextDocument();
 
@@ -68,7 +124,18 @@ private:
     void find(const QString &, QTextDocument::FindFlags);
     void insertSpaces(QString &data, unsigned int step = 1);
     bool formatHexData(const QByteArray &inData);
-    void constructDisplayLine(const QByteArray &inData);
+    DisplayLine formatHexLine(const QByteArray &junk, quint64 offset);
+    void displayIdleGapData(const QByteArray &data, qint64 timestamp);
+    void closeRow();
+    void terminateLine(const QString &suffix);
+    static QString asciiColumn(const QByteArray &data);
+    void constructDisplayLine(const char *inData, int len, bool lineBreak);
+    void foldLine();
+    void resetFold();
+    void displayFold();
+    void updatePaused();
+    void catchUp();
+    int visibleRows() const;
     void setupTextFormats();
 
     DataDisplayPrivate *m_dataDisplay;
@@ -110,9 +177,85 @@ private:
     bool m_displayCtrlCharacters;
 
     /**
-     * defines characters at which a new line is generated.
+     * The text is decoded as UTF-8 instead of Latin-1
+     * @brief m_decodeUtf8
+     */
+    bool m_decodeUtf8;
+    Utf8Decoder m_utf8Decoder;
+
+    /**
+     * The delimiters at which a new line is generated, compiled into
+     * one automaton so the data are scanned only once. Its state carries
+     * delimiters straddling two reads over.
+     * @brief m_linebreakMatcher
+     */
+    PatternMatcher m_linebreakMatcher;
+
+    /**
+     * For each delimiter of m_linebreakMatcher: it only counts
+     * at the start of a line
+     * @brief m_linebreakAnchored
+     */
+    QVector<bool> m_linebreakAnchored;
+
+    /**
+     * Consecutive identical lines are shown once with a repeat counter
+     * @brief m_foldRepeatedLines
+     */
+    bool m_foldRepeatedLines;
+    LineFold m_fold;
+
+    /**
+     * While paused the data are only kept, the view does not change.
+     * Only the tail of at most PAUSE_BUFFER_SIZE bytes is kept, it is
+     * all that is needed to fill the view once the display goes on.
+     * The display is paused by the user or suspended while the
+     * window is minimized.
+     * @brief m_paused
+     */
+    bool m_paused;
+    bool m_pausedByUser;
+    bool m_suspended;
+    enum { PAUSE_BUFFER_SIZE = 256 * 1024 };
+    QList<PausedRead> m_pausedReads;
+    qint64 m_pausedBytes;
+    /* data have been dropped from m_pausedReads, the first one at m_skippedSince */
+    bool m_skipped;
+    qint64 m_skippedSince;
+    /* the paused data are being formatted */
+    bool m_catchingUp;
+
+    /**
+     * Number of bytes of the current text line
+     * @brief m_lineBytes
+     */
+    qint64 m_lineBytes;
+
+    /**
+     * If set, a new row is started whenever the line has been idle
+     * this long (ns) instead of breaking lines at the delimiters
+     * @brief m_idleGap
+     */
+    qint64 m_idleGap;
+
+    /**
+     * Time to transmit one character in ns
+     * @brief m_characterTime
+     */
+    qint64 m_characterTime;
+
+    /**
+     * CaptureClock time of the last read
+     * @brief m_lastRead
+     */
+    qint64 m_lastRead;
+
+    /**
+     * Number of bytes in the current row, 0 if the
+     * next data start a new row
+     * @brief m_rowBytes
      */
-    char m_linebreakChar;
+    quint64 m_rowBytes;
 
     /**
      * The container to store multiple formated
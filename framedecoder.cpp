@@ -0,0 +1,137 @@
+/*
+ * Copyright (c) 2026 CuteCom contributors
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 675 Mass Ave, Cambridge, MA 02139, USA.
+ *
+ * For more information on the GPL, please go to:
+ * http://www.gnu.org/copyleft/gpl.html
+ */
+
+#include "framedecoder.h"
+#include <QStringList>
+
+bool FrameDecoder::LengthRule::parse(const QString &text)
+{
+    LengthRule rule;
+    const QStringList fields = text.split(',');
+    bool ok = true;
+    if (fields.size() > 4)
+        return false;
+    if (fields.size() > 0 && ok)
+        rule.offset = fields.at(0).trimmed().toInt(&ok);
+    if (fields.size() > 1 && ok)
+        rule.size = fields.at(1).trimmed().toInt(&ok);
+    if (fields.size() > 2 && ok) {
+        const QString endian = fields.at(2).trimmed().toLower();
+        ok = endian == QLatin1String("be") || endian == QLatin1String("le");
+        rule.bigEndian = endian == QLatin1String("be");
+    }
+    if (fields.size() > 3 && ok)
+        rule.adjust = fields.at(3).trimmed().toInt(&ok);
+    if (!ok || rule.offset < 0 || (rule.size != 1 && rule.size != 2 && rule.size != 4))
+        return false;
+    *this = rule;
+    return true;
+}
+
+QString FrameDecoder::LengthRule::toString() const
+{
+    return QString("%1,%2,%3,%4").arg(offset).arg(size).arg(bigEndian ? "be" : "le").arg(adjust);
+}
+
+FrameDecoder::FrameDecoder()
+    : m_mode(SLIP)
+    , m_maxFrameSize(64 * 1024)
+    , m_frames(0)
+    , m_errors(0)
+{
+    setDelimiter(QByteArray(1, '\n'));
+    reset();
+}
+
+void FrameDecoder::setMode(Mode mode)
+{
+    m_mode = mode;
+    reset();
+}
+
+void FrameDecoder::setLengthRule(const LengthRule &rule)
+{
+    m_rule = rule;
+    reset();
+}
+
+void FrameDecoder::setDelimiter(const QByteArray &delimiter)
+{
+    if (delimiter.isEmpty())
+        return;
+    m_delimiter = delimiter;
+    m_delimiterMatcher.clear();
+    m_delimiterMatcher.addPattern(delimiter);
+    m_delimiterMatcher.build();
+    reset();
+}
+
+void FrameDecoder::reset()
+{
+    m_frame.resize(0);
+    m_discard = false;
+    m_escape = false;
+    m_cobsLeft = 0;
+    m_cobsZero = false;
+    m_length = -1;
+    m_skip = 0;
+    m_delimiterMatcher.reset();
+}
+
+/**
+ * @brief Add decoded bytes to the current frame. A frame that grows
+ *  beyond the maximum size is dropped.
+ */
+void FrameDecoder::append(const char *data, int len)
+{
+    if (m_discard || !len)
+        return;
+    if (m_frame.size() + len > m_maxFrameSize) {
+        dropFrame();
+        return;
+    }
+    m_frame.append(data, len);
+}
+
+/**
+ * @brief Count the current frame as error and ignore the rest of it
+ */
+void FrameDecoder::dropFrame()
+{
+    if (!m_discard)
+        m_errors++;
+    m_discard = true;
+    m_frame.resize(0);
+}
+
+/**
+ * @brief Total length of the frame, the header must be complete
+ */
+qint64 FrameDecoder::frameLength() const
+{
+    const uchar *field = reinterpret_cast<const uchar *>(m_frame.constData()) + m_rule.offset;
+    quint64 value = 0;
+    for (int i = 0; i < m_rule.size; i++) {
+        const int byte = m_rule.bigEndian ? i : m_rule.size - 1 - i;
+        value = (value << 8) | field[byte];
+    }
+    return m_rule.offset + m_rule.size + static_cast<qint64>(value) + m_rule.adjust;
+}
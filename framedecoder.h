@@ -0,0 +1,262 @@
+/*
+ * Copyright (c) 2026 CuteCom contributors
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 675 Mass Ave, Cambridge, MA 02139, USA.
+ *
+ * For more information on the GPL, please go to:
+ * http://www.gnu.org/copyleft/gpl.html
+ */
+
+/**
+ * Incremental frame decoder for binary protocols. The received data are
+ * fed chunk by chunk and every complete frame is handed to a callback;
+ * a partial frame is kept until its end arrives, so no byte is looked at
+ * twice. Supported framings:
+ *
+ *  - SLIP (RFC 1055): frames end with 0xC0, 0xDB escapes 0xC0/0xDB
+ *  - COBS: frames are COBS encoded and end with 0x00
+ *  - length prefix: a header at a fixed offset holds the length of the
+ *    frame, see LengthRule
+ *  - delimiter: frames end with an arbitrary byte sequence
+ *
+ * The frames are passed without the framing bytes, except for the header of
+ * length prefixed frames, which is part of the frame. Frames exceeding
+ * maxFrameSize() or broken encodings are counted as errors and dropped.
+ */
+
+#ifndef FRAMEDECODER_H
+#define FRAMEDECODER_H
+
+#include "patternmatcher.h"
+#include <QByteArray>
+#include <QString>
+
+class FrameDecoder
+{
+public:
+    enum Mode { SLIP, COBS, LENGTH_PREFIX, DELIMITER };
+
+    struct LengthRule {
+        LengthRule()
+            : offset(0)
+            , size(1)
+            , bigEndian(true)
+            , adjust(0)
+        {
+        }
+        /* position of the length field from the start of the frame */
+        int offset;
+        /* size of the length field: 1, 2 or 4 bytes */
+        int size;
+        bool bigEndian;
+        /* frame length = offset + size + field value + adjust */
+        int adjust;
+
+        /**
+         * @brief Parse "offset,size,be|le,adjust", trailing fields may be omitted
+         * @return false if the text is not a valid rule
+         */
+        bool parse(const QString &text);
+        QString toString() const;
+    };
+
+    FrameDecoder();
+
+    void setMode(Mode mode);
+    Mode mode() const { return m_mode; }
+    void setLengthRule(const LengthRule &rule);
+    void setDelimiter(const QByteArray &delimiter);
+    void setMaxFrameSize(int size) { m_maxFrameSize = size; }
+    int maxFrameSize() const { return m_maxFrameSize; }
+
+    /**
+     * @brief Drop a partial frame and start over
+     */
+    void reset();
+
+    quint64 frames() const { return m_frames; }
+    quint64 errors() const { return m_errors; }
+
+    /**
+     * @brief Decode the next chunk of the stream
+     * @param onFrame Called as onFrame(const QByteArray &frame) for every complete frame
+     */
+    template <typename Callback> void feed(const char *data, int len, Callback onFrame);
+
+private:
+    enum {
+        SLIP_END = 0xc0,
+        SLIP_ESC = 0xdb,
+        SLIP_ESC_END = 0xdc,
+        SLIP_ESC_ESC = 0xdd,
+    };
+
+    template <typename Callback> void emitFrame(Callback &onFrame);
+    void append(const char *data, int len);
+    void dropFrame();
+    qint64 frameLength() const;
+
+    Mode m_mode;
+    LengthRule m_rule;
+    QByteArray m_delimiter;
+    PatternMatcher m_delimiterMatcher;
+    int m_maxFrameSize;
+
+    QByteArray m_frame;
+    /* the frame is broken, skip until its end */
+    bool m_discard;
+    /* SLIP: the last byte was an escape */
+    bool m_escape;
+    /* COBS: bytes left in the current block, 0 if the next byte is a code */
+    int m_cobsLeft;
+    /* COBS: the current block ends with an implicit zero */
+    bool m_cobsZero;
+    /* length prefix: length of the frame once the header is complete, -1 before */
+    int m_length;
+    /* length prefix: bytes of an oversized frame still to skip */
+    qint64 m_skip;
+
+    quint64 m_frames;
+    quint64 m_errors;
+};
+
+template <typename Callback> void FrameDecoder::emitFrame(Callback &onFrame)
+{
+    if (m_discard) {
+        m_discard = false;
+    } else {
+        m_frames++;
+        onFrame(m_frame);
+    }
+    m_frame.resize(0);
+}
+
+template <typename Callback> void FrameDecoder::feed(const char *data, int len, Callback onFrame)
+{
+    const uchar *p = reinterpret_cast<const uchar *>(data);
+    int i = 0;
+
+    switch (m_mode) {
+    case SLIP:
+        while (i < len) {
+            if (m_escape) {
+                m_escape = false;
+                if (p[i] == SLIP_ESC_END)
+                    append("\xc0", 1);
+                else if (p[i] == SLIP_ESC_ESC)
+                    append("\xdb", 1);
+                else
+                    dropFrame();
+                i++;
+                continue;
+            }
+            // copy the run up to the next special byte at once
+            int run = i;
+            while (run < len && p[run] != SLIP_END && p[run] != SLIP_ESC)
+                run++;
+            append(data + i, run - i);
+            if (run == len)
+                break;
+            if (p[run] == SLIP_ESC) {
+                m_escape = true;
+            } else if (!m_frame.isEmpty() || m_discard) {
+                // several END in a row are no empty frames
+                emitFrame(onFrame);
+            }
+            i = run + 1;
+        }
+        break;
+    case COBS:
+        while (i < len) {
+            const uchar b = p[i];
+            if (b == 0) {
+                if (m_cobsLeft)
+                    dropFrame();
+                if (!m_frame.isEmpty() || m_discard)
+                    emitFrame(onFrame);
+                m_cobsLeft = 0;
+                m_cobsZero = false;
+                i++;
+            } else if (!m_cobsLeft) {
+                // code byte, the zero of the previous block goes in between
+                if (m_cobsZero)
+                    append("", 1);
+                m_cobsLeft = b - 1;
+                m_cobsZero = b != 0xff;
+                i++;
+            } else {
+                int run = i;
+                const int end = qMin(len, i + m_cobsLeft);
+                while (run < end && p[run])
+                    run++;
+                append(data + i, run - i);
+                m_cobsLeft -= run - i;
+                i = run;
+            }
+        }
+        break;
+    case LENGTH_PREFIX:
+        while (i < len) {
+            if (m_skip) {
+                // the rest of an oversized frame
+                const int take = static_cast<int>(qMin<qint64>(m_skip, len - i));
+                m_skip -= take;
+                i += take;
+                continue;
+            }
+            const int header = m_rule.offset + m_rule.size;
+            const int target = m_length < 0 ? header : m_length;
+            const int take = qMin(target - m_frame.size(), len - i);
+            m_frame.append(data + i, take);
+            i += take;
+            if (m_frame.size() < target)
+                break;
+            if (m_length < 0) {
+                const qint64 length = frameLength();
+                if (length < header) {
+                    // garbage, resynchronize at the next byte
+                    m_errors++;
+                    m_frame.remove(0, 1);
+                    continue;
+                }
+                if (length > m_maxFrameSize) {
+                    m_errors++;
+                    m_skip = length - m_frame.size();
+                    m_frame.resize(0);
+                    continue;
+                }
+                m_length = static_cast<int>(length);
+                if (m_frame.size() < m_length)
+                    continue;
+            }
+            m_length = -1;
+            emitFrame(onFrame);
+        }
+        break;
+    case DELIMITER:
+        m_delimiterMatcher.feed(data, len, [&](int, int end) {
+            append(data + i, end + 1 - i);
+            m_frame.chop(m_delimiter.size());
+            i = end + 1;
+            if (!m_frame.isEmpty() || m_discard)
+                emitFrame(onFrame);
+            return true;
+        });
+        append(data + i, len - i);
+        break;
+    }
+}
+
+#endif // FRAMEDECODER_H
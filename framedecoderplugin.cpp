@@ -0,0 +1,186 @@
+/*
+ * Copyright (c) 2026 CuteCom contributors
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 675 Mass Ave, Cambridge, MA 02139, USA.
+ *
+ * For more information on the GPL, please go to:
+ * http://www.gnu.org/copyleft/gpl.html
+ */
+
+#include "framedecoderplugin.h"
+#include "captureclock.h"
+#include "ui_framedecoderplugin.h"
+#include <QMessageBox>
+#include <QMutexLocker>
+
+#define TRACE                                                                                                          \
+    if (!debug) {                                                                                                      \
+    } else                                                                                                             \
+        qDebug()
+
+static bool debug = false;
+
+FrameDecoderPlugin::FrameDecoderPlugin(QFrame *parent, Settings *settings)
+    : QFrame(parent)
+    , ui(new Ui::FrameDecoderPlugin)
+    , m_settings(settings)
+    , m_delimiter(1, '\n')
+{
+    ui->setupUi(this);
+    /* Has QFrame, no injection, decodes on the worker pool. Frames must not get torn apart, so no drops */
+    m_plugin = new Plugin(this, "Frame decoder", this);
+    m_plugin->processRx = &FrameDecoderPlugin::processRx;
+    m_plugin->rxAffinity = Plugin::RX_WORKER;
+
+    ui->m_combo_mode->addItem(tr("SLIP"), FrameDecoder::SLIP);
+    ui->m_combo_mode->addItem(tr("COBS"), FrameDecoder::COBS);
+    ui->m_combo_mode->addItem(tr("Length prefix"), FrameDecoder::LENGTH_PREFIX);
+    ui->m_combo_mode->addItem(tr("Delimiter"), FrameDecoder::DELIMITER);
+    ui->m_display->setReadOnly(true);
+    ui->m_display->setUndoRedoEnabled(false);
+    ui->m_display->setDisplayHex(true);
+    modeChanged(0);
+
+    connect(ui->m_bt_unload, &QPushButton::clicked, this, &FrameDecoderPlugin::removePlugin);
+    connect(ui->m_bt_help, &QPushButton::clicked, this, &FrameDecoderPlugin::helpMsg);
+    connect(ui->m_bt_clear, &QPushButton::clicked, this, [=]() {
+        ui->m_display->clear();
+        QMutexLocker lock(&m_decoderMutex);
+        m_decoder = FrameDecoder();
+        m_decoder.setMode(static_cast<FrameDecoder::Mode>(ui->m_combo_mode->currentData().toInt()));
+        m_decoder.setDelimiter(m_delimiter);
+        m_decoder.setLengthRule(m_lengthRule);
+        lock.unlock();
+        updateStatistics();
+    });
+    connect(ui->m_combo_mode, static_cast<void (QComboBox::*)(int)>(&QComboBox::currentIndexChanged), this,
+            &FrameDecoderPlugin::modeChanged);
+    connect(ui->m_edit_parameter, &QLineEdit::editingFinished, this, &FrameDecoderPlugin::parameterChanged);
+    /* queued, the frames are emitted from the worker pool */
+    connect(this, &FrameDecoderPlugin::framesDecoded, this, &FrameDecoderPlugin::displayFrames, Qt::QueuedConnection);
+
+    TRACE << "[FrameDecoderPlugin::FrameDecoderPlugin]";
+}
+
+FrameDecoderPlugin::~FrameDecoderPlugin() { delete ui; }
+
+/**
+ * @brief Called by the plugin manager on the worker pool with the
+ *  received data. The frames of a chunk are handed to the GUI at once.
+ */
+void FrameDecoderPlugin::processRx(QObject *owner, const QByteArray &data, qint64 timestamp)
+{
+    FrameDecoderPlugin *self = static_cast<FrameDecoderPlugin *>(owner);
+    QByteArrayList frames;
+    {
+        QMutexLocker lock(&self->m_decoderMutex);
+        self->m_decoder.feed(data.constData(), data.size(), [&](const QByteArray &frame) { frames.append(frame); });
+    }
+    if (!frames.isEmpty())
+        emit self->framesDecoded(frames, timestamp);
+}
+
+void FrameDecoderPlugin::displayFrames(QByteArrayList frames, qint64 timestamp)
+{
+    const QTime time = CaptureClock::toTime(timestamp);
+    foreach (const QByteArray &frame, frames) {
+        ui->m_display->displayFrame(frame, time);
+    }
+    updateStatistics();
+}
+
+void FrameDecoderPlugin::updateStatistics()
+{
+    QMutexLocker lock(&m_decoderMutex);
+    ui->m_lbl_statistics->setText(tr("%1 frames\n%2 errors").arg(m_decoder.frames()).arg(m_decoder.errors()));
+}
+
+void FrameDecoderPlugin::modeChanged(int index)
+{
+    const FrameDecoder::Mode mode = static_cast<FrameDecoder::Mode>(ui->m_combo_mode->itemData(index).toInt());
+    ui->m_edit_parameter->blockSignals(true);
+    if (mode == FrameDecoder::DELIMITER) {
+        ui->m_edit_parameter->setEnabled(true);
+        ui->m_edit_parameter->setText(PatternMatcher::toEscaped(m_delimiter));
+    } else if (mode == FrameDecoder::LENGTH_PREFIX) {
+        ui->m_edit_parameter->setEnabled(true);
+        ui->m_edit_parameter->setText(m_lengthRule.toString());
+    } else {
+        ui->m_edit_parameter->setEnabled(false);
+        ui->m_edit_parameter->clear();
+    }
+    ui->m_edit_parameter->blockSignals(false);
+
+    QMutexLocker lock(&m_decoderMutex);
+    m_decoder.setMode(mode);
+}
+
+void FrameDecoderPlugin::parameterChanged()
+{
+    const FrameDecoder::Mode mode = static_cast<FrameDecoder::Mode>(ui->m_combo_mode->currentData().toInt());
+    if (mode == FrameDecoder::DELIMITER) {
+        QByteArray delimiter = PatternMatcher::fromEscaped(ui->m_edit_parameter->text());
+        if (delimiter.isEmpty()) {
+            QMessageBox::warning(this, tr("Invalid delimiter"), tr("The delimiter must not be empty"));
+            return;
+        }
+        m_delimiter = delimiter;
+        QMutexLocker lock(&m_decoderMutex);
+        m_decoder.setDelimiter(m_delimiter);
+    } else if (mode == FrameDecoder::LENGTH_PREFIX) {
+        FrameDecoder::LengthRule rule;
+        if (!rule.parse(ui->m_edit_parameter->text())) {
+            QMessageBox::warning(this, tr("Invalid length rule"),
+                                 tr("Expected 'offset,size,be|le,adjust' with a size of 1, 2 or 4"));
+            return;
+        }
+        m_lengthRule = rule;
+        QMutexLocker lock(&m_decoderMutex);
+        m_decoder.setLengthRule(m_lengthRule);
+    }
+}
+
+/**
+ * @brief Return a pointer to the plugin data
+ * @return
+ */
+const Plugin *FrameDecoderPlugin::plugin() { return m_plugin; }
+
+/**
+ * @brief [SLOT] Send unload command to the plugin manager
+ */
+void FrameDecoderPlugin::removePlugin(bool) { emit unload(m_plugin); }
+
+/**
+ * @brief Help message for the frame decoder plugin
+ */
+void FrameDecoderPlugin::helpMsg(void)
+{
+    QString help_str = tr("This plugin splits the received data into the frames\n"
+                          "of a binary protocol and shows one frame per row with\n"
+                          "its length, the hex bytes and the ASCII characters.\n\n"
+                          "Supported framings:\n"
+                          "  SLIP: frames end with 0xC0\n"
+                          "  COBS: COBS encoded frames end with 0x00\n"
+                          "  Length prefix: 'offset,size,be|le,adjust' describes\n"
+                          "    the length field, the frame is offset + size +\n"
+                          "    length + adjust bytes long, e.g. '1,2,be,2' for\n"
+                          "    an address byte, a 16 bit length and a CRC\n"
+                          "  Delimiter: frames end with the given bytes,\n"
+                          "    escapes are \\r \\n \\t \\0 \\\\ and \\xNN\n\n"
+                          "Broken or oversized frames are counted as errors.\n");
+
+    QMessageBox::information(this, tr("How to use the frame decoder"), help_str);
+}
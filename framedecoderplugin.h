@@ -0,0 +1,79 @@
+/*
+ * Copyright (c) 2026 CuteCom contributors
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 675 Mass Ave, Cambridge, MA 02139, USA.
+ *
+ * For more information on the GPL, please go to:
+ * http://www.gnu.org/copyleft/gpl.html
+ */
+
+#ifndef FRAMEDECODERPLUGIN_H
+#define FRAMEDECODERPLUGIN_H
+
+#include "framedecoder.h"
+#include "plugin.h"
+#include "settings.h"
+#include <QByteArrayList>
+#include <QDebug>
+#include <QFrame>
+#include <QMutex>
+
+namespace Ui
+{
+class FrameDecoderPlugin;
+}
+
+class FrameDecoderPlugin : public QFrame
+{
+    Q_OBJECT
+
+public:
+    explicit FrameDecoderPlugin(QFrame *parent, Settings *settings);
+    ~FrameDecoderPlugin();
+    const Plugin *plugin();
+
+signals:
+    void unload(Plugin *);
+    /* decoder (worker thread) -> display */
+    void framesDecoded(QByteArrayList frames, qint64 timestamp);
+
+public slots:
+    void removePlugin(bool);
+    void helpMsg(void);
+
+private slots:
+    void modeChanged(int index);
+    void parameterChanged();
+    void displayFrames(QByteArrayList frames, qint64 timestamp);
+
+private:
+    static void processRx(QObject *owner, const QByteArray &data, qint64 timestamp);
+    void updateStatistics();
+
+    Ui::FrameDecoderPlugin *ui;
+    Plugin *m_plugin;
+    Settings *m_settings;
+    /**
+     * The decoder runs on the worker pool, the GUI only
+     * touches it to change the configuration
+     * @brief m_decoderMutex
+     */
+    QMutex m_decoderMutex;
+    FrameDecoder m_decoder;
+    QByteArray m_delimiter;
+    FrameDecoder::LengthRule m_lengthRule;
+};
+
+#endif // FRAMEDECODERPLUGIN_H
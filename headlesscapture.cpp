@@ -0,0 +1,346 @@
+/*
+ * Copyright (c) 2026 CuteCom contributors
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 675 Mass Ave, Cambridge, MA 02139, USA.
+ *
+ * For more information on the GPL, please go to:
+ * http://www.gnu.org/copyleft/gpl.html
+ */
+
+#include "headlesscapture.h"
+#include "captureclock.h"
+
+#include <QCoreApplication>
+#include <QDir>
+#include <QFileInfo>
+#include <QRegularExpression>
+#include <QSocketNotifier>
+#include <QTextStream>
+
+#ifdef Q_OS_UNIX
+#include <signal.h>
+#include <sys/socket.h>
+#include <unistd.h>
+#endif
+
+#include <limits>
+
+int HeadlessCapture::s_signalFd[2] = {-1, -1};
+
+HeadlessCapture::HeadlessCapture(QObject *parent)
+    : QObject(parent)
+    , m_settings(new Settings(this))
+    , m_triggered(false)
+    , m_triggerTime(0)
+    , m_captureFiles(0)
+    , m_started(0)
+    , m_maxRead(0)
+    , m_errors(0)
+    , m_stopped(false)
+    , m_signalNotifier(nullptr)
+{
+    connect(&m_device, &QSerialPort::readyRead, this, &HeadlessCapture::readData);
+    connect(&m_device,
+            static_cast<void (QSerialPort::*)(QSerialPort::SerialPortError serialPortError)>(&QSerialPort::error),
+            this, &HeadlessCapture::handleError);
+
+    m_postTriggerTimer.setSingleShot(true);
+    connect(&m_postTriggerTimer, &QTimer::timeout, this, &HeadlessCapture::dumpTrigger);
+    m_durationTimer.setSingleShot(true);
+    connect(&m_durationTimer, &QTimer::timeout, this, [=]() { stop(0); });
+    connect(&m_sampleTimer, &QTimer::timeout, this, [=]() { m_meter.sample(CaptureClock::nsecsElapsed()); });
+}
+
+HeadlessCapture::~HeadlessCapture()
+{
+#ifdef Q_OS_UNIX
+    if (m_signalNotifier) {
+        ::signal(SIGINT, SIG_DFL);
+        ::signal(SIGTERM, SIG_DFL);
+        ::close(s_signalFd[0]);
+        ::close(s_signalFd[1]);
+        s_signalFd[0] = s_signalFd[1] = -1;
+    }
+#endif
+}
+
+qint64 HeadlessCapture::parseDuration(const QString &text)
+{
+    static const QRegularExpression part(QStringLiteral("(\\d+)(ms|h|m|s)?"));
+    const QString duration = text.trimmed().toLower();
+    if (duration.isEmpty())
+        return -1;
+
+    qint64 msecs = 0;
+    int pos = 0;
+    QRegularExpressionMatchIterator it = part.globalMatch(duration);
+    while (it.hasNext()) {
+        QRegularExpressionMatch match = it.next();
+        if (match.capturedStart() != pos)
+            return -1;
+        pos = match.capturedEnd();
+        const qint64 value = match.captured(1).toLongLong();
+        const QString unit = match.captured(2);
+        if (unit == QLatin1String("ms"))
+            msecs += value;
+        else if (unit == QLatin1String("m"))
+            msecs += value * 60 * 1000;
+        else if (unit == QLatin1String("h"))
+            msecs += value * 60 * 60 * 1000;
+        else
+            msecs += value * 1000;
+    }
+    return pos == duration.size() ? msecs : -1;
+}
+
+bool HeadlessCapture::start(const Options &options)
+{
+    QTextStream err(stderr);
+    m_options = options;
+
+    if (!options.session.isEmpty() && !m_settings->getSessionNames().contains(options.session)) {
+        err << tr("Unknown session %1").arg(options.session) << endl;
+        return false;
+    }
+    m_settings->readSettings(options.session);
+    Settings::Session session = m_settings->getCurrentSession();
+    if (!options.device.isEmpty())
+        session.device = options.device;
+    if (session.device.isEmpty()) {
+        err << tr("No device has been specified in session %1").arg(m_settings->getCurrentSessionName()) << endl;
+        return false;
+    }
+    if (options.duration > std::numeric_limits<int>::max()) {
+        err << tr("The duration is too long") << endl;
+        return false;
+    }
+
+    QVector<TriggerCapture::Rule> rules;
+    foreach (const QString &pattern, options.triggerPatterns) {
+        TriggerCapture::Rule rule;
+        rule.type = TriggerCapture::RULE_PATTERN;
+        rule.argument = pattern;
+        rules.append(rule);
+    }
+    foreach (const QString &expression, options.triggerExpressions) {
+        TriggerCapture::Rule rule;
+        rule.type = TriggerCapture::RULE_REGEX;
+        rule.argument = expression;
+        rules.append(rule);
+    }
+    QString error;
+    if (!m_capture.setRules(rules, &error)) {
+        err << error << endl;
+        return false;
+    }
+
+    if (!options.logFile.isEmpty()) {
+        m_logFile.setFileName(options.logFile);
+        if (!m_logFile.open(QIODevice::WriteOnly | QIODevice::Truncate)) {
+            err << tr("Could not open %1: %2").arg(options.logFile, m_logFile.errorString()) << endl;
+            return false;
+        }
+    }
+
+    m_device.setPortName(session.device);
+    if (!m_device.open(QIODevice::ReadOnly)) {
+        err << tr("Could not open %1: %2").arg(session.device, m_device.errorString()) << endl;
+        return false;
+    }
+    m_device.setBaudRate(session.baudRate);
+    m_device.setDataBits(session.dataBits);
+    m_device.setParity(session.parity);
+    m_device.setStopBits(session.stopBits);
+    m_device.setFlowControl(session.flowControl);
+
+    installSignalHandlers();
+    m_started = CaptureClock::nsecsElapsed();
+    m_meter.sample(m_started);
+    m_sampleTimer.start(SAMPLE_INTERVAL_MS);
+    if (options.duration > 0)
+        m_durationTimer.start(int(options.duration));
+    return true;
+}
+
+/**
+ * @brief Everything the device has is taken in one go. The log file is
+ *  not flushed per read like in the window, its buffer and the one of
+ *  the OS take the load off the disk.
+ */
+void HeadlessCapture::readData()
+{
+    const QByteArray data = m_device.readAll();
+    if (data.isEmpty())
+        return;
+    const qint64 timestamp = CaptureClock::nsecsElapsed();
+
+    m_meter.add(data.size());
+    m_maxRead = qMax<qint64>(m_maxRead, data.size());
+    if (m_logFile.isOpen())
+        m_logFile.write(data);
+    // without rules there is nothing to capture for
+    if (!m_capture.rules().isEmpty())
+        m_capture.recordRx(data, timestamp, [this, timestamp](int rule) { trigger(rule, timestamp); });
+    emit captured(data, timestamp);
+}
+
+void HeadlessCapture::handleError(QSerialPort::SerialPortError error)
+{
+    if (error == QSerialPort::NoError)
+        return;
+    m_errors++;
+    m_lastError = m_device.errorString();
+    const qint64 timestamp = CaptureClock::nsecsElapsed();
+    if (!m_capture.rules().isEmpty()) {
+        const int rule = m_capture.recordError(m_lastError, timestamp);
+        if (rule >= 0)
+            trigger(rule, timestamp);
+    }
+    // the device is gone, nothing more will be read
+    if (error == QSerialPort::ResourceError) {
+        QTextStream(stderr) << tr("Device error: %1").arg(m_lastError) << endl;
+        stop(2);
+    }
+}
+
+void HeadlessCapture::trigger(int rule, qint64 timestamp)
+{
+    if (m_triggered)
+        return;
+    const TriggerCapture::Rule &fired = m_capture.rules().at(rule);
+    m_triggered = true;
+    m_triggerTime = timestamp;
+    m_triggerReason = QString("%1 %2").arg(TriggerCapture::ruleTypeName(fired.type)).arg(fired.argument).trimmed();
+    m_capture.beginCapture(timestamp);
+    m_postTriggerTimer.start(m_options.postTrigger);
+}
+
+/**
+ * @brief Write the capture file next to the log file, or into the
+ *  current directory without one
+ */
+void HeadlessCapture::dumpTrigger()
+{
+    if (!m_triggered)
+        return;
+    m_triggered = false;
+    const qint64 until = m_triggerTime + qint64(m_options.postTrigger) * 1000000;
+    const QList<TriggerCapture::Record> records = m_capture.takeCapture(until);
+    const QString stamp = CaptureClock::toDateTime(m_triggerTime).toString(QStringLiteral("yyyyMMdd-HHmmss-zzz"));
+    const QDir directory = m_options.logFile.isEmpty() ? QDir::current() : QFileInfo(m_options.logFile).absoluteDir();
+    const QString fileName = directory.filePath(QStringLiteral("cutecom-trigger-%1.txt").arg(stamp));
+
+    QFile file(fileName);
+    if (!file.open(QIODevice::WriteOnly | QIODevice::Text | QIODevice::Truncate)) {
+        QTextStream(stderr) << tr("Could not open %1: %2").arg(fileName, file.errorString()) << endl;
+        return;
+    }
+    QTextStream out(&file);
+    TriggerCapture::writeDump(out, records, m_triggerTime, m_triggerReason);
+    m_captureFiles++;
+}
+
+void HeadlessCapture::stop(int exitCode)
+{
+    if (m_stopped)
+        return;
+    m_stopped = true;
+    m_durationTimer.stop();
+    m_sampleTimer.stop();
+    // whatever arrived until now is still captured
+    if (m_device.isOpen()) {
+        readData();
+        m_device.close();
+    }
+    if (m_postTriggerTimer.isActive()) {
+        m_postTriggerTimer.stop();
+        dumpTrigger();
+    }
+    if (m_logFile.isOpen())
+        m_logFile.close();
+    m_meter.sample(CaptureClock::nsecsElapsed());
+    printStatistics();
+    QCoreApplication::exit(exitCode);
+}
+
+void HeadlessCapture::printStatistics()
+{
+    const Settings::Session session = m_settings->getCurrentSession();
+    const double seconds = (CaptureClock::nsecsElapsed() - m_started) / 1e9;
+    const double rate = seconds > 0 ? m_meter.bytes() / seconds : 0;
+    const double lineRate = session.baudRate / session.bitsPerCharacter();
+
+    QTextStream out(stdout);
+    out << "session:      " << m_settings->getCurrentSessionName() << endl;
+    out << "device:       " << m_device.portName() << " " << session.baudRate << " baud" << endl;
+    out << "duration:     " << QString::number(seconds, 'f', 3) << " s" << endl;
+    out << "received:     " << m_meter.bytes() << " bytes in " << m_meter.frames() << " reads" << endl;
+    out << "max. read:    " << m_maxRead << " bytes" << endl;
+    out << "average rate: " << QString::number(rate, 'f', 0) << " bytes/s";
+    if (lineRate > 0)
+        out << " (" << QString::number(100 * rate / lineRate, 'f', 1) << " % line load)";
+    out << endl;
+    out << "peak rate:    " << QString::number(m_meter.peakBytesPerSecond(), 'f', 0) << " bytes/s" << endl;
+    if (!m_options.logFile.isEmpty())
+        out << "log:          " << m_options.logFile << endl;
+    if (!m_capture.rules().isEmpty())
+        out << "captures:     " << m_captureFiles << endl;
+    out << "errors:       " << m_errors;
+    if (m_errors)
+        out << " (last: " << m_lastError << ")";
+    out << endl;
+}
+
+/**
+ * @brief SIGINT and SIGTERM end the capture through the event loop, the
+ *  handler only writes to a socket watched by a notifier
+ */
+void HeadlessCapture::installSignalHandlers()
+{
+#ifdef Q_OS_UNIX
+    if (::socketpair(AF_UNIX, SOCK_STREAM, 0, s_signalFd) != 0)
+        return;
+    m_signalNotifier = new QSocketNotifier(s_signalFd[1], QSocketNotifier::Read, this);
+    // activated() is overloaded since Qt 5.15
+    connect(m_signalNotifier, SIGNAL(activated(int)), this, SLOT(signalReceived()));
+    struct sigaction action;
+    action.sa_handler = &HeadlessCapture::signalHandler;
+    sigemptyset(&action.sa_mask);
+    action.sa_flags = SA_RESTART;
+    ::sigaction(SIGINT, &action, NULL);
+    ::sigaction(SIGTERM, &action, NULL);
+#endif
+}
+
+void HeadlessCapture::signalReceived()
+{
+#ifdef Q_OS_UNIX
+    char signal;
+    if (::read(s_signalFd[1], &signal, sizeof(signal)) > 0)
+        stop(0);
+#endif
+}
+
+void HeadlessCapture::signalHandler(int signal)
+{
+#ifdef Q_OS_UNIX
+    const char byte = char(signal);
+    if (::write(s_signalFd[0], &byte, sizeof(byte)) < 0) {
+        // nothing that could be done inside a signal handler
+    }
+#else
+    Q_UNUSED(signal);
+#endif
+}
@@ -0,0 +1,129 @@
+/*
+ * Copyright (c) 2026 CuteCom contributors
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 675 Mass Ave, Cambridge, MA 02139, USA.
+ *
+ * For more information on the GPL, please go to:
+ * http://www.gnu.org/copyleft/gpl.html
+ */
+
+#ifndef HEADLESSCAPTURE_H
+#define HEADLESSCAPTURE_H
+
+#include "settings.h"
+#include "throughputmeter.h"
+#include "triggercapture.h"
+
+#include <QFile>
+#include <QObject>
+#include <QSerialPort>
+#include <QTimer>
+
+class QSocketNotifier;
+
+/**
+ * Unattended capture of a session without any widgets: the device is
+ * opened with the settings of the session, everything read goes to the
+ * log file and through the trigger rules. The capture ends after the
+ * given duration, on SIGINT/SIGTERM or when the device goes away, then
+ * the statistics are printed on stdout and the event loop is left.
+ */
+class HeadlessCapture : public QObject
+{
+    Q_OBJECT
+
+public:
+    struct Options {
+        Options()
+            : duration(0)
+            , postTrigger(1000)
+        {
+        }
+        QString session;
+        /* used instead of the device of the session if set */
+        QString device;
+        QString logFile;
+        /* ms, 0 captures until a signal arrives */
+        qint64 duration;
+        /* escaped byte patterns and regular expressions applied to lines */
+        QStringList triggerPatterns;
+        QStringList triggerExpressions;
+        /* ms recorded after a trigger before the capture file is written */
+        int postTrigger;
+    };
+
+    explicit HeadlessCapture(QObject *parent = 0);
+    ~HeadlessCapture();
+
+    /**
+     * @brief Open the device and the log file
+     * @return false if that failed, the reason has been printed on stderr
+     */
+    bool start(const Options &options);
+
+    /**
+     * @brief Parse a duration like "90", "500ms", "45s", "10m" or "1h30m"
+     * @return milliseconds, -1 if \a text is no duration
+     */
+    static qint64 parseDuration(const QString &text);
+
+signals:
+    /**
+     * @brief Data have been read and logged, e.g. for measuring the
+     *  latency of the capture
+     */
+    void captured(const QByteArray &data, qint64 timestamp);
+
+private slots:
+    void signalReceived();
+
+private:
+    enum { SAMPLE_INTERVAL_MS = 250 };
+
+    void readData();
+    void handleError(QSerialPort::SerialPortError error);
+    void trigger(int rule, qint64 timestamp);
+    void dumpTrigger();
+    void stop(int exitCode);
+    void printStatistics();
+    void installSignalHandlers();
+    static void signalHandler(int signal);
+
+    Settings *m_settings;
+    Options m_options;
+    QSerialPort m_device;
+    QFile m_logFile;
+
+    TriggerCapture m_capture;
+    bool m_triggered;
+    qint64 m_triggerTime;
+    QString m_triggerReason;
+    QTimer m_postTriggerTimer;
+    quint64 m_captureFiles;
+
+    QTimer m_durationTimer;
+    QTimer m_sampleTimer;
+    ThroughputMeter m_meter;
+    qint64 m_started;
+    qint64 m_maxRead;
+    quint64 m_errors;
+    QString m_lastError;
+    bool m_stopped;
+
+    QSocketNotifier *m_signalNotifier;
+    static int s_signalFd[2];
+};
+
+#endif // HEADLESSCAPTURE_H
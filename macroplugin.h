@@ -41,7 +41,6 @@ public:
     explicit MacroPlugin(QFrame *parent, Settings *settings);
     virtual ~MacroPlugin();
     const Plugin *plugin();
-    int processCmd(const QString *text);
 
 signals:
     void sendCmd(QByteArray);
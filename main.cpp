@@ -20,17 +20,31 @@
  * http://www.gnu.org/copyleft/gpl.html
  */
 
+#include "headlesscapture.h"
 #include "mainwindow.h"
 // version.h is generated via cmake
 // if you use qmake, please cp version.h.in to version.h
 #include "version.h"
 #include <QApplication>
 #include <QCommandLineParser>
-#include <QIcon>
+#include <QScopedPointer>
+#include <QTextStream>
 
 int main(int argc, char *argv[])
 {
-    QApplication a(argc, argv);
+    // without a window there is no need for a display, the widgets are
+    // not even initialized then
+    bool headless = false;
+    for (int i = 1; i < argc; i++) {
+        if (qstrcmp(argv[i], "--headless") == 0)
+            headless = true;
+    }
+    QScopedPointer<QCoreApplication> a(headless ? new QCoreApplication(argc, argv) : new QApplication(argc, argv));
+    QCoreApplication::setOrganizationName(QStringLiteral("CuteCom"));
+    // setting it to CuteCom5 will prevent the original CuteCom's settings file
+    // to be overwritten
+    QCoreApplication::setApplicationName(QStringLiteral("CuteCom5"));
+    QCoreApplication::setApplicationVersion(QStringLiteral("%1").arg(CuteCom_VERSION));
 
     QCommandLineParser parser;
     parser.setApplicationDescription(
@@ -38,19 +52,71 @@ int main(int argc, char *argv[])
     parser.addHelpOption();
     QCommandLineOption sessionOption(QStringList() << "s"
                                                    << "session",
-                                     QCoreApplication::translate("main", "Open a named <session>"),
+                                     QCoreApplication::translate("main", "Open a named <session>, repeatable to open "
+                                                                         "several sessions in windows of their own"),
                                      QCoreApplication::translate("main", "session"));
     parser.addOption(sessionOption);
+    QCommandLineOption headlessOption(
+        "headless",
+        QCoreApplication::translate("main", "Capture the session without a window, print statistics at the end"));
+    parser.addOption(headlessOption);
+    QCommandLineOption deviceOption(
+        "device", QCoreApplication::translate("main", "Headless: capture <device> instead of the one of the session"),
+        QCoreApplication::translate("main", "device"));
+    parser.addOption(deviceOption);
+    QCommandLineOption logOption("log",
+                                 QCoreApplication::translate("main", "Headless: write the received data to <file>"),
+                                 QCoreApplication::translate("main", "file"));
+    parser.addOption(logOption);
+    QCommandLineOption durationOption(
+        "duration", QCoreApplication::translate("main", "Headless: stop after <time>, e.g. 90s, 10m or 1h30m"),
+        QCoreApplication::translate("main", "time"));
+    parser.addOption(durationOption);
+    QCommandLineOption triggerOption(
+        "trigger", QCoreApplication::translate("main", "Headless: write a capture file when <pattern> is received"),
+        QCoreApplication::translate("main", "pattern"));
+    parser.addOption(triggerOption);
+    QCommandLineOption triggerRegexOption(
+        "trigger-regex",
+        QCoreApplication::translate("main", "Headless: write a capture file when a line matches <regex>"),
+        QCoreApplication::translate("main", "regex"));
+    parser.addOption(triggerRegexOption);
+    QCommandLineOption postTriggerOption(
+        "post-trigger", QCoreApplication::translate("main", "Headless: <time> captured after a trigger, 1s by default"),
+        QCoreApplication::translate("main", "time"));
+    parser.addOption(postTriggerOption);
 
     // Process the actual command line arguments given by the user
-    parser.process(a);
-    QString session = parser.value(sessionOption);
+    parser.process(*a);
 
-    MainWindow w(0, session);
-    QIcon appIcon;
-    appIcon.addFile(QStringLiteral(":/images/terminal.svg"));
-    w.setWindowIcon(appIcon);
-    w.show();
+    if (headless) {
+        HeadlessCapture::Options options;
+        options.session = parser.value(sessionOption);
+        options.device = parser.value(deviceOption);
+        options.logFile = parser.value(logOption);
+        options.triggerPatterns = parser.values(triggerOption);
+        options.triggerExpressions = parser.values(triggerRegexOption);
+        if (parser.isSet(durationOption))
+            options.duration = HeadlessCapture::parseDuration(parser.value(durationOption));
+        if (parser.isSet(postTriggerOption))
+            options.postTrigger = int(HeadlessCapture::parseDuration(parser.value(postTriggerOption)));
+        if (options.duration < 0 || options.postTrigger < 0) {
+            QTextStream(stderr) << QCoreApplication::translate("main", "Invalid time, use e.g. 500ms, 90s, 10m or 1h")
+                                << endl;
+            return 1;
+        }
+        HeadlessCapture capture;
+        if (!capture.start(options))
+            return 1;
+        return a->exec();
+    }
 
-    return a.exec();
+    // each session gets a window of its own, all of them are served by this event loop
+    QStringList sessions = parser.values(sessionOption);
+    if (sessions.isEmpty())
+        sessions.append(QString());
+    foreach (const QString &session, sessions)
+        MainWindow::openWindow(session);
+
+    return a->exec();
 }
@@ -26,14 +26,21 @@
  */
 
 #include "mainwindow.h"
+#include "captureclock.h"
 #include "datadisplay.h"
 #include "qdebug.h"
 #include "settings.h"
+#include "terminalview.h"
+#include "timelinewindow.h"
+#include "txencoder.h"
 #include "version.h"
 
 #include <QCompleter>
 #include <QDialog>
 #include <QFileDialog>
+#include <QFileInfo>
+#include <QIcon>
+#include <QInputDialog>
 #include <QMessageBox>
 #include <QProgressDialog>
 #include <QResizeEvent>
@@ -53,6 +60,13 @@ void millisleep(unsigned long ms)
     }
 }
 
+/**
+ * All windows of this process, each one serves a session of its own
+ */
+static QList<MainWindow *> s_windows;
+/* a timeline is shown, see setTimelineRecording() */
+static bool s_timelineRecording = false;
+
 MainWindow::MainWindow(QWidget *parent, const QString &session)
     : QMainWindow(parent)
     , m_device(new QSerialPort(this))
@@ -64,13 +78,11 @@ MainWindow::MainWindow(QWidget *parent, const QString &session)
     , m_ctrlCharactersPopup(nullptr)
     , m_keyRepeatTimer(this)
     , m_keyCode('\0')
+    , m_controlLinesTimer(this)
+    , m_controlLines(-1)
     , m_cmdBufIndex(0)
 {
-    QCoreApplication::setOrganizationName(QStringLiteral("CuteCom"));
-    // setting it to CuteCom5 will prevent the original CuteCom's settings file
-    // to be overwritten
-    QCoreApplication::setApplicationName(QStringLiteral("CuteCom5"));
-    QCoreApplication::setApplicationVersion(QStringLiteral("%1").arg(CuteCom_VERSION));
+    s_windows.append(this);
     //    qRegisterMetaType<Settings::LineTerminator>();
 
     setupUi(this);
@@ -85,8 +97,13 @@ MainWindow::MainWindow(QWidget *parent, const QString &session)
         if (m_device->isOpen())
             m_input_edit->setFocus();
         m_output_display->clear();
+        m_terminal_view->clear();
     });
     connect(m_check_hex_out, &QCheckBox::toggled, m_output_display, &DataDisplay::setDisplayHex);
+    connect(m_bt_pause, &QPushButton::toggled, m_output_display, &DataDisplay::setPaused);
+    connect(m_check_terminal, &QCheckBox::toggled, this, &MainWindow::toggleTerminal);
+    // key presses and answers to requests of the device
+    connect(m_terminal_view, &TerminalView::sendData, this, [=](const QByteArray &data) { sendData(data, 0); });
 
     // initialize settings stored in the config file
     m_settings = new Settings(this);
@@ -153,6 +170,17 @@ MainWindow::MainWindow(QWidget *parent, const QString &session)
     connect(m_spinner_chardelay, static_cast<void (QSpinBox::*)(int)>(&QSpinBox::valueChanged),
             [=](int value) { m_settings->settingChanged(Settings::CharacterDelay, value); });
 
+    fillEncodingChooser();
+
+    m_check_fold->setChecked(m_settings->getFoldLines());
+    m_output_display->setFoldRepeatedLines(m_settings->getFoldLines());
+    connect(m_check_fold, &QCheckBox::toggled, [=](bool checked) {
+        m_output_display->setFoldRepeatedLines(checked);
+        m_settings->settingChanged(Settings::FoldLines, checked);
+    });
+
+    fillIdleGapChooser();
+
     // add the settings slide out panel
     controlPanel = new ControlPanel(this->centralWidget(), m_settings);
 
@@ -195,9 +223,12 @@ MainWindow::MainWindow(QWidget *parent, const QString &session)
             static_cast<void (QSerialPort::*)(QSerialPort::SerialPortError serialPortError)>(&QSerialPort::error), this,
             &MainWindow::handleError);
     connect(m_device, &QSerialPort::readyRead, this, &MainWindow::processData);
+    // the idle gap in character times depends on the baud rate
+    connect(m_settings, &Settings::sessionChanged, this, &MainWindow::updateIdleGap);
 
     m_input_edit->installEventFilter(this);
     connect(&m_keyRepeatTimer, &QTimer::timeout, this, &MainWindow::sendKey);
+    connect(&m_controlLinesTimer, &QTimer::timeout, this, &MainWindow::pollControlLines);
     connect(m_input_edit, &QLineEdit::returnPressed, this, &MainWindow::execCmd);
     connect(m_command_history, &QListWidget::itemClicked, this, &MainWindow::commandFromHistoryClicked);
     connect(m_command_history, &QListWidget::doubleClicked, this, &MainWindow::execCmd);
@@ -226,6 +257,8 @@ MainWindow::MainWindow(QWidget *parent, const QString &session)
     connect(m_sessionManager, &SessionManager::sessionRenamed, m_settings, &Settings::renameSession);
     connect(m_sessionManager, &SessionManager::sessionCloned, m_settings, &Settings::cloneSession);
     connect(actionManager, &QAction::triggered, m_sessionManager, &QDialog::show);
+    connect(actionOpen, &QAction::triggered, this, &MainWindow::openSessionWindow);
+    connect(actionTimeline, &QAction::triggered, &TimelineWindow::showTimeline);
 
     connect(controlPanel->m_rts_line, &QCheckBox::stateChanged, this, &MainWindow::setRTSLineState);
     connect(controlPanel->m_dtr_line, &QCheckBox::stateChanged, this, &MainWindow::setDTRLineState);
@@ -240,6 +273,38 @@ MainWindow::MainWindow(QWidget *parent, const QString &session)
             [=]() { m_plugin_manager->addPluginType(PluginManager::en_plugin_type::PLUGIN_TYPE_NET_PROXY); });
     connect(m_actionAddPluginByteCounter, &QAction::triggered, this,
             [=]() { m_plugin_manager->addPluginType(PluginManager::en_plugin_type::PLUGIN_TYPE_BYTE_COUNTER); });
+    connect(m_actionAddPluginSendExpect, &QAction::triggered, this,
+            [=]() { m_plugin_manager->addPluginType(PluginManager::en_plugin_type::PLUGIN_TYPE_SEND_EXPECT); });
+    connect(m_actionAddPluginAutoResponder, &QAction::triggered, this,
+            [=]() { m_plugin_manager->addPluginType(PluginManager::en_plugin_type::PLUGIN_TYPE_AUTO_RESPONDER); });
+    connect(m_actionAddPluginFrameDecoder, &QAction::triggered, this,
+            [=]() { m_plugin_manager->addPluginType(PluginManager::en_plugin_type::PLUGIN_TYPE_FRAME_DECODER); });
+    connect(m_actionAddPluginModbus, &QAction::triggered, this,
+            [=]() { m_plugin_manager->addPluginType(PluginManager::en_plugin_type::PLUGIN_TYPE_MODBUS); });
+    connect(m_actionAddPluginTriggerCapture, &QAction::triggered, this,
+            [=]() { m_plugin_manager->addPluginType(PluginManager::en_plugin_type::PLUGIN_TYPE_TRIGGER_CAPTURE); });
+    connect(m_actionAddPluginPtyMux, &QAction::triggered, this,
+            [=]() { m_plugin_manager->addPluginType(PluginManager::en_plugin_type::PLUGIN_TYPE_PTY_MUX); });
+    /* plugin libraries get their actions between the built-in plugins and the statistics */
+    for (int i = 0; i < m_plugin_manager->libraries().size(); i++) {
+        const PluginManager::Library &library = m_plugin_manager->libraries().at(i);
+        QAction *action = new QAction(tr("New %1").arg(library.name), this);
+        action->setToolTip(library.description);
+        menuPlugins->insertAction(m_actionPluginStatistics, action);
+        connect(action, &QAction::triggered, this, [=]() {
+            QString error;
+            if (!m_plugin_manager->addLibraryPlugin(i, &error))
+                QMessageBox::warning(this, tr("Loading plugin failed"), error);
+        });
+    }
+    if (!m_plugin_manager->libraries().isEmpty())
+        menuPlugins->insertSeparator(m_actionPluginStatistics);
+    connect(m_actionPluginStatistics, &QAction::triggered, this, [=]() {
+        QMessageBox box(QMessageBox::Information, tr("Plugin statistics"), m_plugin_manager->rxStatisticsReport(),
+                        QMessageBox::Ok, this);
+        box.setStyleSheet(QStringLiteral("QLabel{font-family: monospace;}"));
+        box.exec();
+    });
     /* connect plugins sendCmd with the main window interface. As it is now, for the cmd history to
      * work properly, we must involve m_input_edit and then run execCmd();
      */
@@ -247,6 +312,14 @@ MainWindow::MainWindow(QWidget *parent, const QString &session)
         this->m_input_edit->setText(cmd);
         this->execCmd();
     });
+    /* raw data from plugins, e.g. automated tests, go straight to the device. They are
+     * flushed right away instead of waiting for the event loop, so responses leave
+     * before the plugin returns and their latency can be measured there */
+    connect(m_plugin_manager, &PluginManager::writeData, this, [=](QByteArray data) {
+        if (sendData(data, 0))
+            m_device->flush();
+    });
+    connect(m_plugin_manager, &PluginManager::controlPort, this, &MainWindow::controlPort);
     QShortcut *shortcutToggleControlPanel = new QShortcut(QKeySequence(tr("Alt+S", "shortcut")), this);
     connect(shortcutToggleControlPanel, &QShortcut::activated, controlPanel, &ControlPanel::toggleMenu);
 }
@@ -338,6 +411,75 @@ void MainWindow::closeEvent(QCloseEvent *event)
     QMainWindow::closeEvent(event);
 }
 
+/**
+ * @brief Minimized windows don't render the incoming data, the display
+ *  catches up with the tail of it once the window is shown again
+ */
+void MainWindow::changeEvent(QEvent *event)
+{
+    if (event->type() == QEvent::WindowStateChange)
+        m_output_display->setSuspended(isMinimized());
+    QMainWindow::changeEvent(event);
+}
+
+/**
+ * @brief Show the window of a session, a new one is opened unless
+ *  the session is already used by a window of this process
+ * @param session name of the session, the stored one if empty
+ * @return
+ */
+MainWindow *MainWindow::openWindow(const QString &session)
+{
+    foreach (MainWindow *window, s_windows) {
+        if (!session.isEmpty() && window->m_settings->getCurrentSessionName() == session) {
+            window->showNormal();
+            window->raise();
+            window->activateWindow();
+            return window;
+        }
+    }
+    MainWindow *window = new MainWindow(0, session);
+    window->setAttribute(Qt::WA_DeleteOnClose);
+    QIcon appIcon;
+    appIcon.addFile(QStringLiteral(":/images/terminal.svg"));
+    window->setWindowIcon(appIcon);
+    window->show();
+    return window;
+}
+
+QList<MainWindow *> MainWindow::windows() { return s_windows; }
+
+void MainWindow::setTimelineRecording(bool record)
+{
+    s_timelineRecording = record;
+    if (!record) {
+        foreach (MainWindow *window, s_windows)
+            window->m_timeline.clear();
+    }
+}
+
+QString MainWindow::portLabel() const
+{
+    const QString session = m_settings->getCurrentSessionName();
+    if (m_device->portName().isEmpty())
+        return session;
+    return QStringLiteral("%1 (%2)").arg(session, m_device->portName());
+}
+
+/**
+ * @brief [SLOT] Ask for a session and open it in a window of its own
+ */
+void MainWindow::openSessionWindow()
+{
+    QStringList sessions = m_settings->getSessionNames();
+    sessions.sort();
+    bool ok = false;
+    QString session = QInputDialog::getItem(this, tr("Open session"), tr("Session to open in a new window:"),
+                                            sessions, 0, false, &ok);
+    if (ok && !session.isEmpty())
+        openWindow(session);
+}
+
 void MainWindow::openDevice()
 {
     const Settings::Session session = m_settings->getCurrentSession();
@@ -381,6 +523,11 @@ void MainWindow::openDevice()
         // display connection parameter on status bar
         m_device_statusbar->setDeviceInfo(m_device);
 
+        m_controlLines = -1;
+        m_controlLinesTimer.start(20);
+        m_plugin_manager->processEvent(Plugin::EVENT_BREAK, m_device->isBreakEnabled(), QString(),
+                                       CaptureClock::nsecsElapsed());
+
         // enable all inputs if writing to the device is enabled
         if (session.openMode == QIODevice::WriteOnly || session.openMode == QIODevice::ReadWrite) {
 
@@ -402,6 +549,7 @@ void MainWindow::closeDevice()
     m_device->clearError();
     m_device->close();
     m_deviceState = DEVICE_CLOSED;
+    m_controlLinesTimer.stop();
     m_input_edit->setEnabled(false);
     controlPanel->m_bt_open->setFocus();
     controlPanel->m_combo_device->setEnabled(true);
@@ -423,7 +571,9 @@ void MainWindow::handleError(QSerialPort::SerialPortError error)
 {
     if (error == QSerialPort::NoError) {
         return;
-    } else if (m_deviceState == DEVICE_OPEN || m_deviceState == DEVICE_OPENING) {
+    }
+    m_plugin_manager->processEvent(Plugin::EVENT_ERROR, error, m_device->errorString(), CaptureClock::nsecsElapsed());
+    if (m_deviceState == DEVICE_OPEN || m_deviceState == DEVICE_OPENING) {
         // on hot unplug of usb2serial adapters, multiple errors will be
         // reported which is of no importance to the users.
         // reporting it once should be enough
@@ -438,6 +588,23 @@ void MainWindow::handleError(QSerialPort::SerialPortError error)
     m_device->clearError();
 }
 
+/**
+ * Hand changes of the control lines to the plugins
+ * @brief MainWindow::pollControlLines
+ */
+void MainWindow::pollControlLines()
+{
+    if (!m_device->isOpen() || !m_plugin_manager->hasEventHooks()) {
+        m_controlLines = -1;
+        return;
+    }
+    const int lines = m_device->pinoutSignals();
+    if (lines == m_controlLines)
+        return;
+    m_controlLines = lines;
+    m_plugin_manager->processEvent(Plugin::EVENT_CONTROL_LINES, lines, QString(), CaptureClock::nsecsElapsed());
+}
+
 /**
  * This displays information about the device on the console window.
  * Useful mainly for debugging or for a CLI version of cutecom
@@ -464,6 +631,19 @@ void MainWindow::toggleLogging(bool start)
     }
 
     if (start) {
+        /* the log location is shared by all sessions, a second window would
+         * truncate the log of the first one or interleave with it */
+        const QString path = QFileInfo(currentLogFileName).absoluteFilePath();
+        foreach (const MainWindow *window, s_windows) {
+            if (window != this && window->m_logFile.isOpen()
+                && QFileInfo(window->m_logFile.fileName()).absoluteFilePath() == path) {
+                QMessageBox::information(this, tr("Opening file failed"),
+                                         tr("%1 is already the log file of another window").arg(currentLogFileName));
+                m_check_logging->setChecked(false);
+                return;
+            }
+        }
+
         if (m_logFile.fileName() != currentLogFileName) {
             m_logFile.flush();
             m_logFile.close();
@@ -494,24 +674,17 @@ void MainWindow::fillLineTerminationChooser(const Settings::LineTerminator setti
                                   tr("Mixed Hex/ASCII:\n\"ABC\"444546\"GHI\"4a4b4c"), Qt::ToolTipRole);
 
     int index = m_combo_lineterm->findData((setting > Settings::HEX) ? Settings::LF : setting);
-    if (index != -1) {
+    if (index != -1)
         m_combo_lineterm->setCurrentIndex(index);
-        if (setting == Settings::CR) {
-            m_output_display->setLinebreakChar("\r");
-        } else {
-            m_output_display->setLinebreakChar("\n");
-        }
-    }
-    /* Assumption:
-       If the connected device expects CR ('\r') as line termination, it will send CR as line
-       termination as well. Setup the DataDisplay to break lines on CR instaed of LF accordingly */
+    m_edit_linebreak->setText(m_settings->getLinebreak());
+    updateLinebreak();
+    connect(m_edit_linebreak, &QLineEdit::editingFinished, this, [=]() {
+        m_settings->settingChanged(Settings::Linebreak, m_edit_linebreak->text());
+        updateLinebreak();
+    });
     connect(m_combo_lineterm, static_cast<void (QComboBox::*)(int)>(&QComboBox::currentIndexChanged), [=]() {
         auto currentValue = m_combo_lineterm->currentData().value<Settings::LineTerminator>();
-        if (Settings::LineTerminator::CR == currentValue) {
-            m_output_display->setLinebreakChar("\r");
-        } else {
-            m_output_display->setLinebreakChar("\n");
-        }
+        updateLinebreak();
 
         // inform CtrlCharactersPopup widget about this change
         m_ctrlCharactersPopup->setHexInsertionMode(Settings::LineTerminator::HEX == currentValue);
@@ -520,6 +693,78 @@ void MainWindow::fillLineTerminationChooser(const Settings::LineTerminator setti
     });
 }
 
+/**
+ * Sets the delimiters the output is split into lines at. Without
+ * delimiters entered by the user, they follow the line termination.
+ * @brief MainWindow::updateLinebreak
+ */
+void MainWindow::updateLinebreak()
+{
+    QString delimiters = m_edit_linebreak->text();
+    /* Assumption:
+       If the connected device expects CR ('\r') as line termination, it will send CR as line
+       termination as well. Setup the DataDisplay to break lines on CR instaed of LF accordingly */
+    if (delimiters.isEmpty()) {
+        if (m_combo_lineterm->currentData().value<Settings::LineTerminator>() == Settings::CR)
+            delimiters = QStringLiteral("\\r");
+        else
+            delimiters = QStringLiteral("\\n");
+    }
+    m_output_display->setLinebreak(delimiters);
+}
+
+void MainWindow::fillEncodingChooser()
+{
+    m_combo_encoding->addItem(QStringLiteral("Latin-1"), QVariant::fromValue(Settings::LATIN1));
+    m_combo_encoding->addItem(QStringLiteral("UTF-8"), QVariant::fromValue(Settings::UTF8));
+    int index = m_combo_encoding->findData(m_settings->getEncoding());
+    if (index != -1)
+        m_combo_encoding->setCurrentIndex(index);
+    m_output_display->setDecodeUtf8(m_settings->getEncoding() == Settings::UTF8);
+
+    connect(m_combo_encoding, static_cast<void (QComboBox::*)(int)>(&QComboBox::currentIndexChanged), [=]() {
+        auto currentValue = m_combo_encoding->currentData().value<Settings::TextEncoding>();
+        m_output_display->setDecodeUtf8(currentValue == Settings::UTF8);
+        m_settings->settingChanged(Settings::Encoding, currentValue);
+    });
+}
+
+/**
+ * Sets up the controls for splitting the output into rows
+ * at idle times of the line instead of line breaks
+ * @brief MainWindow::fillIdleGapChooser
+ */
+void MainWindow::fillIdleGapChooser()
+{
+    m_combo_idle_unit->addItem(QString::fromUtf8("\u00b5s"), QVariant::fromValue(Settings::MICROSECONDS));
+    m_combo_idle_unit->addItem(tr("chars"), QVariant::fromValue(Settings::CHARACTERS));
+    int index = m_combo_idle_unit->findData(m_settings->getIdleGapUnit());
+    if (index != -1)
+        m_combo_idle_unit->setCurrentIndex(index);
+    m_spinner_idle_gap->setValue(m_settings->getIdleGap());
+    updateIdleGap();
+
+    connect(m_spinner_idle_gap, static_cast<void (QSpinBox::*)(int)>(&QSpinBox::valueChanged), [=](int value) {
+        m_settings->settingChanged(Settings::IdleGap, value);
+        updateIdleGap();
+    });
+    connect(m_combo_idle_unit, static_cast<void (QComboBox::*)(int)>(&QComboBox::currentIndexChanged), [=]() {
+        m_settings->settingChanged(Settings::IdleGapUnit, m_combo_idle_unit->currentData());
+        updateIdleGap();
+    });
+}
+
+void MainWindow::updateIdleGap()
+{
+    const qint64 characterTime = m_settings->getCurrentSession().characterTime();
+    qint64 gap = m_spinner_idle_gap->value();
+    if (m_combo_idle_unit->currentData().value<Settings::IdleGapUnit>() == Settings::CHARACTERS)
+        gap *= characterTime;
+    else
+        gap *= 1000;
+    m_output_display->setIdleGap(gap, characterTime);
+}
+
 /**
  * Fills the ComboBox from which the user can select the protocoll used
  * for sending a file across the device
@@ -640,102 +885,44 @@ bool MainWindow::sendString(const QString &s)
     // ToDo
     unsigned int charDelay = m_spinner_chardelay->value();
 
-    /* allow plugins to process the output data */
-    m_plugin_manager->processCmd((QString *)&s);
-
-    if (lineMode == Settings::HEX) // hex
-    {
-        QString hex = s;
-        hex.remove(QRegExp("\\s+(?=(?:[^\"]*\"[^\"]*\")*[^\"]*$)")); // spaces except that in quotes
-        if ((hex.startsWith("0x")) || (hex.startsWith("0X"))) {
-            hex = hex.mid(2);
-        }
-
-        bool ascii = false;
-        for (int i = 0; i < hex.length();) {
-            QString nextByte = hex.mid(i, ascii ? 1 : 2);
-            i += ascii ? 1 : 2;
-            if (nextByte.left(1) == "\"") {
-                if (!ascii)
-                    ascii = true;
-                else {
-                    ascii = false;
-                    continue;
-                }
-            }
-            if (ascii)
-                continue;
-            bool ok = true;
-            nextByte.toUInt(&ok, 16);
-            if (!ok) {
-                QMessageBox::information(this, tr("Invalid hex characters"),
-                                         tr("The input string contains invalid hex characters: 0x%1").arg(nextByte));
-                return false;
-            }
-        }
+    QByteArray bytes;
+    QString error;
+    if (!TxEncoder::encode(s, lineMode, &bytes, &error)) {
+        QMessageBox::information(this, tr("Invalid input"), error);
+        return false;
+    }
 
-        if (ascii) {
-            QMessageBox::information(this, tr("Invalid format"), tr("No closing quote"));
-            return false;
-        }
+    return sendData(bytes, charDelay);
+}
 
-        for (int i = 0; i < hex.length();) {
-            QString nextByte = hex.mid(i, ascii ? 1 : 2);
-            i += ascii ? 1 : 2;
-            if (nextByte.left(1) == "\"") {
-                if (!ascii) {
-                    ascii = true;
-                    nextByte = nextByte.right(1);
-                } else {
-                    ascii = false;
-                    continue;
-                }
-            }
-            unsigned int byte;
-            if (ascii)
-                byte = nextByte.at(0).unicode() & 0xFF;
-            else
-                byte = nextByte.toUInt(0, 16);
-
-            sendByte(byte & 0xff, charDelay);
-            // fprintf(stderr, " 0x%x d:%d ", byte & 0xff, charDelay);
-        }
-        return true;
+/**
+ * @brief Run the data through the TX plugins and write them to the device
+ * @param data The complete payload, including the line terminator
+ * @param charDelay Delay after each byte in ms. Without a delay the whole
+ *  buffer is written at once.
+ * @return false if the device is closed or the write failed
+ */
+bool MainWindow::sendData(QByteArray data, unsigned long charDelay)
+{
+    if (!m_device->isOpen()) {
+        return false;
     }
 
-    // converts QString into QByteArray, this supports converting control characters being shown in input field as
-    // QChars
-    // of Control Pictures from Unicode block.
-    QByteArray bytes;
-    bytes.reserve(s.size());
-    for (auto &c : s) {
-        bytes.append(static_cast<char>(c.unicode()));
-    }
+    /* allow plugins to process the output data */
+    m_plugin_manager->processTx(data);
 
-    for (int i = 0; i < bytes.length(); i++) {
-        if (!sendByte(bytes[i], charDelay))
+    if (!charDelay) {
+        if (m_device->write(data) < data.size()) {
+            qDebug() << m_device->errorString();
             return false;
+        }
+        return true;
     }
 
-    switch (lineMode) {
-    case Settings::LF:
-        if (!sendByte('\n', charDelay))
-            return false;
-        break;
-    case Settings::CR:
-        if (!sendByte('\r', charDelay))
-            return false;
-        break;
-    case Settings::CRLF:
-        if (!sendByte('\r', charDelay))
-            return false;
-        if (!sendByte('\n', charDelay))
+    for (int i = 0; i < data.size(); i++) {
+        if (!sendByte(data.at(i), charDelay))
             return false;
-        break;
-    default:
-        break;
     }
-
     return true;
 }
 
@@ -1007,6 +1194,10 @@ void MainWindow::sendDone(int exitCode, QProcess::ExitStatus exitStatus)
 void MainWindow::processData()
 {
     QByteArray data = m_device->readAll();
+    const qint64 timestamp = CaptureClock::nsecsElapsed();
+    // plugins reacting on the data get them first, their timing must
+    // not depend on the display
+    m_plugin_manager->processRx(data, timestamp);
     // Debugging:
     // QString temp = QString(QStringLiteral("abcd\ncd\tef\nuvwxyz12345\r\n67890123456\r\n-----\2---\0---\n"));
     // QByteArray data = temp.toLatin1();
@@ -1016,8 +1207,27 @@ void MainWindow::processData()
         m_logFile.write(data);
         m_logFile.flush();
     }
-    m_output_display->displayData(data);
-    emit m_plugin_manager->recvCmd(data);
+    if (s_timelineRecording)
+        m_timeline.append(data, timestamp);
+    if (m_check_terminal->isChecked())
+        m_terminal_view->feed(data);
+    else
+        m_output_display->displayData(data, timestamp);
+}
+
+/**
+ * @brief Switch between the plain log and the terminal emulation. The
+ *  logfile and the plugins keep getting the raw data either way.
+ */
+void MainWindow::toggleTerminal(bool terminal)
+{
+    m_output_display->setVisible(!terminal);
+    m_check_hex_out->setEnabled(!terminal);
+    m_terminal_view->setVisible(terminal);
+    if (terminal)
+        m_terminal_view->setFocus();
+    else if (m_device->isOpen())
+        m_input_edit->setFocus();
 }
 
 void MainWindow::removeSelectedInputItems(bool checked)
@@ -1060,8 +1270,57 @@ void MainWindow::setDTRLineState(int checked)
     }
 }
 
+void MainWindow::controlPort(Plugin::PortControl control, int value)
+{
+    if ((nullptr == m_device) || (false == m_device->isOpen()))
+        return;
+
+    /* the settings are applied to the device and stored in the session, so
+     * the control panel and the status bar show what the device runs with */
+    switch (control) {
+    case Plugin::PORT_BAUD_RATE:
+        m_device->setBaudRate(value);
+        m_settings->settingChanged(Settings::BaudRate, value);
+        break;
+    case Plugin::PORT_DATA_BITS:
+        m_device->setDataBits(static_cast<QSerialPort::DataBits>(value));
+        m_settings->settingChanged(Settings::DataBits, value);
+        break;
+    case Plugin::PORT_PARITY:
+        m_device->setParity(static_cast<QSerialPort::Parity>(value));
+        m_settings->settingChanged(Settings::Parity, value);
+        break;
+    case Plugin::PORT_STOP_BITS:
+        m_device->setStopBits(static_cast<QSerialPort::StopBits>(value));
+        m_settings->settingChanged(Settings::StopBits, value);
+        break;
+    case Plugin::PORT_FLOW_CONTROL:
+        m_device->setFlowControl(static_cast<QSerialPort::FlowControl>(value));
+        m_settings->settingChanged(Settings::FlowControl, value);
+        break;
+    case Plugin::PORT_DTR:
+        // the check box sets the line
+        controlPanel->m_dtr_line->setChecked(value);
+        return;
+    case Plugin::PORT_RTS:
+        controlPanel->m_rts_line->setChecked(value);
+        return;
+    case Plugin::PORT_BREAK:
+        m_device->setBreakEnabled(value);
+        m_plugin_manager->processEvent(Plugin::EVENT_BREAK, m_device->isBreakEnabled(), QString(),
+                                       CaptureClock::nsecsElapsed());
+        return;
+    case Plugin::PORT_PURGE:
+        m_device->clear(static_cast<QSerialPort::Directions>(value));
+        return;
+    }
+    controlPanel->applySessionSettings(m_settings->getCurrentSession());
+    m_device_statusbar->sessionChanged(m_settings->getCurrentSession());
+}
+
 MainWindow::~MainWindow()
 {
+    s_windows.removeAll(this);
     if (m_device->isOpen()) {
         m_deviceState = DEVICE_CLOSING;
         closeDevice();
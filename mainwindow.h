@@ -30,6 +30,7 @@
 #include "statusbar.h"
 #include "ui_mainwindow.h"
 #include "pluginmanager.h"
+#include "timeline.h"
 
 #include <QFont>
 #include <QMainWindow>
@@ -47,16 +48,34 @@ public:
     explicit MainWindow(QWidget *parent = 0, const QString &session = "");
     ~MainWindow();
 
+    static MainWindow *openWindow(const QString &session);
+    static QList<MainWindow *> windows();
+
+    /**
+     * @brief Session and device, tells the ports of the windows apart
+     */
+    QString portLabel() const;
+    const TimelineIndex &timeline() const { return m_timeline; }
+
+    /**
+     * @brief Record the received lines for the timeline in all windows,
+     *  only while a timeline is shown. Stopping frees the lines recorded.
+     */
+    static void setTimelineRecording(bool record);
+
 protected:
     bool eventFilter(QObject *obj, QEvent *event);
+    void changeEvent(QEvent *event);
 
 private:
     void openDevice();
     void closeDevice();
     void processData();
     void handleError(QSerialPort::SerialPortError);
+    void pollControlLines();
     void printDeviceInfo();
     void showAboutMsg();
+    void openSessionWindow();
     void setHexOutputFormat(bool checked);
     void saveCommandHistory();
 
@@ -72,6 +91,7 @@ protected:
     void execCmd();
     void commandFromHistoryClicked(QListWidgetItem *item);
     bool sendString(const QString &s);
+    bool sendData(QByteArray data, unsigned long charDelay);
     bool sendByte(const char c, unsigned long delay);
     void sendKey();
     void sendFile();
@@ -90,10 +110,20 @@ protected slots:
      */
     void setDTRLineState(int checked);
 
+    /**
+     * @brief Handles PluginManager::controlPort signal, a plugin changes a setting of the device.
+     */
+    void controlPort(Plugin::PortControl control, int value);
+
 private:
     void toggleLogging(bool start);
+    void toggleTerminal(bool terminal);
     void fillLineTerminationChooser(const Settings::LineTerminator setting = Settings::LF);
     void fillProtocolChooser(const Settings::Protocol setting = Settings::PLAIN);
+    void updateLinebreak();
+    void fillEncodingChooser();
+    void fillIdleGapChooser();
+    void updateIdleGap();
     void killSz();
     void switchSession(const QString &session);
     void updateCommandHistory();
@@ -112,6 +142,11 @@ private:
     char m_previousChar;
     QTime m_timestamp;
     QFile m_logFile;
+    /**
+     * The received lines for the merged timeline of all windows
+     * @brief m_timeline
+     */
+    TimelineIndex m_timeline;
 
     QCompleter *m_commandCompleter;
     QStringListModel *m_command_history_model;
@@ -126,6 +161,14 @@ private:
     QTimer m_keyRepeatTimer;
     char m_keyCode;
 
+    /**
+     * QSerialPort has no signal for changes of the control lines,
+     * they are polled while plugins want to know about them
+     * @brief m_controlLinesTimer
+     */
+    QTimer m_controlLinesTimer;
+    int m_controlLines;
+
     /**
      * @brief m_cmdBufIndex
      */
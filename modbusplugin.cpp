@@ -0,0 +1,223 @@
+/*
+ * Copyright (c) 2026 CuteCom contributors
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 675 Mass Ave, Cambridge, MA 02139, USA.
+ *
+ * For more information on the GPL, please go to:
+ * http://www.gnu.org/copyleft/gpl.html
+ */
+
+#include "modbusplugin.h"
+#include "captureclock.h"
+#include "ui_modbusplugin.h"
+#include <QHeaderView>
+#include <QMessageBox>
+#include <QMutexLocker>
+
+#define TRACE                                                                                                          \
+    if (!debug) {                                                                                                      \
+    } else                                                                                                             \
+        qDebug()
+
+static bool debug = false;
+
+/* oldest rows are dropped beyond this */
+static const int MAX_ROWS = 5000;
+
+ModbusPlugin::ModbusPlugin(QFrame *parent, Settings *settings)
+    : QFrame(parent)
+    , ui(new Ui::ModbusPlugin)
+    , m_settings(settings)
+    , m_transactions(0)
+    , m_exceptions(0)
+    , m_timeouts(0)
+    , m_crcErrors(0)
+{
+    ui->setupUi(this);
+    /* Has QFrame, no injection, decodes on the worker pool. Frame gaps get lost with dropped chunks */
+    m_plugin = new Plugin(this, "Modbus RTU", this);
+    m_plugin->processRx = &ModbusPlugin::processRx;
+    m_plugin->rxAffinity = Plugin::RX_WORKER;
+
+    qRegisterMetaType<QVector<ModbusRtu::Transaction>>();
+
+    ui->m_table_transactions->horizontalHeader()->setSectionResizeMode(QHeaderView::ResizeToContents);
+    ui->m_table_transactions->horizontalHeader()->setStretchLastSection(true);
+    ui->m_table_transactions->verticalHeader()->hide();
+    sessionChanged(m_settings->getCurrentSession());
+
+    connect(ui->m_bt_unload, &QPushButton::clicked, this, &ModbusPlugin::removePlugin);
+    connect(ui->m_bt_help, &QPushButton::clicked, this, &ModbusPlugin::helpMsg);
+    connect(ui->m_bt_clear, &QPushButton::clicked, this, [=]() {
+        ui->m_table_transactions->setRowCount(0);
+        m_transactions = m_exceptions = m_timeouts = m_crcErrors = 0;
+        QMutexLocker lock(&m_decoderMutex);
+        m_framer.reset();
+        m_decoder.reset();
+        lock.unlock();
+        updateStatistics();
+    });
+    connect(m_settings, &Settings::sessionChanged, this, &ModbusPlugin::sessionChanged);
+    /* queued, the transactions are emitted from the worker pool */
+    connect(this, &ModbusPlugin::transactionsDecoded, this, &ModbusPlugin::appendTransactions,
+            Qt::QueuedConnection);
+    connect(&m_flushTimer, &QTimer::timeout, this, &ModbusPlugin::flushDecoder);
+    m_flushTimer.start(50);
+
+    TRACE << "[ModbusPlugin::ModbusPlugin]";
+}
+
+ModbusPlugin::~ModbusPlugin() { delete ui; }
+
+/**
+ * @brief Called by the plugin manager on the worker pool with the
+ *  received data. The transactions of a chunk are handed to the GUI at once.
+ */
+void ModbusPlugin::processRx(QObject *owner, const QByteArray &data, qint64 timestamp)
+{
+    ModbusPlugin *self = static_cast<ModbusPlugin *>(owner);
+    QVector<ModbusRtu::Transaction> transactions;
+    {
+        QMutexLocker lock(&self->m_decoderMutex);
+        self->m_framer.feed(data.constData(), data.size(), timestamp, [&](const ModbusRtu::Frame &frame) {
+            self->m_decoder.process(frame,
+                                    [&](const ModbusRtu::Transaction &transaction) { transactions.append(transaction); });
+        });
+    }
+    if (!transactions.isEmpty())
+        emit self->transactionsDecoded(transactions);
+}
+
+/**
+ * @brief The gap detection needs the line timing of the session in use
+ */
+void ModbusPlugin::sessionChanged(const Settings::Session &session)
+{
+    QMutexLocker lock(&m_decoderMutex);
+    m_framer.setLine(session.baudRate, session.characterTime());
+    const qint64 gapTime = m_framer.gapTime();
+    lock.unlock();
+    ui->m_lbl_gap->setText(tr("gap %1 ms").arg(gapTime / 1000000.0, 0, 'f', 2));
+}
+
+void ModbusPlugin::flushDecoder()
+{
+    if (m_rxQueue && !m_rxQueue->isIdle())
+        return;
+
+    QVector<ModbusRtu::Transaction> transactions;
+    const qint64 now = CaptureClock::nsecsElapsed();
+    {
+        QMutexLocker lock(&m_decoderMutex);
+        auto onTransaction = [&](const ModbusRtu::Transaction &transaction) { transactions.append(transaction); };
+        m_framer.flush(now, [&](const ModbusRtu::Frame &frame) { m_decoder.process(frame, onTransaction); });
+        m_decoder.flush(now, onTransaction);
+    }
+    if (!transactions.isEmpty())
+        appendTransactions(transactions);
+}
+
+void ModbusPlugin::appendTransactions(QVector<ModbusRtu::Transaction> transactions)
+{
+    QTableWidget *table = ui->m_table_transactions;
+    table->setUpdatesEnabled(false);
+    foreach (const ModbusRtu::Transaction &transaction, transactions) {
+        m_transactions++;
+        QString status;
+        switch (transaction.status) {
+        case ModbusRtu::Transaction::OK:
+            status = tr("OK");
+            break;
+        case ModbusRtu::Transaction::EXCEPTION:
+            status = tr("Exception");
+            m_exceptions++;
+            break;
+        case ModbusRtu::Transaction::NO_RESPONSE:
+            status = tr("No response");
+            m_timeouts++;
+            break;
+        case ModbusRtu::Transaction::CRC_ERROR:
+            status = tr("CRC error");
+            m_crcErrors++;
+            break;
+        case ModbusRtu::Transaction::BROADCAST:
+            status = tr("Broadcast");
+            break;
+        }
+
+        const int row = table->rowCount();
+        table->insertRow(row);
+        table->setItem(row, COL_TIME,
+                       new QTableWidgetItem(CaptureClock::toTime(transaction.start).toString("HH:mm:ss.zzz")));
+        table->setItem(row, COL_SLAVE, new QTableWidgetItem(QString::number(transaction.slave)));
+        table->setItem(row, COL_FUNCTION, new QTableWidgetItem(ModbusRtuDecoder::functionName(transaction.function)));
+        QTableWidgetItem *request = new QTableWidgetItem(ModbusRtuDecoder::describe(transaction.request, false));
+        request->setToolTip(QString(transaction.request.toHex()));
+        table->setItem(row, COL_REQUEST, request);
+        QTableWidgetItem *response = new QTableWidgetItem(ModbusRtuDecoder::describe(transaction.response, true));
+        response->setToolTip(QString(transaction.response.toHex()));
+        table->setItem(row, COL_RESPONSE, response);
+        table->setItem(row, COL_LATENCY,
+                       new QTableWidgetItem(transaction.latency < 0
+                                                ? QString()
+                                                : QString::number(transaction.latency / 1000000.0, 'f', 2)));
+        table->setItem(row, COL_STATUS, new QTableWidgetItem(status));
+    }
+    while (table->rowCount() > MAX_ROWS)
+        table->removeRow(0);
+    table->setUpdatesEnabled(true);
+    table->scrollToBottom();
+    updateStatistics();
+}
+
+void ModbusPlugin::updateStatistics()
+{
+    ui->m_lbl_statistics->setText(tr("%1 transactions\n%2 exceptions\n%3 timeouts\n%4 CRC errors")
+                                      .arg(m_transactions)
+                                      .arg(m_exceptions)
+                                      .arg(m_timeouts)
+                                      .arg(m_crcErrors));
+}
+
+/**
+ * @brief Return a pointer to the plugin data
+ * @return
+ */
+const Plugin *ModbusPlugin::plugin() { return m_plugin; }
+
+/**
+ * @brief [SLOT] Send unload command to the plugin manager
+ */
+void ModbusPlugin::removePlugin(bool) { emit unload(m_plugin); }
+
+/**
+ * @brief Help message for the Modbus RTU plugin
+ */
+void ModbusPlugin::helpMsg(void)
+{
+    QString help_str = tr("This plugin decodes Modbus RTU traffic and shows one\n"
+                          "row per request/response pair with the slave, the\n"
+                          "function, the decoded fields and the response latency.\n\n"
+                          "Frames are separated by a silent interval of 3.5\n"
+                          "character times, calculated from the baud rate and the\n"
+                          "character format of the session (1.75 ms above 19200\n"
+                          "baud). Frames that arrive in the same read are split\n"
+                          "where their CRC matches.\n\n"
+                          "USB serial adapters deliver the data in chunks, their\n"
+                          "latency timer (often 16 ms) limits how precise gaps\n"
+                          "and latencies can be measured.\n");
+
+    QMessageBox::information(this, tr("How to use the Modbus RTU analyzer"), help_str);
+}
@@ -0,0 +1,100 @@
+/*
+ * Copyright (c) 2026 CuteCom contributors
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 675 Mass Ave, Cambridge, MA 02139, USA.
+ *
+ * For more information on the GPL, please go to:
+ * http://www.gnu.org/copyleft/gpl.html
+ */
+
+#ifndef MODBUSPLUGIN_H
+#define MODBUSPLUGIN_H
+
+#include "modbusrtu.h"
+#include "plugin.h"
+#include "pluginrxqueue.h"
+#include "settings.h"
+#include <QDebug>
+#include <QFrame>
+#include <QMutex>
+#include <QPointer>
+#include <QTimer>
+#include <QVector>
+
+namespace Ui
+{
+class ModbusPlugin;
+}
+
+class ModbusPlugin : public QFrame
+{
+    Q_OBJECT
+
+public:
+    explicit ModbusPlugin(QFrame *parent, Settings *settings);
+    ~ModbusPlugin();
+    const Plugin *plugin();
+    void setRxQueue(const PluginRxQueue *queue) { m_rxQueue = queue; }
+
+signals:
+    void unload(Plugin *);
+    /* decoder (worker thread) -> table */
+    void transactionsDecoded(QVector<ModbusRtu::Transaction> transactions);
+
+public slots:
+    void removePlugin(bool);
+    void helpMsg(void);
+
+private slots:
+    void sessionChanged(const Settings::Session &session);
+    void flushDecoder();
+    void appendTransactions(QVector<ModbusRtu::Transaction> transactions);
+
+private:
+    enum Columns { COL_TIME, COL_SLAVE, COL_FUNCTION, COL_REQUEST, COL_RESPONSE, COL_LATENCY, COL_STATUS };
+
+    static void processRx(QObject *owner, const QByteArray &data, qint64 timestamp);
+    void updateStatistics();
+
+    Ui::ModbusPlugin *ui;
+    Plugin *m_plugin;
+    Settings *m_settings;
+    /**
+     * Framer and decoder run on the worker pool, the GUI
+     * touches them to flush idle lines and change the timing
+     * @brief m_decoderMutex
+     */
+    QMutex m_decoderMutex;
+    ModbusRtuFramer m_framer;
+    ModbusRtuDecoder m_decoder;
+    /**
+     * Closes the last frame and times out unanswered requests
+     * when nothing is received anymore
+     * @brief m_flushTimer
+     */
+    QTimer m_flushTimer;
+    /**
+     * Chunks still queued for the worker may continue the pending
+     * frame, it is not flushed before they are through
+     * @brief m_rxQueue
+     */
+    QPointer<const PluginRxQueue> m_rxQueue;
+    quint64 m_transactions;
+    quint64 m_exceptions;
+    quint64 m_timeouts;
+    quint64 m_crcErrors;
+};
+
+#endif // MODBUSPLUGIN_H
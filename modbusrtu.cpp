@@ -0,0 +1,203 @@
+/*
+ * Copyright (c) 2026 CuteCom contributors
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 675 Mass Ave, Cambridge, MA 02139, USA.
+ *
+ * For more information on the GPL, please go to:
+ * http://www.gnu.org/copyleft/gpl.html
+ */
+
+#include "modbusrtu.h"
+#include <QObject>
+#include <QStringList>
+
+namespace
+{
+struct CrcTable {
+    quint16 entry[256];
+    CrcTable()
+    {
+        for (int i = 0; i < 256; i++) {
+            quint16 crc = i;
+            for (int bit = 0; bit < 8; bit++)
+                crc = (crc & 1) ? (crc >> 1) ^ 0xa001 : crc >> 1;
+            entry[i] = crc;
+        }
+    }
+};
+const CrcTable crcTable;
+
+quint16 word(const QByteArray &frame, int pos)
+{
+    return (static_cast<uchar>(frame.at(pos)) << 8) | static_cast<uchar>(frame.at(pos + 1));
+}
+}
+
+quint16 ModbusRtu::crc16Update(quint16 crc, uchar byte) { return (crc >> 8) ^ crcTable.entry[(crc ^ byte) & 0xff]; }
+
+quint16 ModbusRtu::crc16(const char *data, int len, quint16 crc)
+{
+    const uchar *p = reinterpret_cast<const uchar *>(data);
+    for (int i = 0; i < len; i++)
+        crc = (crc >> 8) ^ crcTable.entry[(crc ^ p[i]) & 0xff];
+    return crc;
+}
+
+ModbusRtuFramer::ModbusRtuFramer()
+    : m_characterTime(0)
+    , m_gapTime(0)
+    , m_readLatency(20000000)
+    , m_frameStart(0)
+    , m_lastEnd(0)
+{
+    setLine(9600, 11 * 1000000000LL / 9600);
+}
+
+void ModbusRtuFramer::setLine(quint32 baudRate, qint64 characterTime)
+{
+    m_characterTime = characterTime;
+    // the spec recommends fixed timing above 19200 baud
+    m_gapTime = baudRate > 19200 ? 1750000 : characterTime * 7 / 2;
+}
+
+void ModbusRtuFramer::reset()
+{
+    m_frame.resize(0);
+    m_lastEnd = 0;
+}
+
+ModbusRtuDecoder::ModbusRtuDecoder()
+    : m_pending(false)
+    , m_requestEnd(0)
+    , m_responseTimeout(1000000000)
+{
+}
+
+QString ModbusRtuDecoder::functionName(quint8 function)
+{
+    switch (function & 0x7f) {
+    case 1:
+        return QObject::tr("Read Coils");
+    case 2:
+        return QObject::tr("Read Discrete Inputs");
+    case 3:
+        return QObject::tr("Read Holding Registers");
+    case 4:
+        return QObject::tr("Read Input Registers");
+    case 5:
+        return QObject::tr("Write Single Coil");
+    case 6:
+        return QObject::tr("Write Single Register");
+    case 7:
+        return QObject::tr("Read Exception Status");
+    case 8:
+        return QObject::tr("Diagnostics");
+    case 15:
+        return QObject::tr("Write Multiple Coils");
+    case 16:
+        return QObject::tr("Write Multiple Registers");
+    case 17:
+        return QObject::tr("Report Server ID");
+    case 23:
+        return QObject::tr("Read/Write Multiple Registers");
+    default:
+        return QObject::tr("Function %1").arg(function & 0x7f);
+    }
+}
+
+QString ModbusRtuDecoder::exceptionName(quint8 code)
+{
+    switch (code) {
+    case 1:
+        return QObject::tr("Illegal Function");
+    case 2:
+        return QObject::tr("Illegal Data Address");
+    case 3:
+        return QObject::tr("Illegal Data Value");
+    case 4:
+        return QObject::tr("Server Device Failure");
+    case 5:
+        return QObject::tr("Acknowledge");
+    case 6:
+        return QObject::tr("Server Device Busy");
+    case 8:
+        return QObject::tr("Memory Parity Error");
+    case 10:
+        return QObject::tr("Gateway Path Unavailable");
+    case 11:
+        return QObject::tr("Gateway Target Failed To Respond");
+    default:
+        return QObject::tr("Exception %1").arg(code);
+    }
+}
+
+/**
+ * Decodes the fields of the common function codes, everything
+ * else is shown as hex. The CRC is not part of the description.
+ */
+QString ModbusRtuDecoder::describe(const QByteArray &frame, bool response)
+{
+    if (frame.size() < 4)
+        return QString(frame.toHex());
+
+    const quint8 function = static_cast<quint8>(frame.at(1));
+    const QByteArray pdu = frame.mid(2, frame.size() - 4);
+    if (function & 0x80)
+        return pdu.isEmpty() ? QString() : exceptionName(static_cast<quint8>(pdu.at(0)));
+
+    switch (function) {
+    case 1:
+    case 2:
+    case 3:
+    case 4:
+        if (!response && pdu.size() == 4)
+            return QObject::tr("start %1, count %2").arg(word(pdu, 0)).arg(word(pdu, 2));
+        if (response && !pdu.isEmpty() && (function == 3 || function == 4)) {
+            QStringList values;
+            for (int i = 1; i + 1 < pdu.size(); i += 2)
+                values << QString::number(word(pdu, i));
+            return values.join(' ');
+        }
+        if (response && !pdu.isEmpty())
+            return QString(pdu.mid(1).toHex());
+        break;
+    case 5:
+        if (pdu.size() == 4)
+            return QObject::tr("coil %1 %2").arg(word(pdu, 0)).arg(word(pdu, 2) ? "ON" : "OFF");
+        break;
+    case 6:
+        if (pdu.size() == 4)
+            return QObject::tr("register %1 = %2").arg(word(pdu, 0)).arg(word(pdu, 2));
+        break;
+    case 15:
+    case 16:
+        if (response && pdu.size() == 4)
+            return QObject::tr("start %1, count %2").arg(word(pdu, 0)).arg(word(pdu, 2));
+        if (!response && pdu.size() >= 5) {
+            QString text = QObject::tr("start %1, count %2").arg(word(pdu, 0)).arg(word(pdu, 2));
+            if (function == 16) {
+                QStringList values;
+                for (int i = 5; i + 1 < pdu.size(); i += 2)
+                    values << QString::number(word(pdu, i));
+                text += QStringLiteral(": ") + values.join(' ');
+            }
+            return text;
+        }
+        break;
+    default:
+        break;
+    }
+    return QString(pdu.toHex());
+}
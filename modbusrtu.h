@@ -0,0 +1,287 @@
+/*
+ * Copyright (c) 2026 CuteCom contributors
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 675 Mass Ave, Cambridge, MA 02139, USA.
+ *
+ * For more information on the GPL, please go to:
+ * http://www.gnu.org/copyleft/gpl.html
+ */
+
+/**
+ * Modbus RTU analysis: frame detection, CRC check and decoding.
+ *
+ * RTU frames are delimited by silence of at least 3.5 character times
+ * (1.75 ms above 19200 baud). ModbusRtuFramer estimates when every chunk
+ * started on the line from the time it has been read and its transmission
+ * time, and closes a frame when the gap to the previous chunk is long
+ * enough. Frames that ended up in one read are separated by their CRC:
+ * the CRC over a frame including its checksum is zero, so the running CRC
+ * shows every possible frame end.
+ *
+ * ModbusRtuDecoder pairs requests with their responses and decodes the
+ * common function codes.
+ */
+
+#ifndef MODBUSRTU_H
+#define MODBUSRTU_H
+
+#include <QByteArray>
+#include <QMetaType>
+#include <QString>
+
+namespace ModbusRtu
+{
+/**
+ * @brief Table driven CRC-16/MODBUS
+ */
+quint16 crc16(const char *data, int len, quint16 crc = 0xffff);
+quint16 crc16Update(quint16 crc, uchar byte);
+
+struct Frame {
+    QByteArray data;
+    /* estimated CaptureClock times of the first and the end of the last byte on the line */
+    qint64 start;
+    qint64 end;
+    bool crcOk;
+};
+
+struct Transaction {
+    enum Status { OK, EXCEPTION, NO_RESPONSE, CRC_ERROR, BROADCAST };
+
+    Transaction()
+        : slave(0)
+        , function(0)
+        , start(0)
+        , latency(-1)
+        , status(OK)
+    {
+    }
+    quint8 slave;
+    quint8 function;
+    QByteArray request;
+    QByteArray response;
+    /* start of the request */
+    qint64 start;
+    /* from the end of the request to the start of the response, -1 without response */
+    qint64 latency;
+    Status status;
+};
+}
+
+Q_DECLARE_METATYPE(ModbusRtu::Transaction)
+
+class ModbusRtuFramer
+{
+public:
+    ModbusRtuFramer();
+
+    /**
+     * @brief Set the line timing
+     * @param baudRate Baud rate of the line
+     * @param characterTime Time to transmit one character in ns
+     */
+    void setLine(quint32 baudRate, qint64 characterTime);
+    qint64 gapTime() const { return m_gapTime; }
+
+    /**
+     * @brief Time the data may take from the line until they are fed, e.g.
+     *  the latency timer of USB adapters. flush() waits this long on top of
+     *  the gap, so a frame arriving in several reads is not cut apart.
+     */
+    void setReadLatency(qint64 ns) { m_readLatency = ns; }
+    qint64 readLatency() const { return m_readLatency; }
+    void reset();
+
+    /**
+     * @brief Feed one chunk as it has been read
+     * @param timestamp CaptureClock time of the read
+     * @param onFrame Called as onFrame(const ModbusRtu::Frame &)
+     */
+    template <typename Callback> void feed(const char *data, int len, qint64 timestamp, Callback onFrame);
+
+    /**
+     * @brief Close the pending frame if nothing has been received for the
+     *  gap time plus the read latency
+     * @param now The current CaptureClock time
+     */
+    template <typename Callback> void flush(qint64 now, Callback onFrame);
+
+private:
+    template <typename Callback> void finish(Callback &onFrame);
+
+    qint64 m_characterTime;
+    qint64 m_gapTime;
+    qint64 m_readLatency;
+    QByteArray m_frame;
+    qint64 m_frameStart;
+    /* end of the last byte received */
+    qint64 m_lastEnd;
+};
+
+class ModbusRtuDecoder
+{
+public:
+    ModbusRtuDecoder();
+
+    /**
+     * @brief Time after which a request counts as unanswered
+     */
+    void setResponseTimeout(qint64 ns) { m_responseTimeout = ns; }
+    void reset() { m_pending = false; }
+
+    /**
+     * @brief Process a frame
+     * @param onTransaction Called as onTransaction(const ModbusRtu::Transaction &)
+     *  for every completed request/response pair or broken frame
+     */
+    template <typename Callback> void process(const ModbusRtu::Frame &frame, Callback onTransaction);
+
+    /**
+     * @brief Give up on a request that has not been answered in time
+     */
+    template <typename Callback> void flush(qint64 now, Callback onTransaction);
+
+    static QString functionName(quint8 function);
+    static QString exceptionName(quint8 code);
+    /**
+     * @brief Human readable content of a request or response
+     */
+    static QString describe(const QByteArray &frame, bool response);
+
+private:
+    bool m_pending;
+    ModbusRtu::Transaction m_request;
+    qint64 m_requestEnd;
+    qint64 m_responseTimeout;
+};
+
+template <typename Callback> void ModbusRtuFramer::finish(Callback &onFrame)
+{
+    const int size = m_frame.size();
+    const char *data = m_frame.constData();
+
+    ModbusRtu::Frame frame;
+    if (ModbusRtu::crc16(data, size) == 0 && size >= 4) {
+        frame.data = m_frame;
+        frame.start = m_frameStart;
+        frame.end = m_frameStart + size * m_characterTime;
+        frame.crcOk = true;
+        onFrame(frame);
+        m_frame.resize(0);
+        return;
+    }
+
+    // several frames without a detectable gap: split where the CRC matches
+    int pos = 0;
+    while (pos < size) {
+        int end = -1;
+        quint16 crc = 0xffff;
+        for (int i = pos; i < size; i++) {
+            crc = ModbusRtu::crc16Update(crc, static_cast<uchar>(data[i]));
+            if (crc == 0 && i - pos >= 3) {
+                end = i + 1;
+                break;
+            }
+        }
+        frame.crcOk = end >= 0;
+        if (end < 0)
+            end = size;
+        frame.data = QByteArray(data + pos, end - pos);
+        frame.start = m_frameStart + pos * m_characterTime;
+        frame.end = m_frameStart + end * m_characterTime;
+        onFrame(frame);
+        pos = end;
+    }
+    m_frame.resize(0);
+}
+
+template <typename Callback>
+void ModbusRtuFramer::feed(const char *data, int len, qint64 timestamp, Callback onFrame)
+{
+    if (len <= 0)
+        return;
+    // the read happens right after the last byte, so this is when the first one started
+    qint64 start = timestamp - len * m_characterTime;
+    if (start < m_lastEnd)
+        start = m_lastEnd; // the chunk has been delayed, e.g. by the driver
+    if (!m_frame.isEmpty() && start - m_lastEnd >= m_gapTime)
+        finish(onFrame);
+    if (m_frame.isEmpty())
+        m_frameStart = start;
+    m_frame.append(data, len);
+    m_lastEnd = start + len * m_characterTime;
+}
+
+template <typename Callback> void ModbusRtuFramer::flush(qint64 now, Callback onFrame)
+{
+    if (!m_frame.isEmpty() && now - m_lastEnd >= m_gapTime + m_readLatency)
+        finish(onFrame);
+}
+
+template <typename Callback>
+void ModbusRtuDecoder::process(const ModbusRtu::Frame &frame, Callback onTransaction)
+{
+    if (!frame.crcOk || frame.data.size() < 4) {
+        ModbusRtu::Transaction broken;
+        broken.slave = frame.data.isEmpty() ? 0 : static_cast<quint8>(frame.data.at(0));
+        broken.function = frame.data.size() < 2 ? 0 : static_cast<quint8>(frame.data.at(1));
+        broken.request = frame.data;
+        broken.start = frame.start;
+        broken.status = ModbusRtu::Transaction::CRC_ERROR;
+        onTransaction(broken);
+        return;
+    }
+
+    const quint8 slave = static_cast<quint8>(frame.data.at(0));
+    const quint8 function = static_cast<quint8>(frame.data.at(1));
+    if (m_pending && slave == m_request.slave && (function & 0x7f) == m_request.function) {
+        m_request.response = frame.data;
+        m_request.latency = frame.start - m_requestEnd;
+        m_request.status = (function & 0x80) ? ModbusRtu::Transaction::EXCEPTION : ModbusRtu::Transaction::OK;
+        m_pending = false;
+        onTransaction(m_request);
+        return;
+    }
+
+    if (m_pending) {
+        m_request.status = ModbusRtu::Transaction::NO_RESPONSE;
+        m_pending = false;
+        onTransaction(m_request);
+    }
+    m_request = ModbusRtu::Transaction();
+    m_request.slave = slave;
+    m_request.function = function;
+    m_request.request = frame.data;
+    m_request.start = frame.start;
+    m_requestEnd = frame.end;
+    if (slave == 0) {
+        // broadcasts are never answered
+        m_request.status = ModbusRtu::Transaction::BROADCAST;
+        onTransaction(m_request);
+    } else {
+        m_pending = true;
+    }
+}
+
+template <typename Callback> void ModbusRtuDecoder::flush(qint64 now, Callback onTransaction)
+{
+    if (m_pending && now - m_requestEnd > m_responseTimeout) {
+        m_request.status = ModbusRtu::Transaction::NO_RESPONSE;
+        m_pending = false;
+        onTransaction(m_request);
+    }
+}
+
+#endif // MODBUSRTU_H
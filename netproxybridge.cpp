@@ -0,0 +1,577 @@
+/*
+ * Copyright (c) 2026 CuteCom contributors
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 675 Mass Ave, Cambridge, MA 02139, USA.
+ *
+ * For more information on the GPL, please go to:
+ * http://www.gnu.org/copyleft/gpl.html
+ */
+
+#include "netproxybridge.h"
+
+#include "captureclock.h"
+#include "plugin.h"
+
+#include <QDebug>
+#include <QSerialPort>
+#include <QtEndian>
+
+#define TRACE                                                                                                          \
+    if (!debug) {                                                                                                      \
+    } else                                                                                                             \
+        qDebug()
+static bool debug = false;
+
+NetProxyBridge::NetProxyBridge(QObject *parent)
+    : QObject(parent)
+    , m_udp(new QUdpSocket(this))
+    , m_udp_remote_port(0)
+    , m_udpMaxDatagram(1472)
+    , m_udpMaxLatency(0)
+    , m_udpHeader(false)
+    , m_udpTimestamp(0)
+    , m_udpSequence(0)
+    , m_udpTimer(new QTimer(this))
+    , m_tcp(new QTcpServer(this))
+    , m_policy(DROP_OLDEST)
+    , m_queueLimit(256 * 1024)
+    , m_rfc2217(false)
+    , m_lines(-1)
+    , m_statisticsTimer(new QTimer(this))
+{
+    connect(m_udp, &QUdpSocket::readyRead, this, &NetProxyBridge::recvUDP);
+    connect(m_udp, static_cast<void (QUdpSocket::*)(QAbstractSocket::SocketError)>(&QAbstractSocket::error), this,
+            &NetProxyBridge::errorUdpSocket);
+    connect(m_tcp, &QTcpServer::newConnection, this, &NetProxyBridge::addTcpClient);
+    connect(m_tcp, &QTcpServer::acceptError, this, &NetProxyBridge::errorTcpSocket);
+    connect(m_statisticsTimer, &QTimer::timeout, this, &NetProxyBridge::updateStatistics);
+    /* the max. latency may be a few ms only */
+    m_udpTimer->setSingleShot(true);
+    m_udpTimer->setTimerType(Qt::PreciseTimer);
+    connect(m_udpTimer, &QTimer::timeout, this, &NetProxyBridge::flushUdp);
+    m_udpBuffer.reserve(m_udpMaxDatagram);
+
+    m_trafficClock.start();
+    for (int i = 0; i < NUMBER_OF_TRAFFIC; i++)
+        m_lastTraffic[i] = -TRAFFIC_INTERVAL_MS;
+}
+
+NetProxyBridge::~NetProxyBridge()
+{
+    foreach (Client *client, m_clients) {
+        client->socket->disconnect(this);
+        delete client->telnet;
+        delete client;
+    }
+}
+
+void NetProxyBridge::bindUdp(const QString &localAddress, quint16 localPort, const QString &remoteAddress,
+                             quint16 remotePort)
+{
+    QHostAddress l_addr(localAddress);
+    if (m_udp->bind(l_addr, localPort)) {
+        /* store udp details */
+        m_udp_remote_addr = QHostAddress(remoteAddress);
+        m_udp_remote_port = remotePort;
+        m_udpSequence = 0;
+        QString status(QString("%1 : %2").arg(l_addr.toString()).arg(QString::number(localPort)));
+        emit udpStatus(true, status);
+        TRACE << "[NetProxyBridge] UDP bind " << status;
+    } else {
+        m_udp_remote_addr.clear();
+        emit error(tr("Could not bind UDP socket!"));
+    }
+}
+
+void NetProxyBridge::unbindUdp()
+{
+    m_udpTimer->stop();
+    m_udpBuffer.resize(0);
+    m_udp->close();
+    m_udp_remote_addr.clear();
+    m_udp_remote_port = 0;
+    emit udpStatus(false, QString(tr("Not used")));
+    TRACE << "[NetProxyBridge] UDP unbind";
+}
+
+void NetProxyBridge::setUdpCoalescing(int maxDatagram, int maxLatency, bool header)
+{
+    // the held back data go out as they were coalesced
+    flushUdp();
+    m_udpMaxDatagram = qBound<int>(UDP_HEADER_SIZE + 1, maxDatagram, UDP_MAX_DATAGRAM);
+    m_udpMaxLatency = qMax(0, maxLatency);
+    m_udpHeader = header;
+    m_udpBuffer.reserve(m_udpMaxDatagram);
+    TRACE << "[NetProxyBridge] UDP coalescing" << m_udpMaxDatagram << m_udpMaxLatency << m_udpHeader;
+}
+
+void NetProxyBridge::startTcpServer(quint16 port)
+{
+    if (!m_tcp->listen(QHostAddress::Any, port)) {
+        emit error(tr("Could not start TCP server.\n%1.").arg(m_tcp->errorString()));
+        return;
+    }
+    emit tcpStatus(true, tr("Listening on: %1").arg(QString::number(port)));
+}
+
+void NetProxyBridge::stopTcpServer()
+{
+    m_tcp->close();
+    emit tcpStatus(false, QString(tr("Not used")));
+}
+
+void NetProxyBridge::setQueuePolicy(int policy, qint64 limit)
+{
+    m_policy = static_cast<QueuePolicy>(policy);
+    m_queueLimit = limit;
+    TRACE << "[NetProxyBridge::setQueuePolicy]" << policy << limit;
+}
+
+void NetProxyBridge::setRfc2217(bool enable)
+{
+    m_rfc2217 = enable;
+    TRACE << "[NetProxyBridge::setRfc2217]" << enable;
+}
+
+void NetProxyBridge::setPortState(quint32 baudRate, int dataBits, int parity, int stopBits, int flowControl)
+{
+    m_port.baudRate = baudRate;
+    m_port.dataSize = quint8(dataBits);
+    switch (parity) {
+    case QSerialPort::OddParity:
+        m_port.parity = Rfc2217Server::PARITY_ODD;
+        break;
+    case QSerialPort::EvenParity:
+        m_port.parity = Rfc2217Server::PARITY_EVEN;
+        break;
+    case QSerialPort::MarkParity:
+        m_port.parity = Rfc2217Server::PARITY_MARK;
+        break;
+    case QSerialPort::SpaceParity:
+        m_port.parity = Rfc2217Server::PARITY_SPACE;
+        break;
+    default:
+        m_port.parity = Rfc2217Server::PARITY_NONE;
+        break;
+    }
+    switch (stopBits) {
+    case QSerialPort::TwoStop:
+        m_port.stopSize = Rfc2217Server::STOPSIZE_2;
+        break;
+    case QSerialPort::OneAndHalfStop:
+        m_port.stopSize = Rfc2217Server::STOPSIZE_1_5;
+        break;
+    default:
+        m_port.stopSize = Rfc2217Server::STOPSIZE_1;
+        break;
+    }
+    switch (flowControl) {
+    case QSerialPort::HardwareControl:
+        m_port.flowControl = Rfc2217Server::CONTROL_FLOW_HARDWARE;
+        break;
+    case QSerialPort::SoftwareControl:
+        m_port.flowControl = Rfc2217Server::CONTROL_FLOW_XONXOFF;
+        break;
+    default:
+        m_port.flowControl = Rfc2217Server::CONTROL_FLOW_NONE;
+        break;
+    }
+}
+
+void NetProxyBridge::controlLines(int lines)
+{
+    m_lines = lines;
+    // the outputs as set by the control panel, a plugin or a client
+    m_port.dtr = lines & QSerialPort::DataTerminalReadySignal;
+    m_port.rts = lines & QSerialPort::RequestToSendSignal;
+    foreach (Client *client, m_clients) {
+        if (!client->telnet)
+            continue;
+        const QByteArray notification = client->telnet->notifyModemState(lines);
+        if (!notification.isEmpty())
+            client->socket->write(notification);
+    }
+}
+
+void NetProxyBridge::setBreakEnabled(bool enable) { m_port.breakOn = enable; }
+
+/**
+ * @brief Hand a request of an RFC 2217 client to the device
+ * @param value The value in effect after the request
+ */
+void NetProxyBridge::applyRequest(const Rfc2217Server::Request &request, quint32 value)
+{
+    switch (request.command) {
+    case Rfc2217Server::SET_BAUDRATE:
+        emit controlPort(Plugin::PORT_BAUD_RATE, int(value));
+        break;
+    case Rfc2217Server::SET_DATASIZE:
+        emit controlPort(Plugin::PORT_DATA_BITS, int(value));
+        break;
+    case Rfc2217Server::SET_PARITY: {
+        const int parity[] = {QSerialPort::NoParity,   QSerialPort::NoParity,   QSerialPort::OddParity,
+                              QSerialPort::EvenParity, QSerialPort::MarkParity, QSerialPort::SpaceParity};
+        emit controlPort(Plugin::PORT_PARITY, parity[value]);
+        break;
+    }
+    case Rfc2217Server::SET_STOPSIZE: {
+        const int stopBits[] = {QSerialPort::OneStop, QSerialPort::OneStop, QSerialPort::TwoStop,
+                                QSerialPort::OneAndHalfStop};
+        emit controlPort(Plugin::PORT_STOP_BITS, stopBits[value]);
+        break;
+    }
+    case Rfc2217Server::SET_CONTROL:
+        switch (value) {
+        case Rfc2217Server::CONTROL_FLOW_NONE:
+            emit controlPort(Plugin::PORT_FLOW_CONTROL, QSerialPort::NoFlowControl);
+            break;
+        case Rfc2217Server::CONTROL_FLOW_XONXOFF:
+            emit controlPort(Plugin::PORT_FLOW_CONTROL, QSerialPort::SoftwareControl);
+            break;
+        case Rfc2217Server::CONTROL_FLOW_HARDWARE:
+            emit controlPort(Plugin::PORT_FLOW_CONTROL, QSerialPort::HardwareControl);
+            break;
+        case Rfc2217Server::CONTROL_BREAK_ON:
+        case Rfc2217Server::CONTROL_BREAK_OFF:
+            emit controlPort(Plugin::PORT_BREAK, value == Rfc2217Server::CONTROL_BREAK_ON);
+            break;
+        case Rfc2217Server::CONTROL_DTR_ON:
+        case Rfc2217Server::CONTROL_DTR_OFF:
+            emit controlPort(Plugin::PORT_DTR, value == Rfc2217Server::CONTROL_DTR_ON);
+            break;
+        case Rfc2217Server::CONTROL_RTS_ON:
+        case Rfc2217Server::CONTROL_RTS_OFF:
+            emit controlPort(Plugin::PORT_RTS, value == Rfc2217Server::CONTROL_RTS_ON);
+            break;
+        }
+        break;
+    case Rfc2217Server::PURGE_DATA:
+        if (value == Rfc2217Server::PURGE_RX)
+            emit controlPort(Plugin::PORT_PURGE, QSerialPort::Input);
+        else if (value == Rfc2217Server::PURGE_TX)
+            emit controlPort(Plugin::PORT_PURGE, QSerialPort::Output);
+        else if (value == Rfc2217Server::PURGE_BOTH)
+            emit controlPort(Plugin::PORT_PURGE, QSerialPort::AllDirections);
+        break;
+    default:
+        break;
+    }
+}
+
+void NetProxyBridge::errorUdpSocket(QAbstractSocket::SocketError err)
+{
+    const QString message = m_udp->errorString();
+    unbindUdp();
+    if (err) {
+        emit error(tr("UDP socket error: %1.").arg(message));
+    }
+}
+
+void NetProxyBridge::errorTcpSocket(QAbstractSocket::SocketError err)
+{
+    const QString message = m_tcp->errorString();
+    stopTcpServer();
+    if (err) {
+        emit error(tr("TCP socket error: %1.").arg(message));
+    }
+}
+
+void NetProxyBridge::recvUDP()
+{
+    while (m_udp->hasPendingDatagrams()) {
+        QByteArray datagram;
+        QHostAddress sender;
+        quint16 senderPort;
+
+        datagram.resize(m_udp->pendingDatagramSize());
+        m_udp->readDatagram(datagram.data(), datagram.size(), &sender, &senderPort);
+
+        emit sendCmd(datagram);
+        notifyTraffic(UDP_RX);
+    }
+}
+
+void NetProxyBridge::addTcpClient()
+{
+    while (m_tcp->hasPendingConnections()) {
+        Client *client = new Client;
+        client->socket = m_tcp->nextPendingConnection();
+        client->telnet = m_rfc2217 ? new Rfc2217Server : NULL;
+        client->peer = QString("%1:%2").arg(client->socket->peerAddress().toString()).arg(client->socket->peerPort());
+        client->queued = 0;
+        client->sent = 0;
+        client->sentBefore = 0;
+        client->drops = 0;
+        client->dropped = 0;
+        connect(client->socket, &QTcpSocket::disconnected, this, &NetProxyBridge::removeTcpClient);
+        connect(client->socket, &QTcpSocket::readyRead, this, &NetProxyBridge::recvTCP);
+        connect(client->socket, &QTcpSocket::bytesWritten, this, &NetProxyBridge::clientBytesWritten);
+        /* add client to the list */
+        m_clients.append(client);
+        if (client->telnet) {
+            client->socket->write(Rfc2217Server::greeting());
+            // the state the client gets when it polls the modem lines
+            if (m_lines >= 0)
+                client->telnet->notifyModemState(m_lines);
+        }
+        TRACE << "Connected: " << client->peer;
+    }
+    if (!m_statisticsTimer->isActive()) {
+        m_statisticsClock.start();
+        m_statisticsTimer->start(STATISTICS_INTERVAL_MS);
+    }
+}
+
+void NetProxyBridge::recvTCP()
+{
+    QTcpSocket *socket = qobject_cast<QTcpSocket *>(sender());
+    Client *client = findClient(socket);
+    while (socket->bytesAvailable()) {
+        QByteArray recv_data = socket->readAll();
+        if (client && client->telnet) {
+            QByteArray data;
+            QByteArray reply;
+            QVector<Rfc2217Server::Request> requests;
+            client->telnet->feed(recv_data.constData(), recv_data.size(), &data, &reply, &requests);
+            foreach (const Rfc2217Server::Request &request, requests) {
+                const bool query = Rfc2217Server::isQuery(request);
+                const quint32 value = Rfc2217Server::apply(request, &m_port);
+                reply.append(Rfc2217Server::response(request.command, value));
+                if (!query)
+                    applyRequest(request, value);
+                TRACE << "RFC 2217 request: " << request.command << request.value << "->" << value;
+            }
+            // answers go out before the queued data, they never split an escape
+            if (!reply.isEmpty())
+                socket->write(reply);
+            // the client may have suspended or resumed the data
+            drain(client);
+            recv_data = data;
+            if (recv_data.isEmpty())
+                continue;
+        }
+        emit sendCmd(recv_data);
+        notifyTraffic(TCP_RX);
+        TRACE << "TCP in: " << recv_data;
+    }
+}
+
+void NetProxyBridge::removeTcpClient()
+{
+    Client *client = findClient(qobject_cast<QTcpSocket *>(sender()));
+    if (client)
+        removeClient(client);
+}
+
+void NetProxyBridge::removeClient(Client *client)
+{
+    m_clients.removeOne(client);
+    client->socket->disconnect(this);
+    client->socket->deleteLater();
+    TRACE << "Disconnected: " << client->peer;
+    delete client->telnet;
+    delete client;
+}
+
+NetProxyBridge::Client *NetProxyBridge::findClient(QTcpSocket *socket)
+{
+    foreach (Client *client, m_clients) {
+        if (client->socket == socket)
+            return client;
+    }
+    return NULL;
+}
+
+void NetProxyBridge::proxyCmd(const QByteArray &data, qint64 timestamp)
+{
+    if (m_udp->state() == QAbstractSocket::BoundState)
+        sendUdp(data, timestamp);
+    if (m_tcp->isListening() && !m_clients.isEmpty()) {
+        /* send the data to all clients, the slow ones are closed afterwards
+         * as closing a socket removes it from the list */
+        QList<QTcpSocket *> slow;
+        /* Telnet clients get the data escaped, once for all of them */
+        QByteArray escaped;
+        bool isEscaped = false;
+        foreach (Client *client, m_clients) {
+            if (client->telnet && !isEscaped) {
+                escaped = Rfc2217Server::escape(data);
+                isEscaped = true;
+            }
+            if (!enqueue(client, client->telnet ? escaped : data))
+                slow.append(client->socket);
+        }
+        notifyTraffic(TCP_TX);
+        foreach (QTcpSocket *socket, slow) {
+            TRACE << "[NetProxyBridge::proxyCmd] disconnecting slow client" << socket->peerAddress();
+            socket->abort();
+            // abort() normally removes the client through disconnected()
+            Client *client = findClient(socket);
+            if (client)
+                removeClient(client);
+        }
+    }
+    TRACE << "[NetProxyBridge::proxyCmd]: " << data.size();
+}
+
+/**
+ * @brief Coalesce the data into datagrams of m_udpMaxDatagram bytes, the
+ *  last one is sent when it is full or its max. latency has expired
+ */
+void NetProxyBridge::sendUdp(const QByteArray &data, qint64 timestamp)
+{
+    const int header = m_udpHeader ? UDP_HEADER_SIZE : 0;
+    const char *pos = data.constData();
+    const char *end = pos + data.size();
+    while (pos < end) {
+        if (m_udpBuffer.isEmpty()) {
+            // full datagrams without a header don't need the buffer
+            if (!header && end - pos >= m_udpMaxDatagram) {
+                writeDatagram(pos, m_udpMaxDatagram);
+                pos += m_udpMaxDatagram;
+                continue;
+            }
+            m_udpTimestamp = timestamp;
+            m_udpBuffer.resize(header);
+        }
+        const int len = qMin<qint64>(end - pos, m_udpMaxDatagram - m_udpBuffer.size());
+        m_udpBuffer.append(pos, len);
+        pos += len;
+        if (m_udpBuffer.size() == m_udpMaxDatagram)
+            flushUdp();
+    }
+    if (m_udpBuffer.isEmpty())
+        return;
+    if (m_udpMaxLatency == 0)
+        flushUdp();
+    else if (!m_udpTimer->isActive())
+        m_udpTimer->start(m_udpMaxLatency);
+}
+
+void NetProxyBridge::flushUdp()
+{
+    m_udpTimer->stop();
+    if (m_udpBuffer.isEmpty())
+        return;
+    if (m_udpHeader) {
+        uchar *header = reinterpret_cast<uchar *>(m_udpBuffer.data());
+        qToBigEndian<quint32>(m_udpSequence, header);
+        qToBigEndian<quint64>(CaptureClock::toUSecsSinceEpoch(m_udpTimestamp), header + 4);
+    }
+    writeDatagram(m_udpBuffer.constData(), m_udpBuffer.size());
+    // keeps the capacity reserved
+    m_udpBuffer.resize(0);
+}
+
+void NetProxyBridge::writeDatagram(const char *data, int len)
+{
+    m_udp->writeDatagram(data, len, m_udp_remote_addr, m_udp_remote_port);
+    m_udpSequence++;
+    notifyTraffic(UDP_TX);
+}
+
+bool NetProxyBridge::enqueue(Client *client, const QByteArray &data)
+{
+    if (client->queue.isEmpty() && client->socket->bytesToWrite() < WRITE_WINDOW && !suspended(client)) {
+        client->socket->write(data);
+        return true;
+    }
+    if (client->queued + data.size() > m_queueLimit) {
+        switch (m_policy) {
+        case DROP_NEWEST:
+            drop(client, data.size());
+            return true;
+        case DISCONNECT_CLIENT:
+            return false;
+        case DROP_OLDEST:
+            while (!client->queue.isEmpty() && client->queued + data.size() > m_queueLimit) {
+                const qint64 size = client->queue.dequeue().size();
+                client->queued -= size;
+                drop(client, size);
+            }
+            // larger than the whole queue
+            if (data.size() > m_queueLimit) {
+                drop(client, data.size());
+                return true;
+            }
+            break;
+        }
+    }
+    client->queue.enqueue(data);
+    client->queued += data.size();
+    return true;
+}
+
+/**
+ * @brief Hand queued data to the socket as long as it has room
+ */
+void NetProxyBridge::drain(Client *client)
+{
+    while (!client->queue.isEmpty() && client->socket->bytesToWrite() < WRITE_WINDOW && !suspended(client)) {
+        const QByteArray data = client->queue.dequeue();
+        client->queued -= data.size();
+        client->socket->write(data);
+    }
+}
+
+void NetProxyBridge::drop(Client *client, qint64 bytes)
+{
+    client->drops++;
+    client->dropped += bytes;
+}
+
+void NetProxyBridge::clientBytesWritten(qint64 bytes)
+{
+    Client *client = findClient(qobject_cast<QTcpSocket *>(sender()));
+    if (!client)
+        return;
+    client->sent += bytes;
+    drain(client);
+}
+
+void NetProxyBridge::updateStatistics()
+{
+    const qint64 elapsed = m_statisticsClock.restart();
+    QVector<ClientStatistics> clients;
+    clients.reserve(m_clients.size());
+    foreach (Client *client, m_clients) {
+        ClientStatistics statistics;
+        statistics.peer = client->peer;
+        statistics.sent = client->sent;
+        statistics.rate = (elapsed > 0) ? (client->sent - client->sentBefore) * 1000.0 / elapsed : 0.0;
+        statistics.queued = client->queued + client->socket->bytesToWrite();
+        statistics.drops = client->drops;
+        statistics.dropped = client->dropped;
+        client->sentBefore = client->sent;
+        clients.append(statistics);
+    }
+    emit statistics(clients);
+    // the empty list has been sent once, nothing changes until the next client
+    if (m_clients.isEmpty())
+        m_statisticsTimer->stop();
+}
+
+/**
+ * @brief Emit traffic() at most every TRAFFIC_INTERVAL_MS per kind, the
+ *  LEDs don't need more and every signal crosses the threads
+ */
+void NetProxyBridge::notifyTraffic(Traffic kind)
+{
+    const qint64 now = m_trafficClock.elapsed();
+    if (now - m_lastTraffic[kind] < TRAFFIC_INTERVAL_MS)
+        return;
+    m_lastTraffic[kind] = now;
+    emit traffic(kind);
+}
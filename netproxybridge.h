@@ -0,0 +1,210 @@
+/*
+ * Copyright (c) 2026 CuteCom contributors
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 675 Mass Ave, Cambridge, MA 02139, USA.
+ *
+ * For more information on the GPL, please go to:
+ * http://www.gnu.org/copyleft/gpl.html
+ */
+
+/**
+ * The sockets of the net proxy. NetProxyBridge lives on a thread of its
+ * own, so forwarding the received data to the network neither waits for
+ * the GUI nor holds up the serial port.
+ *
+ * Every TCP client gets a bounded queue. Only WRITE_WINDOW bytes are handed
+ * to the socket at a time, the rest waits in the queue of the client until
+ * the socket has written its data. A client that doesn't keep up fills its
+ * own queue only; what happens then is up to the QueuePolicy.
+ *
+ * The data for UDP are coalesced: a datagram is sent when it is full or
+ * when its first byte has waited for the max. latency. Optionally every
+ * datagram starts with a header of UDP_HEADER_SIZE bytes, big endian:
+ *   quint32 sequence number, counting from 0 when the socket is bound
+ *   quint64 capture time of the first byte, us since 1970-01-01 UTC
+ *
+ * In RFC 2217 mode the clients talk Telnet with the com port option: the
+ * data are escaped, the settings requested by the clients are handed to the
+ * device with controlPort() and changes of the modem lines are reported.
+ */
+
+#ifndef NETPROXYBRIDGE_H
+#define NETPROXYBRIDGE_H
+
+#include "rfc2217.h"
+
+#include <QElapsedTimer>
+#include <QMetaType>
+#include <QObject>
+#include <QQueue>
+#include <QTcpServer>
+#include <QTcpSocket>
+#include <QTimer>
+#include <QUdpSocket>
+#include <QVector>
+
+class NetProxyBridge : public QObject
+{
+    Q_OBJECT
+
+public:
+    /* what to do when the queue of a client is full */
+    enum QueuePolicy {
+        DROP_OLDEST = 0,  /* make room by dropping the oldest queued data */
+        DROP_NEWEST,      /* drop the data that don't fit anymore */
+        DISCONNECT_CLIENT /* close the connection to the client */
+    };
+    /* data have been forwarded, drives the activity LEDs */
+    enum Traffic { UDP_TX, UDP_RX, TCP_TX, TCP_RX, NUMBER_OF_TRAFFIC };
+
+    struct ClientStatistics {
+        QString peer;
+        /* bytes written to the client and bytes/s of the last interval */
+        quint64 sent;
+        double rate;
+        /* bytes waiting in the queue and in the socket */
+        qint64 queued;
+        /* chunks and bytes dropped by the queue policy */
+        quint32 drops;
+        quint64 dropped;
+    };
+
+    enum {
+        /* max. bytes handed to a socket at a time */
+        WRITE_WINDOW = 64 * 1024,
+        STATISTICS_INTERVAL_MS = 500,
+        /* min. time between two traffic signals of the same kind */
+        TRAFFIC_INTERVAL_MS = 100,
+        UDP_HEADER_SIZE = 12,
+        /* max. payload of an IPv4 UDP datagram */
+        UDP_MAX_DATAGRAM = 65507
+    };
+
+    explicit NetProxyBridge(QObject *parent = 0);
+    ~NetProxyBridge();
+    /* the port the TCP server listens on */
+    quint16 tcpPort() const { return m_tcp->serverPort(); }
+
+public slots:
+    void bindUdp(const QString &localAddress, quint16 localPort, const QString &remoteAddress, quint16 remotePort);
+    void unbindUdp();
+    /**
+     * @brief Set how the data for UDP are coalesced
+     * @param maxDatagram Max. bytes of a datagram, including the header
+     * @param maxLatency Max. ms the data are held back, 0 sends right away
+     * @param header Start the datagrams with sequence number and capture time
+     */
+    void setUdpCoalescing(int maxDatagram, int maxLatency, bool header);
+    void startTcpServer(quint16 port);
+    void stopTcpServer();
+    /**
+     * @brief Set how full queues are handled
+     * @param policy A QueuePolicy
+     * @param limit Max. bytes queued per client
+     */
+    void setQueuePolicy(int policy, qint64 limit);
+    /* talk RFC 2217 to the clients connecting from now on */
+    void setRfc2217(bool enable);
+    /**
+     * @brief The settings of the device the clients get when they ask,
+     *  in QSerialPort terms
+     */
+    void setPortState(quint32 baudRate, int dataBits, int parity, int stopBits, int flowControl);
+    /* the modem lines changed, QSerialPort::PinoutSignals, including DTR and RTS */
+    void controlLines(int lines);
+    /* the break of the device has been turned on or off */
+    void setBreakEnabled(bool enable);
+    /* data serial port -> UDP and all TCP clients, timestamp of CaptureClock */
+    void proxyCmd(const QByteArray &data, qint64 timestamp);
+
+signals:
+    /* data UDP/TCP -> serial port */
+    void sendCmd(QByteArray);
+    void traffic(NetProxyBridge::Traffic);
+    void udpStatus(bool, QString);
+    void tcpStatus(bool, QString);
+    void error(QString);
+    void statistics(QVector<NetProxyBridge::ClientStatistics>);
+    /* an RFC 2217 client changes the device, control is a Plugin::PortControl */
+    void controlPort(int control, int value);
+
+private slots:
+    void recvUDP();
+    void addTcpClient();
+    void removeTcpClient();
+    void recvTCP();
+    void clientBytesWritten(qint64 bytes);
+    void errorUdpSocket(QAbstractSocket::SocketError);
+    void errorTcpSocket(QAbstractSocket::SocketError);
+    void updateStatistics();
+    void flushUdp();
+
+private:
+    struct Client {
+        QTcpSocket *socket;
+        /* the Telnet state of an RFC 2217 client, NULL for raw TCP */
+        Rfc2217Server *telnet;
+        QString peer;
+        /* chunks not handed to the socket yet and their size */
+        QQueue<QByteArray> queue;
+        qint64 queued;
+        quint64 sent;
+        quint64 sentBefore;
+        quint32 drops;
+        quint64 dropped;
+    };
+
+    static bool suspended(const Client *client) { return client->telnet && client->telnet->suspended(); }
+    Client *findClient(QTcpSocket *socket);
+    void removeClient(Client *client);
+    /* returns false if the client has to be disconnected */
+    bool enqueue(Client *client, const QByteArray &data);
+    void drain(Client *client);
+    void drop(Client *client, qint64 bytes);
+    void notifyTraffic(Traffic traffic);
+    void sendUdp(const QByteArray &data, qint64 timestamp);
+    void writeDatagram(const char *data, int len);
+    void applyRequest(const Rfc2217Server::Request &request, quint32 value);
+
+    QUdpSocket *m_udp;
+    QHostAddress m_udp_remote_addr;
+    quint16 m_udp_remote_port;
+    int m_udpMaxDatagram;
+    int m_udpMaxLatency;
+    bool m_udpHeader;
+    /* the datagram being coalesced, with room for the header */
+    QByteArray m_udpBuffer;
+    /* capture time of its first byte */
+    qint64 m_udpTimestamp;
+    quint32 m_udpSequence;
+    QTimer *m_udpTimer;
+    QTcpServer *m_tcp;
+    QList<Client *> m_clients;
+    QueuePolicy m_policy;
+    qint64 m_queueLimit;
+    bool m_rfc2217;
+    Rfc2217Server::PortState m_port;
+    /* last state of the modem lines, -1 if unknown */
+    int m_lines;
+    QTimer *m_statisticsTimer;
+    QElapsedTimer m_statisticsClock;
+    QElapsedTimer m_trafficClock;
+    qint64 m_lastTraffic[NUMBER_OF_TRAFFIC];
+};
+
+Q_DECLARE_METATYPE(NetProxyBridge::Traffic)
+Q_DECLARE_METATYPE(NetProxyBridge::ClientStatistics)
+
+#endif // NETPROXYBRIDGE_H
@@ -21,6 +21,7 @@
 
 #include "netproxyplugin.h"
 #include "ui_netproxyplugin.h"
+#include <QHeaderView>
 #include <QtWidgets/QPushButton>
 
 #define TRACE                                                                                                          \
@@ -45,6 +46,11 @@ NetProxyPlugin::NetProxyPlugin(QFrame *parent, Settings *settings)
     ui->setupUi(this);
     /* Plugin by default disabled, no injection, has QFrame, no injection process cmd */
     m_plugin = new Plugin(this, "NetProxy", this);
+    /* the data are queued to the network I/O thread right away */
+    m_plugin->processRx = &NetProxyPlugin::processRx;
+    m_plugin->rxAffinity = Plugin::RX_INLINE;
+    /* the modem lines for RFC 2217 clients */
+    m_plugin->processEvent = &NetProxyPlugin::processEvent;
 
     m_proxySettings = new NetProxySettings(settings, this);
     /* event to show the macro dialog */
@@ -55,8 +61,17 @@ NetProxyPlugin::NetProxyPlugin(QFrame *parent, Settings *settings)
     connect(m_proxySettings, &NetProxySettings::ledSetValue, this, &NetProxyPlugin::ledSetValue);
     /* data from netproxy -> plugin manager*/
     connect(m_proxySettings, &NetProxySettings::sendCmd, this, &NetProxyPlugin::sendCmd);
-    /* data from plugin manager -> netproxy */
-    connect(this, &NetProxyPlugin::proxyCmd, m_proxySettings, &NetProxySettings::proxyCmd);
+    /* data from plugin manager -> netproxy, straight to the I/O thread */
+    connect(this, &NetProxyPlugin::proxyCmd, m_proxySettings->bridge(), &NetProxyBridge::proxyCmd);
+    connect(this, &NetProxyPlugin::controlLines, m_proxySettings->bridge(), &NetProxyBridge::controlLines);
+    connect(this, &NetProxyPlugin::breakEnabled, m_proxySettings->bridge(), &NetProxyBridge::setBreakEnabled);
+    /* RFC 2217 clients -> device settings */
+    connect(m_proxySettings, &NetProxySettings::controlPort, m_plugin, &Plugin::controlPort);
+    /* per client statistics */
+    connect(m_proxySettings, &NetProxySettings::clientStatistics, this, &NetProxyPlugin::updateClients);
+    ui->m_table_clients->horizontalHeader()->setSectionResizeMode(QHeaderView::ResizeToContents);
+    ui->m_table_clients->horizontalHeader()->setStretchLastSection(true);
+    ui->m_table_clients->verticalHeader()->hide();
     /* connect status labels */
     connect(m_proxySettings, &NetProxySettings::udpStatus, this, &NetProxyPlugin::setUdpStatusText);
     connect(m_proxySettings, &NetProxySettings::tcpStatus, this, &NetProxyPlugin::setTcpStatusText);
@@ -106,6 +121,29 @@ NetProxyPlugin::~NetProxyPlugin()
     delete ui;
 }
 
+/**
+ * @brief Called by the plugin manager with the received data, which
+ *  are forwarded to the network. The time the data have been read goes
+ *  into the UDP header.
+ */
+void NetProxyPlugin::processRx(QObject *owner, const QByteArray &data, qint64 timestamp)
+{
+    emit static_cast<NetProxyPlugin *>(owner)->proxyCmd(data, timestamp);
+}
+
+/**
+ * @brief Called by the plugin manager with changes of the control lines
+ *  and the break, they are passed on to the RFC 2217 clients as modem
+ *  state and answer their DTR, RTS and break queries
+ */
+void NetProxyPlugin::processEvent(QObject *owner, Plugin::DeviceEvent event, int value, const QString &, qint64)
+{
+    if (event == Plugin::EVENT_CONTROL_LINES)
+        emit static_cast<NetProxyPlugin *>(owner)->controlLines(value);
+    else if (event == Plugin::EVENT_BREAK)
+        emit static_cast<NetProxyPlugin *>(owner)->breakEnabled(value);
+}
+
 /**
  * @brief Return a pointer to the plugin data
  * @return
@@ -183,3 +221,27 @@ void NetProxyPlugin::setTcpStatusText(bool state, QString text)
 
     ui->m_lbl_tcp_status->setText(text);
 }
+
+/**
+ * @brief Show throughput, queue depth and drops of every TCP client
+ */
+void NetProxyPlugin::updateClients(const QVector<NetProxyBridge::ClientStatistics> &clients)
+{
+    ui->m_table_clients->setRowCount(clients.size());
+    for (int row = 0; row < clients.size(); row++) {
+        const NetProxyBridge::ClientStatistics &client = clients.at(row);
+        const QString cells[NUMBER_OF_COLUMNS]
+            = {client.peer, QString::number(client.rate / 1024.0, 'f', 1),
+               QString::number(client.queued / 1024.0, 'f', 1), QString::number(client.drops)};
+        for (int col = COL_CLIENT; col < NUMBER_OF_COLUMNS; col++) {
+            QTableWidgetItem *item = ui->m_table_clients->item(row, col);
+            if (!item) {
+                item = new QTableWidgetItem();
+                ui->m_table_clients->setItem(row, col, item);
+            }
+            item->setText(cells[col]);
+        }
+        ui->m_table_clients->item(row, COL_DROPS)->setToolTip(
+            tr("%1 KB dropped, %2 KB sent").arg(client.dropped / 1024).arg(client.sent / 1024));
+    }
+}
@@ -37,11 +37,12 @@ public:
     explicit NetProxyPlugin(QFrame *parent = 0, Settings *settings = 0);
     virtual ~NetProxyPlugin();
     const Plugin *plugin();
-    int processCmd(const QString *text);
 
 signals:
-    void sendCmd(QByteArray);  /* netproxy -> plugin manager */
-    void proxyCmd(QByteArray); /* plugin manager -> netproxy */
+    void sendCmd(QByteArray);          /* netproxy -> plugin manager */
+    void proxyCmd(QByteArray, qint64); /* plugin manager -> netproxy */
+    void controlLines(int);            /* device modem lines -> netproxy */
+    void breakEnabled(bool);           /* device break -> netproxy */
     void unload(Plugin *);
 
 private slots:
@@ -50,8 +51,15 @@ private slots:
     void tmrInterrupt(void);
     void setUdpStatusText(bool, QString);
     void setTcpStatusText(bool, QString);
+    void updateClients(const QVector<NetProxyBridge::ClientStatistics> &clients);
 
 private:
+    enum Columns { COL_CLIENT, COL_RATE, COL_QUEUE, COL_DROPS, NUMBER_OF_COLUMNS };
+
+    static void processRx(QObject *owner, const QByteArray &data, qint64 timestamp);
+    static void processEvent(QObject *owner, Plugin::DeviceEvent event, int value, const QString &message,
+                             qint64 timestamp);
+
     Settings *m_settings;
     Ui::NetProxyPlugin *ui;
     Plugin *m_plugin;
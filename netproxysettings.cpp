@@ -1,6 +1,5 @@
 #include "netproxysettings.h"
 #include "ui_netproxysettings.h"
-#include <QAbstractSocket>
 #include <QCloseEvent>
 #include <QMessageBox>
 #include <QNetworkInterface>
@@ -17,6 +16,8 @@ NetProxySettings::NetProxySettings(Settings *settings, QWidget *parent)
     : QDialog(parent)
     , m_settings(settings)
     , ui(new Ui::NetProxySettings)
+    , m_udpBound(false)
+    , m_tcpListening(false)
 {
     ui->setupUi(this);
 
@@ -32,11 +33,29 @@ NetProxySettings::NetProxySettings(Settings *settings, QWidget *parent)
 
     getLocalIp();
 
-    /* Initialize UDP socket */
-    m_udp = new QUdpSocket(this);
+    qRegisterMetaType<NetProxyBridge::Traffic>();
+    qRegisterMetaType<QVector<NetProxyBridge::ClientStatistics>>();
+
+    /* The sockets run on their own thread, a slow client must neither
+     * stall the GUI nor the serial port */
+    m_bridge = new NetProxyBridge;
+    m_bridge->moveToThread(&m_ioThread);
+    connect(&m_ioThread, &QThread::finished, m_bridge, &QObject::deleteLater);
+    connect(m_bridge, &NetProxyBridge::sendCmd, this, &NetProxySettings::sendCmd);
+    connect(m_bridge, &NetProxyBridge::udpStatus, this, &NetProxySettings::bridgeUdpStatus);
+    connect(m_bridge, &NetProxyBridge::tcpStatus, this, &NetProxySettings::bridgeTcpStatus);
+    connect(m_bridge, &NetProxyBridge::traffic, this, &NetProxySettings::bridgeTraffic);
+    connect(m_bridge, &NetProxyBridge::error, this, &NetProxySettings::bridgeError);
+    connect(m_bridge, &NetProxyBridge::statistics, this, &NetProxySettings::clientStatistics);
+    connect(m_bridge, &NetProxyBridge::controlPort, this,
+            [=](int control, int value) { emit controlPort(static_cast<Plugin::PortControl>(control), value); });
+    m_ioThread.setObjectName(QStringLiteral("NetProxy"));
+    m_ioThread.start();
+
+    /* UDP */
     connect(ui->m_btn_udp, &QPushButton::clicked, this, [=]() {
-        TRACE << "UDP state: " << m_udp->state();
-        if (m_udp->state() != QAbstractSocket::BoundState) {
+        TRACE << "UDP bound: " << m_udpBound;
+        if (!m_udpBound) {
             bindUdp();
         } else {
             unbindUdp();
@@ -44,101 +63,128 @@ NetProxySettings::NetProxySettings(Settings *settings, QWidget *parent)
     });
     connect(ui->m_bt_udp_help, &QPushButton::clicked, this, &NetProxySettings::helpMsgUdp);
     connect(ui->m_bt_tcp_help, &QPushButton::clicked, this, &NetProxySettings::helpMsgTcp);
-    connect(m_udp, static_cast<void (QUdpSocket::*)(QAbstractSocket::SocketError)>(&QAbstractSocket::error), this,
-            &NetProxySettings::errorUdpSocket);
 
-    /* Initialise TCP socket */
-    m_tcp = new QTcpServer(this);
+    /* TCP */
     connect(ui->m_btn_tcp, &QPushButton::clicked, this, [=]() {
-        TRACE << "TCP state: " << m_udp->state();
-        if (m_tcp->isListening()) {
+        TRACE << "TCP listening: " << m_tcpListening;
+        if (m_tcpListening) {
             stopTcpServer();
         } else {
             startTcpServer();
         }
     });
-    connect(m_tcp, &QTcpServer::newConnection, this, &NetProxySettings::addTcpClient);
-    connect(m_tcp, &QTcpServer::acceptError, this, &NetProxySettings::errorTcpSocket);
 
     /* update controls with the saved settings */
     ui->m_sb_udp_port_local->setValue(m_settings->getCurrentSession().udpLocalPort);
     ui->m_le_udp_remote_host->setText(m_settings->getCurrentSession().udpRemoteHost);
     ui->m_sb_udp_port_remote->setValue(m_settings->getCurrentSession().udpRemotePort);
+    ui->m_sb_udp_datagram->setValue(m_settings->getCurrentSession().udpMaxDatagram);
+    ui->m_sb_udp_latency->setValue(m_settings->getCurrentSession().udpMaxLatency);
+    ui->m_cb_udp_header->setChecked(m_settings->getCurrentSession().udpHeader);
     ui->m_sb_tcp_port_local->setValue(m_settings->getCurrentSession().tcpLocalPort);
+    ui->m_combo_tcp_policy->setCurrentIndex(m_settings->getCurrentSession().tcpQueuePolicy);
+    ui->m_sb_tcp_queue->setValue(m_settings->getCurrentSession().tcpQueueLimit);
+    ui->m_cb_tcp_rfc2217->setChecked(m_settings->getCurrentSession().tcpRfc2217);
+    setQueuePolicy();
+    setUdpCoalescing();
+    setRfc2217(ui->m_cb_tcp_rfc2217->isChecked());
+    setPortState(m_settings->getCurrentSession());
+    connect(ui->m_cb_tcp_rfc2217, &QCheckBox::toggled, this, &NetProxySettings::setRfc2217);
+    connect(m_settings, &Settings::sessionChanged, this, &NetProxySettings::setPortState);
+    connect(ui->m_combo_tcp_policy, static_cast<void (QComboBox::*)(int)>(&QComboBox::currentIndexChanged), this,
+            &NetProxySettings::setQueuePolicy);
+    connect(ui->m_sb_tcp_queue, static_cast<void (QSpinBox::*)(int)>(&QSpinBox::valueChanged), this,
+            &NetProxySettings::setQueuePolicy);
+    connect(ui->m_sb_udp_datagram, static_cast<void (QSpinBox::*)(int)>(&QSpinBox::valueChanged), this,
+            &NetProxySettings::setUdpCoalescing);
+    connect(ui->m_sb_udp_latency, static_cast<void (QSpinBox::*)(int)>(&QSpinBox::valueChanged), this,
+            &NetProxySettings::setUdpCoalescing);
+    connect(ui->m_cb_udp_header, &QCheckBox::toggled, this, &NetProxySettings::setUdpCoalescing);
     connect(this, &NetProxySettings::rejected, this, &NetProxySettings::formClose);
 }
 
-NetProxySettings::~NetProxySettings() { delete ui; }
+NetProxySettings::~NetProxySettings()
+{
+    /* the bridge is deleted on its thread when it finishes */
+    m_ioThread.quit();
+    m_ioThread.wait();
+    delete ui;
+}
 
-/**
- * @brief When dialog closes then save settings
- */
 void NetProxySettings::formClose()
 {
     /* update the settings with the current values */
     m_settings->settingChanged(Settings::UdpLocalPort, ui->m_sb_udp_port_local->value());
     m_settings->settingChanged(Settings::UdpRemoteHost, ui->m_le_udp_remote_host->text());
     m_settings->settingChanged(Settings::UdpRemotePort, ui->m_sb_udp_port_remote->value());
+    m_settings->settingChanged(Settings::UdpMaxDatagram, ui->m_sb_udp_datagram->value());
+    m_settings->settingChanged(Settings::UdpMaxLatency, ui->m_sb_udp_latency->value());
+    m_settings->settingChanged(Settings::UdpHeader, ui->m_cb_udp_header->isChecked());
     m_settings->settingChanged(Settings::TcpLocalPort, ui->m_sb_tcp_port_local->value());
+    m_settings->settingChanged(Settings::TcpQueuePolicy, ui->m_combo_tcp_policy->currentIndex());
+    m_settings->settingChanged(Settings::TcpQueueLimit, ui->m_sb_tcp_queue->value());
+    m_settings->settingChanged(Settings::TcpRfc2217, ui->m_cb_tcp_rfc2217->isChecked());
     TRACE << "[NetProxySettings::formClose]";
 }
 
 /**
- * @brief Check for valid IPv4 address
- * @param addr The address to check
- * @return true if IPv4 else false
+ * @brief Hand the queue policy of the TCP clients to the bridge
  */
-bool NetProxySettings::CheckIpAddress(QHostAddress *addr)
+void NetProxySettings::setQueuePolicy()
 {
-    if (QAbstractSocket::IPv4Protocol != addr->protocol()) {
-        QMessageBox::critical(this, tr("Error"), tr("Invalid remote IP address: %1.").arg(addr->toString()));
-        return false;
-    }
-    return true;
+    QMetaObject::invokeMethod(m_bridge, "setQueuePolicy", Qt::QueuedConnection,
+                              Q_ARG(int, ui->m_combo_tcp_policy->currentIndex()),
+                              Q_ARG(qint64, qint64(ui->m_sb_tcp_queue->value()) * 1024));
 }
 
 /**
- * @brief Check for valid TCP/UDP port
- * @param port The port number. All port numbers are allowed
- * @return true if valid port, else false
+ * @brief Hand the coalescing of the UDP datagrams to the bridge
  */
-bool NetProxySettings::CheckPort(quint16 port)
+void NetProxySettings::setUdpCoalescing()
 {
-    if (!port) {
-        QMessageBox::warning(this, tr("Error"), tr("Invalid remote port range!"));
-        return false;
-    }
-    return true;
+    QMetaObject::invokeMethod(m_bridge, "setUdpCoalescing", Qt::QueuedConnection,
+                              Q_ARG(int, ui->m_sb_udp_datagram->value()), Q_ARG(int, ui->m_sb_udp_latency->value()),
+                              Q_ARG(bool, ui->m_cb_udp_header->isChecked()));
 }
 
 /**
- * @brief UDP socket errors
- * @param err The error that occured
+ * @brief RFC 2217 applies to the clients connecting afterwards
  */
-void NetProxySettings::errorUdpSocket(QAbstractSocket::SocketError err)
+void NetProxySettings::setRfc2217(bool enable)
 {
-    unbindUdp();
-    if (err) {
-        QMessageBox::critical(this, tr("Error"), tr("UDP socket error: %1.").arg(m_udp->errorString()));
-    }
+    QMetaObject::invokeMethod(m_bridge, "setRfc2217", Qt::QueuedConnection, Q_ARG(bool, enable));
 }
 
 /**
- * @brief TCP socket errors
- * @param err The error that occured
+ * @brief The settings RFC 2217 clients get when they ask
  */
-void NetProxySettings::errorTcpSocket(QAbstractSocket::SocketError err)
+void NetProxySettings::setPortState(const Settings::Session &session)
+{
+    QMetaObject::invokeMethod(m_bridge, "setPortState", Qt::QueuedConnection, Q_ARG(quint32, session.baudRate),
+                              Q_ARG(int, session.dataBits), Q_ARG(int, session.parity),
+                              Q_ARG(int, session.stopBits), Q_ARG(int, session.flowControl));
+}
+
+bool NetProxySettings::CheckIpAddress(QHostAddress *addr)
 {
-    stopTcpServer();
-    if (err) {
-        QMessageBox::critical(this, tr("Error"), tr("TCP socket error: %1.").arg(m_tcp->errorString()));
+    if (QAbstractSocket::IPv4Protocol != addr->protocol()) {
+        QMessageBox::critical(this, tr("Error"), tr("Invalid remote IP address: %1.").arg(addr->toString()));
+        return false;
     }
+    return true;
 }
 
-/**
- * @brief Bind UDP address and port and notify the interface
- *  elements.
- */
+bool NetProxySettings::CheckPort(quint16 port)
+{
+    if (!port) {
+        QMessageBox::warning(this, tr("Error"), tr("Invalid remote port range!"));
+        return false;
+    }
+    return true;
+}
+
+void NetProxySettings::bridgeError(QString message) { QMessageBox::critical(this, tr("Error"), message); }
+
 void NetProxySettings::bindUdp()
 {
     QHostAddress r_addr(ui->m_le_udp_remote_host->text());
@@ -159,148 +205,63 @@ void NetProxySettings::bindUdp()
         return;
     }
 
-    if (m_udp->bind(l_addr, l_port)) {
-        connect(m_udp, &QUdpSocket::readyRead, this, &NetProxySettings::recvUDP);
-        ui->m_btn_udp->setText("Close");
-        /* store udp details */
-        m_udp_remote_addr = r_addr;
-        m_udp_remote_port = r_port;
-        emit ledSetValue(en_led::LED_UDP_EN, true);
-        QString status(QString("%1 : %2").arg(l_addr.toString()).arg(QString::number(l_port)));
-        emit udpStatus(true, status);
-        TRACE << "[NetProxySettings] UDP bind " << status;
-    } else {
-        QMessageBox::critical(this, tr("Error"), tr("Could not bind UDP socket!"));
-        m_udp_remote_addr.clear();
-    }
+    QMetaObject::invokeMethod(m_bridge, "bindUdp", Qt::QueuedConnection, Q_ARG(QString, l_addr.toString()),
+                              Q_ARG(quint16, l_port), Q_ARG(QString, r_addr.toString()), Q_ARG(quint16, r_port));
 }
 
-/**
- * @brief In case of error or close request, then close the
- *  socket and notify the user interface elements
- */
-void NetProxySettings::unbindUdp()
-{
-    m_udp->close();
-    m_udp_remote_addr.clear();
-    m_udp_remote_port = 0;
-    ui->m_btn_udp->setText(tr("Listen"));
-    emit ledSetValue(en_led::LED_UDP_EN, false);
-    emit udpStatus(false, QString(tr("Not used")));
-    TRACE << "[NetProxySettings] UDP unbind";
-}
+void NetProxySettings::unbindUdp() { QMetaObject::invokeMethod(m_bridge, "unbindUdp", Qt::QueuedConnection); }
 
-/**
- * @brief [SIGNAL] This receives the data from UDP and then
- *  emits the received data.
- */
-void NetProxySettings::recvUDP()
+void NetProxySettings::bridgeUdpStatus(bool bound, QString status)
 {
-    while (m_udp->hasPendingDatagrams()) {
-        QByteArray datagram;
-        QHostAddress sender;
-        quint16 senderPort;
-
-        datagram.resize(m_udp->pendingDatagramSize());
-        m_udp->readDatagram(datagram.data(), datagram.size(), &sender, &senderPort);
-
-        emit sendCmd(datagram);
-        emit ledSetValue(en_led::LED_UDP_RX, true);
-    }
+    m_udpBound = bound;
+    ui->m_btn_udp->setText(bound ? tr("Close") : tr("Listen"));
+    emit ledSetValue(en_led::LED_UDP_EN, bound);
+    emit udpStatus(bound, status);
 }
 
-/**
- * @brief Start the local TCP server
- */
 void NetProxySettings::startTcpServer()
 {
-    int l_port = ui->m_sb_udp_port_local->text().toInt();
+    int l_port = ui->m_sb_tcp_port_local->text().toInt();
     if (!CheckPort(l_port))
         return;
-    if (!m_tcp->listen(QHostAddress::Any, l_port)) {
-        QMessageBox::critical(this, tr("Error"), tr("Could not start TCP server.\n%1.").arg(m_tcp->errorString()));
-        return;
-    }
-    ui->m_btn_tcp->setText(tr("Close"));
-    emit ledSetValue(en_led::LED_TCP_EN, true);
-    QString status(tr("Listening on: %1").arg(QString::number(l_port)));
-    emit tcpStatus(true, status);
+    // the control panel may have changed the device since
+    setPortState(m_settings->getCurrentSession());
+    QMetaObject::invokeMethod(m_bridge, "startTcpServer", Qt::QueuedConnection, Q_ARG(quint16, l_port));
 }
 
-/**
- * @brief Stop local TCP server
- */
 void NetProxySettings::stopTcpServer()
 {
-    m_tcp->close();
-    ui->m_btn_tcp->setText(tr("Listen"));
-    emit ledSetValue(en_led::LED_TCP_EN, false);
-    emit tcpStatus(false, QString(tr("Not used")));
+    QMetaObject::invokeMethod(m_bridge, "stopTcpServer", Qt::QueuedConnection);
 }
 
-/**
- * @brief On every new TCP connection add the client to the list
- */
-void NetProxySettings::addTcpClient()
+void NetProxySettings::bridgeTcpStatus(bool listening, QString status)
 {
-    QTcpSocket *client = m_tcp->nextPendingConnection();
-    connect(client, &QTcpSocket::disconnected, this, &NetProxySettings::removeTcpClient);
-    connect(client, &QTcpSocket::readyRead, this, &NetProxySettings::recvTCP);
-    /* add client to the list */
-    m_tcpClients.append(client);
-    TRACE << "Connected: " << client->localAddress();
+    m_tcpListening = listening;
+    ui->m_btn_tcp->setText(listening ? tr("Close") : tr("Listen"));
+    emit ledSetValue(en_led::LED_TCP_EN, listening);
+    emit tcpStatus(listening, status);
 }
 
-/**
- * @brief Receive data from TCP clients and forward the data to the serial
- */
-void NetProxySettings::recvTCP()
-{
-    QTcpSocket *client = qobject_cast<QTcpSocket *>(sender());
-    while (client->bytesAvailable()) {
-        QByteArray recv_data = client->readAll();
-        emit sendCmd(recv_data);
-        emit ledSetValue(en_led::LED_TCP_RX, true);
-        TRACE << "TCP in: " << recv_data;
-    }
-}
-
-/**
- * @brief Remove clients from the server's list
- */
-void NetProxySettings::removeTcpClient()
+void NetProxySettings::bridgeTraffic(NetProxyBridge::Traffic traffic)
 {
-    QTcpSocket *client = qobject_cast<QTcpSocket *>(sender());
-    client->disconnectFromHost();
-    m_tcpClients.removeOne(client);
-    TRACE << "Disconnected: " << client->localAddress();
-}
-
-/**
- * @brief Receive data from the plugin and send them to the
- *  UDP socket.
- * @param cmd The data bytes
- */
-void NetProxySettings::proxyCmd(QByteArray cmd)
-{
-    if (m_udp->state() == QAbstractSocket::BoundState) {
-        m_udp->writeDatagram(cmd, m_udp_remote_addr, m_udp_remote_port);
+    switch (traffic) {
+    case NetProxyBridge::UDP_TX:
         emit ledSetValue(en_led::LED_UDP_TX, true);
+        break;
+    case NetProxyBridge::UDP_RX:
+        emit ledSetValue(en_led::LED_UDP_RX, true);
+        break;
+    case NetProxyBridge::TCP_TX:
+        emit ledSetValue(en_led::LED_TCP_TX, true);
+        break;
+    case NetProxyBridge::TCP_RX:
+        emit ledSetValue(en_led::LED_TCP_RX, true);
+        break;
+    default:
+        break;
     }
-    if (m_tcp->isListening()) {
-        /* send the data to all clients */
-        QTcpSocket *client;
-        foreach (client, m_tcpClients) {
-            client->write(cmd);
-            emit ledSetValue(en_led::LED_TCP_TX, true);
-        }
-    }
-    TRACE << "[NetProxySettings::proxyCmd]: " << QString::fromUtf8(cmd.data());
 }
 
-/**
- * @brief Retrieve the IP addresses of all the local interfaces
- */
 void NetProxySettings::getLocalIp()
 {
     QList<QHostAddress> list = QNetworkInterface::allAddresses();
@@ -332,7 +293,19 @@ void NetProxySettings::helpMsgUdp(void)
                           "and IP which is set in the settings.\n\n"
                           "For obvious reasons, using the same UDP port for\n"
                           "listen and send is not allowed as it may lead to\n"
-                          "an infinite tx/rx loop\n");
+                          "an infinite tx/rx loop\n\n"
+                          "The serial data are coalesced into datagrams of\n"
+                          "up to the max. datagram size. A datagram is sent\n"
+                          "when it is full or when its first byte has waited\n"
+                          "for the max. latency; with no latency the data are\n"
+                          "sent as soon as they have been received.\n\n"
+                          "With sequence number and timestamp, every datagram\n"
+                          "starts with 12 bytes, both big endian:\n"
+                          "    32 bit sequence number, from 0 when bound\n"
+                          "    64 bit time the first byte has been received,\n"
+                          "    in us since 1970-01-01 UTC\n"
+                          "so the receiver can detect lost datagrams and\n"
+                          "put them into order.\n");
 
     QMessageBox::information(this, tr("How to use UDP forwarding"), help_str);
 }
@@ -347,7 +320,18 @@ void NetProxySettings::helpMsgTcp(void)
                           "connected clients.\n\n"
                           "Select the local port and run the server. Then use\n"
                           "any TCP client (e.g. telnet) to connect to the server\n"
-                          "and receive or send data in the serial port.\n");
+                          "and receive or send data in the serial port.\n\n"
+                          "Every client has a queue of its own. If a client\n"
+                          "doesn't keep up and its queue is full, either the\n"
+                          "oldest or the newest data are dropped, or the client\n"
+                          "is disconnected. The other clients and the serial\n"
+                          "port are not affected.\n\n"
+                          "With RFC 2217 the clients may change the baud rate,\n"
+                          "the data format, flow control, DTR/RTS and break of\n"
+                          "the open device, e.g. with rfc2217://host:port of\n"
+                          "pySerial. Changes of the modem lines are reported\n"
+                          "to the clients. The device stays open in CuteCom\n"
+                          "and the control panel shows the new settings.\n");
 
     QMessageBox::information(this, tr("How to use TCP forwarding"), help_str);
 }
@@ -1,11 +1,11 @@
 #ifndef NETPROXYSETTINGS_H
 #define NETPROXYSETTINGS_H
 
+#include "netproxybridge.h"
+#include "plugin.h"
 #include "settings.h"
 #include <QDialog>
-#include <QTcpServer>
-#include <QTcpSocket>
-#include <QUdpSocket>
+#include <QThread>
 
 namespace Ui
 {
@@ -20,15 +20,19 @@ public:
     enum en_led { LED_UDP_EN, LED_UDP_TX, LED_UDP_RX, LED_TCP_EN, LED_TCP_TX, LED_TCP_RX, NUMBER_OF_LEDS };
     explicit NetProxySettings(Settings *settings, QWidget *parent = 0);
     ~NetProxySettings();
+    /* the sockets, living on the network I/O thread */
+    NetProxyBridge *bridge() const { return m_bridge; }
 
 signals:
     void sendCmd(QByteArray);
     void ledSetValue(NetProxySettings::en_led, bool);
     void udpStatus(bool, QString);
     void tcpStatus(bool, QString);
+    void clientStatistics(QVector<NetProxyBridge::ClientStatistics>);
+    /* an RFC 2217 client changes the device */
+    void controlPort(Plugin::PortControl, int);
 
 public slots:
-    void proxyCmd(QByteArray); /* data netproxy plugin -> UDP */
     void bindUdp();
     void unbindUdp();
     void startTcpServer();
@@ -36,21 +40,22 @@ public slots:
 
 private slots:
     void formClose();
-    void recvUDP();
-    void addTcpClient();
-    void removeTcpClient();
-    void recvTCP();
-    void errorUdpSocket(QAbstractSocket::SocketError);
-    void errorTcpSocket(QAbstractSocket::SocketError);
+    void setQueuePolicy();
+    void setUdpCoalescing();
+    void setRfc2217(bool enable);
+    void setPortState(const Settings::Session &session);
+    void bridgeUdpStatus(bool, QString);
+    void bridgeTcpStatus(bool, QString);
+    void bridgeTraffic(NetProxyBridge::Traffic);
+    void bridgeError(QString);
 
 private:
     Settings *m_settings;
     Ui::NetProxySettings *ui;
-    QUdpSocket *m_udp;
-    QHostAddress m_udp_remote_addr;
-    qint16 m_udp_remote_port;
-    QTcpServer *m_tcp;
-    QList<QTcpSocket *> m_tcpClients;
+    QThread m_ioThread;
+    NetProxyBridge *m_bridge;
+    bool m_udpBound;
+    bool m_tcpListening;
 
     void helpMsgUdp(void);
     void helpMsgTcp(void);
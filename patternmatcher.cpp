@@ -0,0 +1,197 @@
+/*
+ * Copyright (c) 2026 CuteCom contributors
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 675 Mass Ave, Cambridge, MA 02139, USA.
+ *
+ * For more information on the GPL, please go to:
+ * http://www.gnu.org/copyleft/gpl.html
+ */
+
+#include "patternmatcher.h"
+
+PatternMatcher::PatternMatcher()
+    : m_state(0)
+{
+}
+
+int PatternMatcher::addPattern(const QByteArray &pattern)
+{
+    if (pattern.isEmpty())
+        return -1;
+
+    int id = m_patterns.indexOf(pattern);
+    if (id < 0) {
+        id = m_patterns.size();
+        m_patterns.append(pattern);
+    }
+    return id;
+}
+
+void PatternMatcher::clear()
+{
+    m_patterns.clear();
+    m_delta.clear();
+    m_match.clear();
+    m_report.clear();
+    m_dictLink.clear();
+    m_state = 0;
+}
+
+/*!
+ * Builds the trie of all patterns and turns it into a DFA by resolving
+ * the missing transitions through the failure links (breadth first).
+ * \brief PatternMatcher::build
+ */
+void PatternMatcher::build()
+{
+    m_state = 0;
+    m_delta.clear();
+    m_match.clear();
+    m_report.clear();
+    m_dictLink.clear();
+
+    if (m_patterns.isEmpty())
+        return;
+
+    // root state
+    m_delta.fill(-1, ALPHABET);
+    m_match.append(-1);
+
+    // 1. the trie
+    for (int id = 0; id < m_patterns.size(); id++) {
+        const QByteArray &pattern = m_patterns.at(id);
+        qint32 s = 0;
+        for (int i = 0; i < pattern.size(); i++) {
+            const int c = static_cast<uchar>(pattern.at(i));
+            qint32 next = m_delta.at(s * ALPHABET + c);
+            if (next < 0) {
+                next = m_match.size();
+                m_delta[s * ALPHABET + c] = next;
+                m_delta.insert(m_delta.size(), ALPHABET, -1);
+                m_match.append(-1);
+            }
+            s = next;
+        }
+        m_match[s] = id;
+    }
+
+    const int states = m_match.size();
+    QVector<qint32> fail(states, 0);
+    m_report.fill(-1, states);
+    m_dictLink.fill(-1, states);
+
+    // 2. failure links and the remaining transitions
+    QVector<qint32> queue;
+    queue.reserve(states);
+    for (int c = 0; c < ALPHABET; c++) {
+        qint32 &t = m_delta[c];
+        if (t < 0) {
+            t = 0;
+        } else {
+            fail[t] = 0;
+            queue.append(t);
+        }
+    }
+
+    for (int head = 0; head < queue.size(); head++) {
+        const qint32 s = queue.at(head);
+        const qint32 f = fail.at(s);
+
+        m_dictLink[s] = (m_match.at(f) >= 0) ? f : m_dictLink.at(f);
+        m_report[s] = (m_match.at(s) >= 0) ? s : m_dictLink.at(s);
+
+        for (int c = 0; c < ALPHABET; c++) {
+            qint32 &t = m_delta[s * ALPHABET + c];
+            if (t < 0) {
+                t = m_delta.at(f * ALPHABET + c);
+            } else {
+                fail[t] = m_delta.at(f * ALPHABET + c);
+                queue.append(t);
+            }
+        }
+    }
+}
+
+QByteArray PatternMatcher::fromEscaped(const QString &text)
+{
+    QByteArray bytes;
+    bytes.reserve(text.size());
+    for (int i = 0; i < text.size(); i++) {
+        const QChar c = text.at(i);
+        if (c != QLatin1Char('\\') || i + 1 >= text.size()) {
+            bytes.append(static_cast<char>(c.unicode() & 0xff));
+            continue;
+        }
+        const QChar e = text.at(++i);
+        switch (e.unicode()) {
+        case 'r':
+            bytes.append('\r');
+            break;
+        case 'n':
+            bytes.append('\n');
+            break;
+        case 't':
+            bytes.append('\t');
+            break;
+        case '0':
+            bytes.append('\0');
+            break;
+        case 'x': {
+            bool ok = false;
+            const uint value = text.mid(i + 1, 2).toUInt(&ok, 16);
+            if (ok) {
+                bytes.append(static_cast<char>(value));
+                i += 2;
+            } else {
+                bytes.append('x');
+            }
+        } break;
+        default:
+            bytes.append(static_cast<char>(e.unicode() & 0xff));
+            break;
+        }
+    }
+    return bytes;
+}
+
+QString PatternMatcher::toEscaped(const QByteArray &data)
+{
+    QString text;
+    text.reserve(data.size());
+    for (char c : data) {
+        const uchar b = static_cast<uchar>(c);
+        switch (b) {
+        case '\r':
+            text += QStringLiteral("\\r");
+            break;
+        case '\n':
+            text += QStringLiteral("\\n");
+            break;
+        case '\t':
+            text += QStringLiteral("\\t");
+            break;
+        case '\\':
+            text += QStringLiteral("\\\\");
+            break;
+        default:
+            if (b < 0x20 || b >= 0x7f)
+                text += QStringLiteral("\\x%1").arg(b, 2, 16, QChar('0'));
+            else
+                text += QChar(b);
+            break;
+        }
+    }
+    return text;
+}
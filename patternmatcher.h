@@ -0,0 +1,165 @@
+/*
+ * Copyright (c) 2026 CuteCom contributors
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 675 Mass Ave, Cambridge, MA 02139, USA.
+ *
+ * For more information on the GPL, please go to:
+ * http://www.gnu.org/copyleft/gpl.html
+ */
+
+/**
+ * Streaming multi pattern matcher (Aho-Corasick).
+ *
+ * All patterns are compiled into one deterministic automaton with a full
+ * 256 entry transition table per state. Feeding data costs one table
+ * lookup per byte, independent of the number of patterns, and the state
+ * is carried over between calls, so patterns straddling the boundary of
+ * two chunks read from the device are found as well.
+ *
+ * Usage:
+ *   PatternMatcher m;
+ *   int id = m.addPattern("OK\r\n");
+ *   m.build();
+ *   m.feed(data, len, [&](int patternId, int end) { ...; return true; });
+ */
+
+#ifndef PATTERNMATCHER_H
+#define PATTERNMATCHER_H
+
+#include <QByteArray>
+#include <QList>
+#include <QString>
+#include <QVector>
+
+class PatternMatcher
+{
+public:
+    PatternMatcher();
+
+    /**
+     * @brief Add a pattern. build() needs to be called afterwards.
+     * @param pattern The byte sequence to search for, must not be empty
+     * @return The id of the pattern or -1 if the pattern is empty.
+     *  Adding the same byte sequence twice returns the same id.
+     */
+    int addPattern(const QByteArray &pattern);
+
+    /**
+     * @brief Remove all patterns and reset the automaton
+     */
+    void clear();
+
+    /**
+     * @brief Compile the added patterns into the automaton.
+     *  This resets the matching state.
+     */
+    void build();
+
+    /**
+     * @brief Forget about previously fed data
+     */
+    void reset() { m_state = 0; }
+
+    bool isEmpty() const { return m_patterns.isEmpty(); }
+    int patternCount() const { return m_patterns.size(); }
+    const QByteArray &pattern(int id) const { return m_patterns.at(id); }
+
+    /**
+     * @brief Feed data into the automaton
+     * @param data The bytes to scan
+     * @param len Number of bytes
+     * @param onMatch Called as onMatch(int patternId, int end) for every
+     *  match, end being the index of the last byte of the match within data.
+     *  If several patterns end at the same byte, the longest one is reported
+     *  first. Returning false stops the scan.
+     * @return The number of bytes consumed. This is less than len only if
+     *  the scan has been stopped by onMatch.
+     */
+    template <typename Callback> int feed(const char *data, int len, Callback onMatch);
+
+    /**
+     * @brief Convert user input into bytes. Supported escapes are
+     *  \r \n \t \0 \\ and \xNN. Other characters are taken as Latin-1.
+     */
+    static QByteArray fromEscaped(const QString &text);
+
+    /**
+     * @brief Inverse of fromEscaped()
+     */
+    static QString toEscaped(const QByteArray &data);
+
+    int feed(const QByteArray &data)
+    {
+        return feed(data.constData(), data.size(), [](int, int) { return true; });
+    }
+
+private:
+    enum { ALPHABET = 256 };
+
+    QList<QByteArray> m_patterns;
+
+    /**
+     * Transition table, ALPHABET entries per state
+     * @brief m_delta
+     */
+    QVector<qint32> m_delta;
+
+    /**
+     * Id of the pattern ending in a state or -1
+     * @brief m_match
+     */
+    QVector<qint32> m_match;
+
+    /**
+     * The first state reporting a match when the automaton enters
+     * a state: the state itself or the closest state along the failure
+     * links which has a pattern ending in it. -1 if there is none.
+     * @brief m_report
+     */
+    QVector<qint32> m_report;
+
+    /**
+     * The next state along the failure links which has a match
+     * @brief m_dictLink
+     */
+    QVector<qint32> m_dictLink;
+
+    qint32 m_state;
+};
+
+template <typename Callback> int PatternMatcher::feed(const char *data, int len, Callback onMatch)
+{
+    if (m_report.isEmpty())
+        return len;
+
+    const qint32 *delta = m_delta.constData();
+    const qint32 *report = m_report.constData();
+    const uchar *p = reinterpret_cast<const uchar *>(data);
+    qint32 s = m_state;
+
+    for (int i = 0; i < len; i++) {
+        s = delta[s * ALPHABET + p[i]];
+        for (qint32 r = report[s]; r > 0; r = m_dictLink.at(r)) {
+            if (!onMatch(m_match.at(r), i)) {
+                m_state = s;
+                return i + 1;
+            }
+        }
+    }
+    m_state = s;
+    return len;
+}
+
+#endif // PATTERNMATCHER_H
@@ -20,10 +20,15 @@
  */
 #include <plugin.h>
 
-Plugin::Plugin(QObject *owner, QString name, QFrame *frame, processCmd_fp processCmd)
+Plugin::Plugin(QObject *owner, QString name, QFrame *frame, processTx_fp processTx)
     : owner(owner)
     , name(name)
     , frame(frame)
-    , processCmd(processCmd)
+    , processTx(processTx)
+    , processRx(NULL)
+    , processEvent(NULL)
+    , rxAffinity(RX_INLINE)
+    , rxDropTolerant(false)
+    , rxQueueLimit(256)
 {
 }
@@ -22,20 +22,59 @@
 #ifndef PLUGIN_H
 #define PLUGIN_H
 
-#include <QFrame>
+#include <QByteArray>
 #include <QObject>
 #include <QString>
 
+/* the plugins of the GUI bring a frame, the core doesn't need to know it */
+class QFrame;
+
 class Plugin : public QObject
 {
     Q_OBJECT
 public:
-    typedef int (*processCmd_fp)(const QString *text, QString *new_text);
+    /* result of a TX hook. TX_REPLACED means the data have been changed */
+    enum TxResult { TX_UNCHANGED, TX_REPLACED };
+    /* called with the bytes that are about to be written to the device. The
+     * hook may modify them in place, nothing is copied as long as the data
+     * are left unchanged */
+    typedef TxResult (*processTx_fp)(QObject *owner, QByteArray &data);
+    /* called with every chunk read from the device on the thread given by
+     * rxAffinity. timestamp is the CaptureClock time of the read */
+    typedef void (*processRx_fp)(QObject *owner, const QByteArray &data, qint64 timestamp);
+    /* something happened on the device besides data */
+    enum DeviceEvent {
+        EVENT_CONTROL_LINES, /* value: QSerialPort::PinoutSignals, the state of the control lines */
+        EVENT_ERROR,         /* value: QSerialPort::SerialPortError, message: the error string */
+        EVENT_BREAK          /* value: break on/off, after opening the device and every change */
+    };
+    /* called on the GUI thread for every event of the device. timestamp is the
+     * CaptureClock time the event has been noticed */
+    typedef void (*processEvent_fp)(QObject *owner, DeviceEvent event, int value, const QString &message,
+                                    qint64 timestamp);
+    /* settings of the device a plugin may change, see controlPort() */
+    enum PortControl {
+        PORT_BAUD_RATE,    /* value: the baud rate */
+        PORT_DATA_BITS,    /* value: QSerialPort::DataBits */
+        PORT_PARITY,       /* value: QSerialPort::Parity */
+        PORT_STOP_BITS,    /* value: QSerialPort::StopBits */
+        PORT_FLOW_CONTROL, /* value: QSerialPort::FlowControl */
+        PORT_DTR,          /* value: DTR on/off */
+        PORT_RTS,          /* value: RTS on/off */
+        PORT_BREAK,        /* value: break on/off */
+        PORT_PURGE         /* value: QSerialPort::Directions to discard */
+    };
+    /* where processRx is called */
+    enum RxAffinity {
+        RX_INLINE, /* directly by the read handler, before the data are displayed */
+        RX_GUI,    /* queued, on the GUI thread */
+        RX_WORKER  /* queued, on a thread of the worker pool */
+    };
 
-    Plugin(QObject *owner,                 /* who owns the plugin */
-           QString name,                   /* name of plugin */
-           QFrame *frame = NULL,           /* Does the plugin has a UI interface? */
-           processCmd_fp processCmd = NULL /* function that injects the cmd */
+    Plugin(QObject *owner,               /* who owns the plugin */
+           QString name,                 /* name of plugin */
+           QFrame *frame = NULL,         /* Does the plugin has a UI interface? */
+           processTx_fp processTx = NULL /* function that injects the data to send */
     );
 
     ~Plugin() {}
@@ -43,10 +82,23 @@ public:
     QObject *owner;
     QString name;
     QFrame *frame;
-    processCmd_fp processCmd;
+    processTx_fp processTx;
+    processRx_fp processRx;
+    processEvent_fp processEvent;
+    RxAffinity rxAffinity;
+    /* queued chunks may be dropped if the plugin can't keep up */
+    bool rxDropTolerant;
+    /* max. number of queued chunks */
+    int rxQueueLimit;
 
 signals:
     void sendCmd(QString);
+    /* raw data to write to the device */
+    void writeData(QByteArray);
+    /* the plugin wants to be removed */
+    void unloadRequested();
+    /* change a setting of the open device, the control panel follows */
+    void controlPort(Plugin::PortControl control, int value);
 };
 
 #endif // PLUGIN_H
@@ -0,0 +1,83 @@
+/*
+ * Copyright (c) 2026 CuteCom contributors
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 675 Mass Ave, Cambridge, MA 02139, USA.
+ *
+ * For more information on the GPL, please go to:
+ * http://www.gnu.org/copyleft/gpl.html
+ */
+
+/**
+ * Interface of the plugins that are loaded at run time. A plugin library
+ * implements PluginInterface and declares its metadata, e.g.
+ *
+ *     class MyDecoder : public QObject, public PluginInterface
+ *     {
+ *         Q_OBJECT
+ *         Q_PLUGIN_METADATA(IID CuteComPluginInterface_iid FILE "mydecoder.json")
+ *         Q_INTERFACES(PluginInterface)
+ *     public:
+ *         Plugin *createPlugin(QWidget *parent);
+ *     };
+ *
+ * with mydecoder.json holding at least the name shown in the Plugins menu:
+ *
+ *     { "name": "My decoder", "description": "Decodes my protocol" }
+ *
+ * The libraries are searched in the directories of CUTECOM_PLUGIN_PATH
+ * (separated like PATH), in 'plugins' next to the executable and in the
+ * 'plugins' directory of the application data location. Only the metadata
+ * are read at startup, the library is loaded when the plugin is used for
+ * the first time.
+ *
+ * createPlugin() is called for every instance the user adds and returns
+ * the Plugin that describes it: an optional frame and the optional
+ * processRx/processTx hooks, which work on the buffers of the core without
+ * copying them. An instance writes to the device with Plugin::writeData(),
+ * changes its settings with Plugin::controlPort() and asks to be removed
+ * with Plugin::unloadRequested(). On removal the plugin manager deletes
+ * the frame and the Plugin, the frame should own everything else of the
+ * instance.
+ *
+ * The major version of the IID changes whenever this interface or the
+ * Plugin class change in an incompatible way, including new members of
+ * Plugin. Libraries built against another major version are ignored.
+ */
+
+#ifndef PLUGININTERFACE_H
+#define PLUGININTERFACE_H
+
+#include "plugin.h"
+#include <QFrame>
+#include <QtPlugin>
+
+#define CuteComPluginInterface_iid "org.cutecom.PluginInterface/1.0"
+
+class PluginInterface
+{
+public:
+    virtual ~PluginInterface() {}
+
+    /**
+     * @brief Create a new instance of the plugin
+     * @param parent Parent of the frame of the instance
+     * @return The plugin descriptor, owned by the instance
+     */
+    virtual Plugin *createPlugin(QWidget *parent) = 0;
+};
+
+Q_DECLARE_INTERFACE(PluginInterface, CuteComPluginInterface_iid)
+
+#endif // PLUGININTERFACE_H
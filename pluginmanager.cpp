@@ -20,6 +20,13 @@
  */
 
 #include "pluginmanager.h"
+#include "plugininterface.h"
+#include <QCoreApplication>
+#include <QDir>
+#include <QFileInfo>
+#include <QJsonObject>
+#include <QLibrary>
+#include <QStandardPaths>
 
 #define TRACE                                                                                                          \
     if (!debug) {                                                                                                      \
@@ -32,6 +39,7 @@ PluginManager::PluginManager(QFrame *parent, QVBoxLayout *layout, Settings *sett
     , m_layout(layout)
     , m_settings(settings)
 {
+    scanLibraries();
 }
 
 PluginManager::~PluginManager()
@@ -61,31 +69,149 @@ void PluginManager::addPluginType(en_plugin_type type)
     } else if (type == en_plugin_type::PLUGIN_TYPE_NET_PROXY) {
         NetProxyPlugin *proxy = new NetProxyPlugin(m_parent, m_settings);
         connect(proxy, &NetProxyPlugin::unload, this, &PluginManager::removePlugin);
-        connect(proxy, &NetProxyPlugin::sendCmd, this, &PluginManager::sendCmd);
-        connect(this, &PluginManager::recvCmd, proxy, &NetProxyPlugin::proxyCmd);
+        connect(proxy, &NetProxyPlugin::sendCmd, this, &PluginManager::writeData);
         /* common plugin initialization */
         addPlugin((Plugin *)proxy->plugin());
     } else if (type == en_plugin_type::PLUGIN_TYPE_BYTE_COUNTER) {
         CounterPlugin *counter = new CounterPlugin(m_parent, m_settings);
         connect(counter, &CounterPlugin::unload, this, &PluginManager::removePlugin);
-        connect(this, &PluginManager::recvCmd, counter, &CounterPlugin::rxBytes);
         /* common plugin initialization */
         addPlugin((Plugin *)counter->plugin());
+    } else if (type == en_plugin_type::PLUGIN_TYPE_SEND_EXPECT) {
+        SendExpectPlugin *sendExpect = new SendExpectPlugin(m_parent, m_settings);
+        connect(sendExpect, &SendExpectPlugin::unload, this, &PluginManager::removePlugin);
+        connect(sendExpect, &SendExpectPlugin::sendData, this, &PluginManager::writeData);
+        /* common plugin initialization */
+        addPlugin((Plugin *)sendExpect->plugin());
+    } else if (type == en_plugin_type::PLUGIN_TYPE_AUTO_RESPONDER) {
+        AutoResponderPlugin *responder = new AutoResponderPlugin(m_parent, m_settings);
+        connect(responder, &AutoResponderPlugin::unload, this, &PluginManager::removePlugin);
+        connect(responder, &AutoResponderPlugin::writeData, this, &PluginManager::writeData);
+        /* common plugin initialization */
+        addPlugin((Plugin *)responder->plugin());
+    } else if (type == en_plugin_type::PLUGIN_TYPE_FRAME_DECODER) {
+        FrameDecoderPlugin *decoder = new FrameDecoderPlugin(m_parent, m_settings);
+        connect(decoder, &FrameDecoderPlugin::unload, this, &PluginManager::removePlugin);
+        /* common plugin initialization */
+        addPlugin((Plugin *)decoder->plugin());
+    } else if (type == en_plugin_type::PLUGIN_TYPE_MODBUS) {
+        ModbusPlugin *modbus = new ModbusPlugin(m_parent, m_settings);
+        connect(modbus, &ModbusPlugin::unload, this, &PluginManager::removePlugin);
+        /* common plugin initialization */
+        addPlugin((Plugin *)modbus->plugin());
+        modbus->setRxQueue(m_rxQueues.last());
+    } else if (type == en_plugin_type::PLUGIN_TYPE_TRIGGER_CAPTURE) {
+        TriggerCapturePlugin *triggerCapturePlugin = new TriggerCapturePlugin(m_parent, m_settings);
+        connect(triggerCapturePlugin, &TriggerCapturePlugin::unload, this, &PluginManager::removePlugin);
+        /* common plugin initialization */
+        addPlugin((Plugin *)triggerCapturePlugin->plugin());
+    } else if (type == en_plugin_type::PLUGIN_TYPE_PTY_MUX) {
+        PtyMuxPlugin *ptyMuxPlugin = new PtyMuxPlugin(m_parent, m_settings);
+        connect(ptyMuxPlugin, &PtyMuxPlugin::unload, this, &PluginManager::removePlugin);
+        connect(ptyMuxPlugin, &PtyMuxPlugin::writeData, this, &PluginManager::writeData);
+        /* common plugin initialization */
+        addPlugin((Plugin *)ptyMuxPlugin->plugin());
+    }
+}
+
+/**
+ * @brief Look for plugin libraries. The directories of CUTECOM_PLUGIN_PATH
+ *  come first, if the same plugin name shows up twice the first one wins.
+ *  Only the metadata are read, nothing is loaded here.
+ */
+void PluginManager::scanLibraries()
+{
+    QStringList dirs
+        = QString::fromLocal8Bit(qgetenv("CUTECOM_PLUGIN_PATH")).split(QDir::listSeparator(), QString::SkipEmptyParts);
+    dirs << QCoreApplication::applicationDirPath() + QStringLiteral("/plugins");
+    dirs << QStandardPaths::writableLocation(QStandardPaths::AppDataLocation) + QStringLiteral("/plugins");
+
+    QStringList names;
+    foreach (const QString &path, dirs) {
+        QDir dir(path);
+        foreach (const QString &fileName, dir.entryList(QDir::Files)) {
+            if (!QLibrary::isLibrary(fileName))
+                continue;
+            QPluginLoader *loader = new QPluginLoader(dir.absoluteFilePath(fileName), this);
+            QJsonObject meta = loader->metaData();
+            if (meta.value(QStringLiteral("IID")).toString() != QLatin1String(CuteComPluginInterface_iid)) {
+                TRACE << "[PluginManager] Ignoring library: " << loader->fileName();
+                delete loader;
+                continue;
+            }
+            QJsonObject data = meta.value(QStringLiteral("MetaData")).toObject();
+            Library library;
+            library.name = data.value(QStringLiteral("name")).toString(QFileInfo(fileName).baseName());
+            library.description = data.value(QStringLiteral("description")).toString();
+            library.loader = loader;
+            if (names.contains(library.name)) {
+                delete loader;
+                continue;
+            }
+            names << library.name;
+            m_libraries.append(library);
+            TRACE << "[PluginManager] Found plugin library: " << library.name << loader->fileName();
+        }
     }
 }
 
+/**
+ * @brief Create an instance of a plugin library, the library is
+ *  loaded on first use
+ * @param index Index in libraries()
+ * @param error Set if the plugin could not be created
+ * @return true on success
+ */
+bool PluginManager::addLibraryPlugin(int index, QString *error)
+{
+    if (index < 0 || index >= m_libraries.size())
+        return false;
+
+    const Library &library = m_libraries.at(index);
+    PluginInterface *factory = qobject_cast<PluginInterface *>(library.loader->instance());
+    if (!factory) {
+        if (error)
+            *error = library.loader->errorString();
+        return false;
+    }
+    Plugin *plugin = factory->createPlugin(m_parent);
+    if (!plugin) {
+        if (error)
+            *error = tr("%1 could not create a new instance").arg(library.name);
+        return false;
+    }
+    connect(plugin, &Plugin::writeData, this, &PluginManager::writeData);
+    connect(plugin, &Plugin::unloadRequested, this, [=]() { removePlugin(plugin); });
+    addPlugin(plugin);
+    return true;
+}
+
 /**
  * @brief [SLOT] Remove an existing plugin
  * @param plugin A pointer to the plugin to delete
  */
 void PluginManager::removePlugin(Plugin *plugin)
 {
-    TRACE << "[PluginManager] Removing plugin: " << plugin->name;
     if (!plugin)
         return;
+    TRACE << "[PluginManager] Removing plugin: " << plugin->name;
 
+    /* the queue waits until the plugin is done with the received data */
+    for (int i = 0; i < m_rxQueues.size(); i++) {
+        if (m_rxQueues.at(i)->plugin() == plugin) {
+            delete m_rxQueues.takeAt(i);
+            break;
+        }
+    }
+    /* nothing an unloaded plugin does reaches the device anymore, e.g. a
+     * running script or clients of its PTYs and sockets */
+    disconnect(plugin, 0, this, 0);
     if (plugin->frame) {
+        disconnect(plugin->frame, 0, this, 0);
         plugin->frame->close();
+        /* the frame owns the engine of the plugin: its threads, timers
+         * and devices go away with it */
+        plugin->frame->deleteLater();
     }
     plugin->deleteLater();
     m_list.removeOne(plugin);
@@ -103,6 +229,9 @@ void PluginManager::addPlugin(Plugin *item)
         return;
 
     m_list.append(item);
+    connect(item, &Plugin::controlPort, this, &PluginManager::controlPort);
+    if (item->processRx)
+        m_rxQueues.append(new PluginRxQueue(item));
     /* if the plugin has also a frame then add it */
     if (item->frame) {
         QMargins mainMargins = m_layout->contentsMargins();
@@ -114,21 +243,109 @@ void PluginManager::addPlugin(Plugin *item)
 }
 
 /**
- * @brief Inject and process the cmd data before they sent
- * @param cmd The data
+ * @brief Inject and process the data before they are sent
+ * @param data The bytes to send, plugins may modify them in place
+ * @return true if any plugin replaced the data
  */
-void PluginManager::processCmd(QString *cmd)
+bool PluginManager::processTx(QByteArray &data)
 {
-    TRACE << "[PluginManager] process: " << *cmd;
+    bool replaced = false;
     QListIterator<Plugin *> i(m_list);
     while (i.hasNext()) {
-        const Plugin *item = static_cast<const Plugin *>(i.next());
-        if (item->processCmd) {
-            QString new_cmd;
-            if (item->processCmd(cmd, &new_cmd)) {
-                TRACE << "[PluginManager::processCmd]: " << cmd->toLatin1();
-                *cmd = new_cmd;
-            }
+        const Plugin *item = i.next();
+        if (item->processTx && item->processTx(item->owner, data) == Plugin::TX_REPLACED) {
+            TRACE << "[PluginManager::processTx]: " << item->name << data;
+            replaced = true;
         }
     }
+    return replaced;
+}
+
+/**
+ * @brief Hand the received data to the plugins. Inline plugins are called
+ *  right away, all others only get the data queued.
+ * @param data The data read from the device
+ * @param timestamp The CaptureClock time of the read
+ */
+void PluginManager::processRx(const QByteArray &data, qint64 timestamp)
+{
+    QListIterator<PluginRxQueue *> i(m_rxQueues);
+    while (i.hasNext())
+        i.next()->push(data, timestamp);
+}
+
+/**
+ * @brief Whether any plugin wants to know about events of the device,
+ *  polling the control lines is not needed otherwise
+ */
+bool PluginManager::hasEventHooks() const
+{
+    foreach (const Plugin *item, m_list) {
+        if (item->processEvent)
+            return true;
+    }
+    return false;
+}
+
+/**
+ * @brief Hand an event of the device to the plugins
+ * @param event What happened
+ * @param value Depends on the event, see Plugin::DeviceEvent
+ * @param message Description of an error
+ * @param timestamp The CaptureClock time the event has been noticed
+ */
+void PluginManager::processEvent(Plugin::DeviceEvent event, int value, const QString &message, qint64 timestamp)
+{
+    QListIterator<Plugin *> i(m_list);
+    while (i.hasNext()) {
+        const Plugin *item = i.next();
+        if (item->processEvent)
+            item->processEvent(item->owner, event, value, message, timestamp);
+    }
+}
+
+/**
+ * @brief RX statistics of a plugin
+ * @param plugin The plugin
+ * @return Empty statistics if the plugin doesn't process received data
+ */
+PluginRxQueue::Statistics PluginManager::rxStatistics(const Plugin *plugin) const
+{
+    foreach (const PluginRxQueue *queue, m_rxQueues) {
+        if (queue->plugin() == plugin)
+            return queue->statistics();
+    }
+    return PluginRxQueue::Statistics();
+}
+
+/**
+ * @brief Table with the RX statistics of all plugins
+ */
+QString PluginManager::rxStatisticsReport() const
+{
+    static const char *const affinity[] = {"inline", "gui", "worker"};
+
+    QString report = QString("%1 %2 %3 %4 %5 %6 %7\n")
+                         .arg(tr("plugin"), -16)
+                         .arg(tr("thread"), -7)
+                         .arg(tr("depth"), 9)
+                         .arg(tr("chunks"), 10)
+                         .arg(tr("drops"), 8)
+                         .arg(tr("avg [us]"), 9)
+                         .arg(tr("max [us]"), 9);
+    foreach (const PluginRxQueue *queue, m_rxQueues) {
+        const PluginRxQueue::Statistics stats = queue->statistics();
+        const Plugin *plugin = queue->plugin();
+        report += QString("%1 %2 %3 %4 %5 %6 %7\n")
+                      .arg(plugin->name.left(16), -16)
+                      .arg(QLatin1String(affinity[plugin->rxAffinity]), -7)
+                      .arg(QString("%1/%2").arg(stats.depth).arg(stats.peakDepth), 9)
+                      .arg(stats.chunks, 10)
+                      .arg(stats.drops, 8)
+                      .arg(stats.chunks ? stats.busyNs / 1000.0 / stats.chunks : 0.0, 9, 'f', 1)
+                      .arg(stats.maxNs / 1000.0, 9, 'f', 1);
+    }
+    if (m_rxQueues.isEmpty())
+        report += tr("No plugin processes the received data");
+    return report;
 }
@@ -31,26 +31,53 @@
  * that multiple instances can be loaded!
  *
  * The pluging manager provides plugins with the finctionality to be able to
- * change the content of the serial cmd string before it's send on the serial
- * port by using the function `processCmd()`. Because there can be several
- * plugins that may be able to modify this string, be aware that the priority
+ * change the bytes before they are sent on the serial port by using the
+ * `processTx` hook, which is called by `processTx()`. The hook works in place
+ * on the raw bytes, so binary data are safe and nothing is copied unless a
+ * plugin replaces the data. Because there can be several plugins that may
+ * be able to modify the data, be aware that the priority
  * order is the same with the index of the plugin in the plugin QList (m_list).
  * Also every pluging can send a serial command with the `sendCmd()` signal.
  *
+ * Plugins that consume the received data set the `processRx` hook and its
+ * `rxAffinity`. Plugins that need to react without any delay, e.g. to
+ * measure response times, run inline in the read handler before the data
+ * are displayed. All others get their own bounded PluginRxQueue and run
+ * on the GUI thread or on the worker pool, so a slow plugin can't hold up
+ * the reception. The queue depth, the time spent in the hook and the drops
+ * are available from `rxStatistics()`. Changes of the control lines and
+ * the break and errors of the device are handed to the `processEvent` hook
+ * on the GUI thread. Data written with the `writeData()` signal go
+ * straight to the device and bypass the input line and the command
+ * history.
+ *
+ * Besides the built-in plugins, plugin libraries implementing PluginInterface
+ * (see plugininterface.h) are found in the plugin path. Only their metadata
+ * are read by `scanLibraries()`, the library itself is loaded by
+ * `addLibraryPlugin()` when the first instance is created.
+ *
  * Make sure that plugins clean up themselves properly when unloaded.
  */
 
 #ifndef PLUGINMANAGER_H
 #define PLUGINMANAGER_H
 
+#include "autoresponderplugin.h"
 #include "counterplugin.h"
+#include "framedecoderplugin.h"
 #include "macroplugin.h"
+#include "modbusplugin.h"
 #include "netproxyplugin.h"
 #include "plugin.h"
+#include "pluginrxqueue.h"
+#include "ptymuxplugin.h"
+#include "sendexpectplugin.h"
 #include "settings.h"
+#include "triggercaptureplugin.h"
 #include <QDebug>
 #include <QFrame>
 #include <QObject>
+#include <QPluginLoader>
 #include <QVBoxLayout>
 
 class PluginManager : public QObject
@@ -63,27 +90,51 @@ public:
         PLUGIN_TYPE_MACROS,
         PLUGIN_TYPE_NET_PROXY,
         PLUGIN_TYPE_BYTE_COUNTER,
+        PLUGIN_TYPE_SEND_EXPECT,
+        PLUGIN_TYPE_AUTO_RESPONDER,
+        PLUGIN_TYPE_FRAME_DECODER,
+        PLUGIN_TYPE_MODBUS,
+        PLUGIN_TYPE_TRIGGER_CAPTURE,
+        PLUGIN_TYPE_PTY_MUX,
+    };
+    /* A plugin library found in the plugin path */
+    struct Library {
+        QString name;
+        QString description;
+        QPluginLoader *loader;
     };
     PluginManager(QFrame *parent, QVBoxLayout *layout, Settings *settings);
     virtual ~PluginManager();
-    void processCmd(QString *text);
+    const QList<Library> &libraries() const { return m_libraries; }
+    bool addLibraryPlugin(int index, QString *error);
+    bool processTx(QByteArray &data);
+    void processRx(const QByteArray &data, qint64 timestamp);
+    bool hasEventHooks() const;
+    void processEvent(Plugin::DeviceEvent event, int value, const QString &message, qint64 timestamp);
+    PluginRxQueue::Statistics rxStatistics(const Plugin *plugin) const;
+    QString rxStatisticsReport() const;
 
 public slots:
     void addPluginType(en_plugin_type);
     void removePlugin(Plugin *);
 
 signals:
-    void recvCmd(QByteArray); /* mainwindow -> manager */
     void sendCmd(QByteArray); /* manager -> mainwindow */
+    void writeData(QByteArray); /* manager -> device */
+    void controlPort(Plugin::PortControl control, int value); /* manager -> device settings */
 
 protected:
     void addPlugin(Plugin *item);
+    void scanLibraries();
 
 private:
     QFrame *m_parent;
     QVBoxLayout *m_layout;
     QList<Plugin *> m_list;
+    /* one for each plugin with a processRx hook, same order as m_list */
+    QList<PluginRxQueue *> m_rxQueues;
     Settings *m_settings;
+    QList<Library> m_libraries;
     /* Supported plugins */
     MacroPlugin *m_macro_plugin;
 };
@@ -0,0 +1,153 @@
+/*
+ * Copyright (c) 2026 CuteCom contributors
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 675 Mass Ave, Cambridge, MA 02139, USA.
+ *
+ * For more information on the GPL, please go to:
+ * http://www.gnu.org/copyleft/gpl.html
+ */
+
+#include "pluginrxqueue.h"
+#include <QElapsedTimer>
+#include <QMutexLocker>
+#include <QRunnable>
+#include <QThreadPool>
+#include <QTimer>
+
+/**
+ * Drains the queue on a thread of the global pool. Only one task per
+ * queue exists at a time, so the chunks are processed in order.
+ */
+class PluginRxQueue::Task : public QRunnable
+{
+public:
+    explicit Task(PluginRxQueue *queue)
+        : m_queue(queue)
+    {
+    }
+    void run() { m_queue->drain(); }
+
+private:
+    PluginRxQueue *m_queue;
+};
+
+PluginRxQueue::PluginRxQueue(Plugin *plugin)
+    : m_plugin(plugin)
+    , m_scheduled(false)
+    , m_closed(false)
+{
+}
+
+/**
+ * Waits for a worker that is still busy with this queue, the plugin
+ * must not be deleted before.
+ */
+PluginRxQueue::~PluginRxQueue()
+{
+    QMutexLocker lock(&m_mutex);
+    m_closed = true;
+    m_queue.clear();
+    m_notFull.wakeAll();
+    while (m_scheduled && m_plugin->rxAffinity == Plugin::RX_WORKER)
+        m_idle.wait(&m_mutex);
+}
+
+void PluginRxQueue::push(const QByteArray &data, qint64 timestamp)
+{
+    if (m_plugin->rxAffinity == Plugin::RX_INLINE) {
+        process(Chunk{data, timestamp});
+        return;
+    }
+
+    QMutexLocker lock(&m_mutex);
+    if (m_closed)
+        return;
+    if (m_queue.size() >= m_plugin->rxQueueLimit) {
+        if (m_plugin->rxDropTolerant) {
+            m_statistics.drops++;
+            return;
+        }
+        if (m_plugin->rxAffinity == Plugin::RX_GUI) {
+            /* we are on the GUI thread already */
+            lock.unlock();
+            drain();
+            lock.relock();
+        } else {
+            while (m_queue.size() >= m_plugin->rxQueueLimit && !m_closed)
+                m_notFull.wait(&m_mutex);
+            if (m_closed)
+                return;
+        }
+    }
+    m_queue.enqueue(Chunk{data, timestamp});
+    m_statistics.peakDepth = qMax(m_statistics.peakDepth, m_queue.size());
+    if (!m_scheduled) {
+        m_scheduled = true;
+        schedule();
+    }
+}
+
+PluginRxQueue::Statistics PluginRxQueue::statistics() const
+{
+    QMutexLocker lock(&m_mutex);
+    Statistics statistics = m_statistics;
+    statistics.depth = m_queue.size();
+    return statistics;
+}
+
+bool PluginRxQueue::isIdle() const
+{
+    QMutexLocker lock(&m_mutex);
+    // a drain is scheduled until the last chunk has been processed
+    return m_queue.isEmpty() && !m_scheduled;
+}
+
+void PluginRxQueue::schedule()
+{
+    if (m_plugin->rxAffinity == Plugin::RX_WORKER)
+        QThreadPool::globalInstance()->start(new Task(this));
+    else
+        QTimer::singleShot(0, this, [=]() { drain(); });
+}
+
+/**
+ * @brief Process all queued chunks, runs on the thread of the plugin
+ */
+void PluginRxQueue::drain()
+{
+    QMutexLocker lock(&m_mutex);
+    while (!m_queue.isEmpty() && !m_closed) {
+        Chunk chunk = m_queue.dequeue();
+        m_notFull.wakeAll();
+        lock.unlock();
+        process(chunk);
+        lock.relock();
+    }
+    m_scheduled = false;
+    m_idle.wakeAll();
+}
+
+void PluginRxQueue::process(const Chunk &chunk)
+{
+    QElapsedTimer timer;
+    timer.start();
+    m_plugin->processRx(m_plugin->owner, chunk.data, chunk.timestamp);
+    const qint64 elapsed = timer.nsecsElapsed();
+
+    QMutexLocker lock(&m_mutex);
+    m_statistics.chunks++;
+    m_statistics.busyNs += elapsed;
+    m_statistics.maxNs = qMax(m_statistics.maxNs, elapsed);
+}
@@ -0,0 +1,104 @@
+/*
+ * Copyright (c) 2026 CuteCom contributors
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 675 Mass Ave, Cambridge, MA 02139, USA.
+ *
+ * For more information on the GPL, please go to:
+ * http://www.gnu.org/copyleft/gpl.html
+ */
+
+/**
+ * Bounded queue that hands the received data to one plugin on the thread
+ * the plugin asked for (see Plugin::rxAffinity). The read handler only
+ * pushes the chunks, so an expensive plugin delays itself but not the
+ * reception or the other plugins.
+ *
+ * When the queue is full, chunks for plugins that tolerate drops are
+ * discarded and counted. All other plugins apply backpressure: a worker
+ * plugin blocks the read handler until there is space again, a GUI plugin
+ * gets its backlog processed right away by the read handler.
+ */
+
+#ifndef PLUGINRXQUEUE_H
+#define PLUGINRXQUEUE_H
+
+#include "plugin.h"
+#include <QMutex>
+#include <QObject>
+#include <QQueue>
+#include <QWaitCondition>
+
+class PluginRxQueue : public QObject
+{
+    Q_OBJECT
+
+public:
+    struct Statistics {
+        Statistics()
+            : depth(0)
+            , peakDepth(0)
+            , chunks(0)
+            , drops(0)
+            , busyNs(0)
+            , maxNs(0)
+        {
+        }
+        int depth;      /* chunks waiting right now */
+        int peakDepth;  /* highest depth seen */
+        quint64 chunks; /* chunks processed by the plugin */
+        quint64 drops;  /* chunks discarded because the queue was full */
+        qint64 busyNs;  /* total time spent in the hook */
+        qint64 maxNs;   /* longest single call of the hook */
+    };
+
+    explicit PluginRxQueue(Plugin *plugin);
+    ~PluginRxQueue();
+
+    const Plugin *plugin() const { return m_plugin; }
+
+    /**
+     * @brief Queue one chunk. Called by the read handler only.
+     */
+    void push(const QByteArray &data, qint64 timestamp);
+    Statistics statistics() const;
+
+    /**
+     * @brief Whether all queued chunks have been processed by the plugin
+     */
+    bool isIdle() const;
+
+private:
+    struct Chunk {
+        QByteArray data;
+        qint64 timestamp;
+    };
+    class Task;
+
+    void schedule();
+    void drain();
+    void process(const Chunk &chunk);
+
+    Plugin *m_plugin;
+    mutable QMutex m_mutex;
+    QWaitCondition m_notFull;
+    QWaitCondition m_idle;
+    QQueue<Chunk> m_queue;
+    /* a drain has been scheduled and did not finish yet */
+    bool m_scheduled;
+    bool m_closed;
+    Statistics m_statistics;
+};
+
+#endif // PLUGINRXQUEUE_H
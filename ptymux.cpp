@@ -0,0 +1,420 @@
+/*
+ * Copyright (c) 2026 CuteCom contributors
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 675 Mass Ave, Cambridge, MA 02139, USA.
+ *
+ * For more information on the GPL, please go to:
+ * http://www.gnu.org/copyleft/gpl.html
+ */
+
+#include "ptymux.h"
+
+#include <QDebug>
+
+#include <errno.h>
+#include <string.h>
+
+#ifdef Q_OS_UNIX
+#include <fcntl.h>
+#include <termios.h>
+#include <unistd.h>
+#if defined(Q_OS_LINUX)
+#include <pty.h>
+#elif defined(Q_OS_FREEBSD)
+#include <libutil.h>
+#else
+#include <util.h>
+#endif
+#endif
+
+#define TRACE                                                                                                          \
+    if (!debug) {                                                                                                      \
+    } else                                                                                                             \
+        qDebug()
+
+static bool debug = false;
+
+static QString errorString(int error) { return QString::fromLocal8Bit(::strerror(error)); }
+
+PtyMux::PtyMux(QObject *parent)
+    : QObject(parent)
+    , m_arbitration(ARBITRATE_CHUNKS)
+    , m_owner(0)
+    , m_next(0)
+    , m_ownerTimer(new QTimer(this))
+    , m_statisticsTimer(new QTimer(this))
+{
+    m_ownerTimer->setSingleShot(true);
+    connect(m_ownerTimer, &QTimer::timeout, this, &PtyMux::releaseOwner);
+    connect(m_statisticsTimer, &QTimer::timeout, this, &PtyMux::updateStatistics);
+    m_clock.start();
+}
+
+PtyMux::~PtyMux()
+{
+    foreach (Pty *pty, m_ptys) {
+        closePty(pty);
+        delete pty;
+    }
+}
+
+bool PtyMux::isSupported()
+{
+#ifdef Q_OS_UNIX
+    return true;
+#else
+    return false;
+#endif
+}
+
+/**
+ * @brief Create a PTY, its slave device is announced with statistics()
+ */
+void PtyMux::addPty()
+{
+#ifdef Q_OS_UNIX
+    int master;
+    int slave;
+    if (::openpty(&master, &slave, NULL, NULL, NULL) < 0) {
+        emit error(tr("Could not create a pseudo terminal: %1").arg(errorString(errno)));
+        return;
+    }
+    /* no echo, no line editing and no translation of line ends: the
+     * bytes go through as they are */
+    struct termios tio;
+    if (::tcgetattr(slave, &tio) == 0) {
+        ::cfmakeraw(&tio);
+        ::tcsetattr(slave, TCSANOW, &tio);
+    }
+    ::fcntl(master, F_SETFL, ::fcntl(master, F_GETFL) | O_NONBLOCK);
+    ::fcntl(master, F_SETFD, FD_CLOEXEC);
+    ::fcntl(slave, F_SETFD, FD_CLOEXEC);
+
+    char name[128];
+    Pty *pty = new Pty;
+    pty->master = master;
+    pty->slave = slave;
+    pty->path = (::ttyname_r(slave, name, sizeof(name)) == 0) ? QString::fromLocal8Bit(name) : QString();
+    pty->readNotifier = new QSocketNotifier(master, QSocketNotifier::Read, this);
+    // activated() is overloaded since Qt 5.15
+    connect(pty->readNotifier, SIGNAL(activated(int)), this, SLOT(readPty(int)));
+    pty->writeNotifier = new QSocketNotifier(master, QSocketNotifier::Write, this);
+    pty->writeNotifier->setEnabled(false);
+    connect(pty->writeNotifier, SIGNAL(activated(int)), this, SLOT(writePty(int)));
+    pty->offset = 0;
+    pty->queued = 0;
+    pty->lastInput = 0;
+    pty->written = 0;
+    pty->read = 0;
+    pty->drops = 0;
+    m_ptys.append(pty);
+
+    TRACE << "[PtyMux::addPty]" << pty->path;
+    updateStatistics();
+    if (!m_statisticsTimer->isActive())
+        m_statisticsTimer->start(STATISTICS_INTERVAL_MS);
+#else
+    emit error(tr("Pseudo terminals are not supported on this platform"));
+#endif
+}
+
+void PtyMux::removePty(const QString &path)
+{
+    foreach (Pty *pty, m_ptys) {
+        if (pty->path == path) {
+            removePty(pty);
+            return;
+        }
+    }
+}
+
+void PtyMux::removeAll()
+{
+    while (!m_ptys.isEmpty())
+        removePty(m_ptys.last());
+}
+
+void PtyMux::removePty(Pty *pty, const QString &reason)
+{
+    const int index = m_ptys.indexOf(pty);
+    m_ptys.removeAt(index);
+    if (m_next > index)
+        m_next--;
+    if (m_next >= m_ptys.size())
+        m_next = 0;
+
+    const bool owner = (m_owner == pty);
+    TRACE << "[PtyMux::removePty]" << pty->path << reason;
+    closePty(pty);
+    delete pty;
+    updateStatistics();
+    if (!reason.isEmpty())
+        emit error(reason);
+
+    if (owner) {
+        // the others may be waiting for the line of this one
+        m_owner = 0;
+        m_ownerTimer->stop();
+        arbitrate();
+    }
+}
+
+void PtyMux::closePty(Pty *pty)
+{
+    delete pty->readNotifier;
+    delete pty->writeNotifier;
+#ifdef Q_OS_UNIX
+    ::close(pty->master);
+    ::close(pty->slave);
+#endif
+}
+
+PtyMux::Pty *PtyMux::findPty(int fd)
+{
+    foreach (Pty *pty, m_ptys) {
+        if (pty->master == fd)
+            return pty;
+    }
+    return 0;
+}
+
+void PtyMux::setArbitration(int arbitration)
+{
+    m_arbitration = static_cast<Arbitration>(arbitration);
+    m_owner = 0;
+    m_ownerTimer->stop();
+    arbitrate();
+}
+
+/**
+ * @brief Hand the data of the device to all PTYs. The data are written
+ *  right away if the PTY has room, otherwise a reference is queued.
+ */
+void PtyMux::proxyCmd(const QByteArray &data)
+{
+#ifdef Q_OS_UNIX
+    if (data.isEmpty())
+        return;
+    QList<QPair<Pty *, int>> failed;
+    foreach (Pty *pty, m_ptys) {
+        int offset = 0;
+        if (pty->queue.isEmpty()) {
+            const ssize_t written = ::write(pty->master, data.constData(), data.size());
+            if (written < 0 && errno != EAGAIN && errno != EWOULDBLOCK && errno != EINTR) {
+                failed.append(qMakePair(pty, errno));
+                continue;
+            }
+            if (written > 0) {
+                pty->written += written;
+                offset = written;
+            }
+            if (offset == data.size())
+                continue;
+        }
+        const qint64 size = data.size() - offset;
+        while (!pty->queue.isEmpty() && pty->queued + size > QUEUE_LIMIT) {
+            pty->queued -= pty->queue.dequeue().size() - pty->offset;
+            pty->offset = 0;
+            pty->drops++;
+        }
+        if (size > QUEUE_LIMIT) {
+            pty->drops++;
+            continue;
+        }
+        if (pty->queue.isEmpty())
+            pty->offset = offset;
+        pty->queue.enqueue(data);
+        pty->queued += size;
+        pty->writeNotifier->setEnabled(true);
+    }
+    for (int i = 0; i < failed.size(); i++) {
+        Pty *pty = failed.at(i).first;
+        removePty(pty, tr("Writing to %1 failed: %2").arg(pty->path).arg(errorString(failed.at(i).second)));
+    }
+#else
+    Q_UNUSED(data);
+#endif
+}
+
+/**
+ * @brief Write the queued data to the PTY as long as it takes them
+ * @return false on an error
+ */
+bool PtyMux::flush(Pty *pty)
+{
+#ifdef Q_OS_UNIX
+    while (!pty->queue.isEmpty()) {
+        const QByteArray &head = pty->queue.head();
+        const ssize_t written = ::write(pty->master, head.constData() + pty->offset, head.size() - pty->offset);
+        if (written < 0)
+            return errno == EAGAIN || errno == EWOULDBLOCK || errno == EINTR;
+        pty->written += written;
+        pty->queued -= written;
+        pty->offset += written;
+        if (pty->offset < head.size())
+            return true;
+        pty->queue.dequeue();
+        pty->offset = 0;
+    }
+    pty->writeNotifier->setEnabled(false);
+#else
+    Q_UNUSED(pty);
+#endif
+    return true;
+}
+
+void PtyMux::writePty(int fd)
+{
+    Pty *pty = findPty(fd);
+    if (pty && !flush(pty))
+        removePty(pty, tr("Writing to %1 failed: %2").arg(pty->path).arg(errorString(errno)));
+}
+
+void PtyMux::readPty(int fd)
+{
+#ifdef Q_OS_UNIX
+    Pty *pty = findPty(fd);
+    if (!pty)
+        return;
+    char buffer[READ_CHUNK];
+    const ssize_t len = ::read(fd, buffer, sizeof(buffer));
+    if (len < 0 && (errno == EAGAIN || errno == EWOULDBLOCK || errno == EINTR))
+        return;
+    if (len <= 0) {
+        removePty(pty, tr("Reading from %1 failed: %2").arg(pty->path).arg(errorString(errno)));
+        return;
+    }
+    pty->input.append(buffer, len);
+    pty->lastInput = m_clock.elapsed();
+    // the writing process blocks until its data have been merged
+    if (pty->input.size() >= INPUT_LIMIT)
+        pty->readNotifier->setEnabled(false);
+    arbitrate();
+#else
+    Q_UNUSED(fd);
+#endif
+}
+
+bool PtyMux::take(Pty *pty, int max, QByteArray *out, bool toLineEnd)
+{
+    int len = qMin(max, pty->input.size());
+    bool lineEnd = false;
+    if (toLineEnd) {
+        const char *data = pty->input.constData();
+        for (int i = 0; i < len; i++) {
+            if (data[i] == '\n' || data[i] == '\r') {
+                // \r\n ends the line after the \n
+                if (data[i] == '\r' && i + 1 < len && data[i + 1] == '\n')
+                    i++;
+                len = i + 1;
+                lineEnd = true;
+                break;
+            }
+        }
+    }
+    out->append(pty->input.constData(), len);
+    pty->input.remove(0, len);
+    pty->read += len;
+    if (!pty->readNotifier->isEnabled() && pty->input.size() < INPUT_LIMIT)
+        pty->readNotifier->setEnabled(true);
+    return lineEnd;
+}
+
+/**
+ * @brief Merge the input of the PTYs and send it to the device with one
+ *  sendCmd()
+ */
+void PtyMux::arbitrate()
+{
+    if (m_ptys.isEmpty())
+        return;
+
+    QByteArray out;
+    if (m_arbitration == ARBITRATE_LINES) {
+        for (;;) {
+            if (!m_owner) {
+                for (int i = 0; i < m_ptys.size() && !m_owner; i++) {
+                    Pty *pty = m_ptys.at((m_next + i) % m_ptys.size());
+                    if (!pty->input.isEmpty()) {
+                        m_owner = pty;
+                        m_next = (m_next + i + 1) % m_ptys.size();
+                    }
+                }
+                if (!m_owner)
+                    break;
+            }
+            if (!take(m_owner, m_owner->input.size(), &out, true))
+                break;
+            m_owner = 0;
+        }
+        if (m_owner)
+            m_ownerTimer->start(qMax<qint64>(0, LINE_TIMEOUT_MS - (m_clock.elapsed() - m_owner->lastInput)));
+        else
+            m_ownerTimer->stop();
+    } else {
+        bool more = true;
+        while (more) {
+            more = false;
+            for (int i = 0; i < m_ptys.size(); i++) {
+                Pty *pty = m_ptys.at((m_next + i) % m_ptys.size());
+                if (pty->input.isEmpty())
+                    continue;
+                take(pty, MAX_TURN, &out, false);
+                more |= !pty->input.isEmpty();
+            }
+        }
+        m_next = (m_next + 1) % m_ptys.size();
+    }
+
+    if (!out.isEmpty())
+        emit sendCmd(out);
+}
+
+/**
+ * @brief The PTY holding the device in ARBITRATE_LINES mode has been
+ *  silent for LINE_TIMEOUT_MS, let the others have their turn
+ */
+void PtyMux::releaseOwner()
+{
+    if (!m_owner)
+        return;
+    const qint64 silent = m_clock.elapsed() - m_owner->lastInput;
+    if (silent < LINE_TIMEOUT_MS) {
+        m_ownerTimer->start(LINE_TIMEOUT_MS - silent);
+        return;
+    }
+    TRACE << "[PtyMux::releaseOwner]" << m_owner->path;
+    m_owner = 0;
+    arbitrate();
+}
+
+void PtyMux::updateStatistics()
+{
+    QVector<PtyStatistics> ptys;
+    ptys.reserve(m_ptys.size());
+    foreach (Pty *pty, m_ptys) {
+        PtyStatistics statistics;
+        statistics.path = pty->path;
+        statistics.written = pty->written;
+        statistics.read = pty->read;
+        statistics.queued = pty->queued;
+        statistics.drops = pty->drops;
+        ptys.append(statistics);
+    }
+    emit statistics(ptys);
+    // the empty list has been sent once, nothing changes until the next PTY
+    if (m_ptys.isEmpty())
+        m_statisticsTimer->stop();
+}
@@ -0,0 +1,149 @@
+/*
+ * Copyright (c) 2026 CuteCom contributors
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 675 Mass Ave, Cambridge, MA 02139, USA.
+ *
+ * For more information on the GPL, please go to:
+ * http://www.gnu.org/copyleft/gpl.html
+ */
+
+/**
+ * Pseudo terminals mirroring the device. Every PTY created by addPty()
+ * gets the data read from the device and whatever a process writes to the
+ * PTY goes to the device, so a test script can use the port while CuteCom
+ * shows the traffic. PtyMux lives on a thread of its own.
+ *
+ * The received data are handed to all PTYs as the same implicitly shared
+ * QByteArray, a PTY whose reader is slow queues references to it, not
+ * copies. The writes of several PTYs are merged by the Arbitration: either
+ * round robin in turns of MAX_TURN bytes or line by line, where a PTY that
+ * started a line keeps the device until the line is complete or it has
+ * been silent for LINE_TIMEOUT_MS.
+ */
+
+#ifndef PTYMUX_H
+#define PTYMUX_H
+
+#include <QElapsedTimer>
+#include <QMetaType>
+#include <QObject>
+#include <QQueue>
+#include <QSocketNotifier>
+#include <QTimer>
+#include <QVector>
+
+class PtyMux : public QObject
+{
+    Q_OBJECT
+
+public:
+    enum Arbitration {
+        ARBITRATE_CHUNKS = 0, /* round robin, MAX_TURN bytes per PTY and turn */
+        ARBITRATE_LINES       /* whole lines, a PTY keeps the device until its line is complete */
+    };
+
+    struct PtyStatistics {
+        /* the slave device other programs open, e.g. /dev/pts/3 */
+        QString path;
+        /* bytes device -> PTY and PTY -> device */
+        quint64 written;
+        quint64 read;
+        /* bytes waiting for the reader of the PTY */
+        qint64 queued;
+        /* chunks dropped because the queue was full */
+        quint32 drops;
+    };
+
+    enum {
+        READ_CHUNK = 4096,
+        /* bytes of a PTY merged before the next PTY gets its turn */
+        MAX_TURN = 256,
+        /* unmerged bytes of a PTY before it is no longer read */
+        INPUT_LIMIT = 64 * 1024,
+        /* device data queued for a PTY before the oldest are dropped */
+        QUEUE_LIMIT = 1024 * 1024,
+        LINE_TIMEOUT_MS = 100,
+        STATISTICS_INTERVAL_MS = 500
+    };
+
+    explicit PtyMux(QObject *parent = 0);
+    ~PtyMux();
+    /* PTYs can be created on this platform */
+    static bool isSupported();
+
+public slots:
+    /* the PTYs show up in the next statistics() */
+    void addPty();
+    void removePty(const QString &path);
+    void removeAll();
+    /* an Arbitration */
+    void setArbitration(int arbitration);
+    /* data serial port -> all PTYs */
+    void proxyCmd(const QByteArray &data);
+
+signals:
+    /* merged data PTYs -> serial port */
+    void sendCmd(QByteArray);
+    void error(QString);
+    void statistics(QVector<PtyMux::PtyStatistics>);
+
+private slots:
+    void readPty(int fd);
+    void writePty(int fd);
+    void arbitrate();
+    void releaseOwner();
+    void updateStatistics();
+
+private:
+    struct Pty {
+        int master;
+        /* kept open, so the PTY survives its readers closing it */
+        int slave;
+        QString path;
+        QSocketNotifier *readNotifier;
+        QSocketNotifier *writeNotifier;
+        /* device data not written yet, the first one from offset on */
+        QQueue<QByteArray> queue;
+        int offset;
+        qint64 queued;
+        /* data of the process not merged yet */
+        QByteArray input;
+        qint64 lastInput;
+        quint64 written;
+        quint64 read;
+        quint32 drops;
+    };
+
+    Pty *findPty(int fd);
+    void closePty(Pty *pty);
+    void removePty(Pty *pty, const QString &reason = QString());
+    bool flush(Pty *pty);
+    /* move up to max bytes of the input of a PTY to out, returns true at the end of a line */
+    bool take(Pty *pty, int max, QByteArray *out, bool toLineEnd);
+
+    QList<Pty *> m_ptys;
+    Arbitration m_arbitration;
+    /* the PTY that has started a line in ARBITRATE_LINES mode */
+    Pty *m_owner;
+    /* index of the PTY that gets the next turn */
+    int m_next;
+    QTimer *m_ownerTimer;
+    QTimer *m_statisticsTimer;
+    QElapsedTimer m_clock;
+};
+
+Q_DECLARE_METATYPE(PtyMux::PtyStatistics)
+
+#endif // PTYMUX_H
@@ -0,0 +1,165 @@
+/*
+ * Copyright (c) 2026 CuteCom contributors
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 675 Mass Ave, Cambridge, MA 02139, USA.
+ *
+ * For more information on the GPL, please go to:
+ * http://www.gnu.org/copyleft/gpl.html
+ */
+
+#include "ptymuxplugin.h"
+#include "ui_ptymuxplugin.h"
+#include <QHeaderView>
+#include <QMessageBox>
+#include <QSet>
+
+#define TRACE                                                                                                          \
+    if (!debug) {                                                                                                      \
+    } else                                                                                                             \
+        qDebug()
+
+static bool debug = false;
+
+PtyMuxPlugin::PtyMuxPlugin(QFrame *parent, Settings *)
+    : QFrame(parent)
+    , ui(new Ui::PtyMuxPlugin)
+{
+    ui->setupUi(this);
+    /* Has QFrame, no injection process cmd, the received data are queued to the PTY thread right away */
+    m_plugin = new Plugin(this, "PTY multiplexer", this);
+    m_plugin->processRx = &PtyMuxPlugin::processRx;
+    m_plugin->rxAffinity = Plugin::RX_INLINE;
+
+    qRegisterMetaType<QVector<PtyMux::PtyStatistics>>();
+
+    m_mux = new PtyMux;
+    m_mux->moveToThread(&m_ioThread);
+    connect(&m_ioThread, &QThread::finished, m_mux, &QObject::deleteLater);
+    /* data from the PTYs, merged on the PTY thread -> device */
+    connect(m_mux, &PtyMux::sendCmd, this, &PtyMuxPlugin::writeData);
+    /* data from the device -> PTYs, all of them share the same buffer */
+    connect(this, &PtyMuxPlugin::proxyCmd, m_mux, &PtyMux::proxyCmd);
+    connect(m_mux, &PtyMux::statistics, this, &PtyMuxPlugin::updatePtys);
+    connect(m_mux, &PtyMux::error, this, &PtyMuxPlugin::muxError);
+    m_ioThread.setObjectName(QStringLiteral("PtyMux"));
+    m_ioThread.start();
+
+    ui->m_table_ptys->horizontalHeader()->setSectionResizeMode(QHeaderView::ResizeToContents);
+    ui->m_table_ptys->horizontalHeader()->setStretchLastSection(true);
+    ui->m_table_ptys->verticalHeader()->hide();
+
+    connect(ui->m_bt_unload, &QPushButton::clicked, this, &PtyMuxPlugin::removePlugin);
+    connect(ui->m_bt_help, &QPushButton::clicked, this, &PtyMuxPlugin::helpMsg);
+    connect(ui->m_bt_add, &QPushButton::clicked, this,
+            [=]() { QMetaObject::invokeMethod(m_mux, "addPty", Qt::QueuedConnection); });
+    connect(ui->m_bt_remove, &QPushButton::clicked, this, &PtyMuxPlugin::removePtys);
+    connect(ui->m_combo_arbitration, static_cast<void (QComboBox::*)(int)>(&QComboBox::currentIndexChanged), this,
+            [=](int arbitration) {
+                QMetaObject::invokeMethod(m_mux, "setArbitration", Qt::QueuedConnection, Q_ARG(int, arbitration));
+            });
+
+    if (!PtyMux::isSupported()) {
+        ui->m_bt_add->setEnabled(false);
+        ui->m_bt_add->setToolTip(tr("Pseudo terminals are not supported on this platform"));
+    }
+
+    TRACE << "[PtyMuxPlugin::PtyMuxPlugin]";
+}
+
+PtyMuxPlugin::~PtyMuxPlugin()
+{
+    /* the multiplexer closes the PTYs when it is deleted on its thread */
+    m_ioThread.quit();
+    m_ioThread.wait();
+    delete ui;
+}
+
+/**
+ * @brief Called by the plugin manager with the received data, which
+ *  are handed to the PTY thread
+ */
+void PtyMuxPlugin::processRx(QObject *owner, const QByteArray &data, qint64)
+{
+    emit static_cast<PtyMuxPlugin *>(owner)->proxyCmd(data);
+}
+
+void PtyMuxPlugin::removePtys()
+{
+    QSet<int> rows;
+    foreach (const QTableWidgetItem *item, ui->m_table_ptys->selectedItems()) {
+        rows.insert(item->row());
+    }
+    foreach (int row, rows) {
+        const QTableWidgetItem *item = ui->m_table_ptys->item(row, COL_PTY);
+        if (item)
+            QMetaObject::invokeMethod(m_mux, "removePty", Qt::QueuedConnection, Q_ARG(QString, item->text()));
+    }
+}
+
+void PtyMuxPlugin::updatePtys(const QVector<PtyMux::PtyStatistics> &ptys)
+{
+    ui->m_table_ptys->setRowCount(ptys.size());
+    for (int row = 0; row < ptys.size(); row++) {
+        const PtyMux::PtyStatistics &pty = ptys.at(row);
+        const QString cells[NUMBER_OF_COLUMNS]
+            = {pty.path, QString::number(pty.written / 1024.0, 'f', 1), QString::number(pty.read / 1024.0, 'f', 1),
+               QString::number(pty.queued / 1024.0, 'f', 1), QString::number(pty.drops)};
+        for (int col = COL_PTY; col < NUMBER_OF_COLUMNS; col++) {
+            QTableWidgetItem *item = ui->m_table_ptys->item(row, col);
+            if (!item) {
+                item = new QTableWidgetItem();
+                ui->m_table_ptys->setItem(row, col, item);
+            }
+            item->setText(cells[col]);
+        }
+    }
+}
+
+void PtyMuxPlugin::muxError(const QString &message) { QMessageBox::critical(this, tr("Error"), message); }
+
+/**
+ * @brief Return a pointer to the plugin data
+ * @return
+ */
+const Plugin *PtyMuxPlugin::plugin() { return m_plugin; }
+
+/**
+ * @brief [SLOT] Send unload command to the plugin manager
+ */
+void PtyMuxPlugin::removePlugin(bool) { emit unload(m_plugin); }
+
+/**
+ * @brief Help message for the PTY multiplexer plugin
+ */
+void PtyMuxPlugin::helpMsg(void)
+{
+    QString help_str = tr("This plugin shares the device with other programs, e.g. a\n"
+                          "test script, while CuteCom keeps showing the traffic.\n\n"
+                          "Every PTY added gets a device like /dev/pts/3, which the\n"
+                          "other program opens instead of the serial port. It reads\n"
+                          "the data received from the device and whatever it writes\n"
+                          "is sent to the device. The PTYs stay until they are\n"
+                          "removed, the programs may open and close them any time.\n\n"
+                          "If several programs write at the same time, their data\n"
+                          "are merged either round robin in small turns or line by\n"
+                          "line: a program that started a line keeps the device until\n"
+                          "the line is complete or it has been silent for %1 ms.\n\n"
+                          "A program that doesn't read its PTY gets up to %2 KB\n"
+                          "queued, after that the oldest data are dropped.\n")
+                           .arg(PtyMux::LINE_TIMEOUT_MS)
+                           .arg(PtyMux::QUEUE_LIMIT / 1024);
+
+    QMessageBox::information(this, tr("How to use the PTY multiplexer"), help_str);
+}
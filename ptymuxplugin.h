@@ -0,0 +1,78 @@
+/*
+ * Copyright (c) 2026 CuteCom contributors
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 675 Mass Ave, Cambridge, MA 02139, USA.
+ *
+ * For more information on the GPL, please go to:
+ * http://www.gnu.org/copyleft/gpl.html
+ */
+
+#ifndef PTYMUXPLUGIN_H
+#define PTYMUXPLUGIN_H
+
+#include "plugin.h"
+#include "ptymux.h"
+#include "settings.h"
+#include <QDebug>
+#include <QFrame>
+#include <QThread>
+
+namespace Ui
+{
+class PtyMuxPlugin;
+}
+
+class PtyMuxPlugin : public QFrame
+{
+    Q_OBJECT
+
+public:
+    explicit PtyMuxPlugin(QFrame *parent, Settings *settings);
+    ~PtyMuxPlugin();
+    const Plugin *plugin();
+
+signals:
+    void writeData(QByteArray); /* PTYs -> device */
+    void proxyCmd(QByteArray);  /* device -> PTYs */
+    void unload(Plugin *);
+
+public slots:
+    void removePlugin(bool);
+    void helpMsg(void);
+
+private slots:
+    void removePtys();
+    void addRow(const QString &path);
+    void removeRow(const QString &path);
+    void updatePtys(const QVector<PtyMux::PtyStatistics> &ptys);
+    void muxError(const QString &message);
+
+private:
+    enum Columns { COL_PTY, COL_WRITTEN, COL_READ, COL_QUEUE, COL_DROPS, NUMBER_OF_COLUMNS };
+
+    static void processRx(QObject *owner, const QByteArray &data, qint64 timestamp);
+
+    Ui::PtyMuxPlugin *ui;
+    Plugin *m_plugin;
+    /**
+     * The PTYs are served on this thread, a process that doesn't read
+     * its PTY must neither stall the GUI nor the serial port
+     * @brief m_ioThread
+     */
+    QThread m_ioThread;
+    PtyMux *m_mux;
+};
+
+#endif // PTYMUXPLUGIN_H
@@ -0,0 +1,412 @@
+/*
+ * Copyright (c) 2026 CuteCom contributors
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 675 Mass Ave, Cambridge, MA 02139, USA.
+ *
+ * For more information on the GPL, please go to:
+ * http://www.gnu.org/copyleft/gpl.html
+ */
+
+#include "rfc2217.h"
+
+#include <string.h>
+
+/* QSerialPort::PinoutSignal, the codec doesn't depend on the serial port module */
+enum Pinout { PINOUT_DCD = 0x08, PINOUT_DSR = 0x10, PINOUT_RI = 0x20, PINOUT_CTS = 0x80 };
+
+static inline quint64 optionBit(uchar option) { return Q_UINT64_C(1) << option; }
+
+/* options the server enables on its side */
+static inline bool supportedOurs(uchar option)
+{
+    return option == Rfc2217Server::OPTION_BINARY || option == Rfc2217Server::OPTION_SGA;
+}
+
+/* options the server accepts from the client */
+static inline bool supportedTheirs(uchar option)
+{
+    return supportedOurs(option) || option == Rfc2217Server::OPTION_COM_PORT;
+}
+
+Rfc2217Server::Rfc2217Server()
+    : m_state(STATE_DATA)
+    , m_command(0)
+    // the greeting asks for these, the answers of the client are acknowledgements
+    , m_ours(optionBit(OPTION_BINARY) | optionBit(OPTION_SGA))
+    , m_theirs(optionBit(OPTION_BINARY) | optionBit(OPTION_SGA) | optionBit(OPTION_COM_PORT))
+    , m_comPort(false)
+    , m_suspended(false)
+    , m_modemStateMask(0xff)
+    , m_modemState(-1)
+{
+}
+
+QByteArray Rfc2217Server::greeting()
+{
+    const char greeting[] = {char(IAC), char(WILL), char(OPTION_BINARY), char(IAC), char(DO),   char(OPTION_BINARY),
+                             char(IAC), char(WILL), char(OPTION_SGA),    char(IAC), char(DO),   char(OPTION_SGA),
+                             char(IAC), char(DO),   char(OPTION_COM_PORT)};
+    return QByteArray(greeting, sizeof(greeting));
+}
+
+void Rfc2217Server::feed(const char *in, int len, QByteArray *data, QByteArray *reply, QVector<Request> *requests)
+{
+    const char *p = in;
+    const char *end = in + len;
+    while (p < end) {
+        switch (m_state) {
+        case STATE_DATA: {
+            // the payload is copied in one piece up to the next command
+            const char *iac = static_cast<const char *>(memchr(p, IAC, end - p));
+            const char *stop = iac ? iac : end;
+            data->append(p, stop - p);
+            p = stop;
+            if (iac) {
+                m_state = STATE_IAC;
+                p++;
+            }
+            break;
+        }
+        case STATE_IAC: {
+            const uchar c = uchar(*p++);
+            switch (c) {
+            case IAC:
+                data->append(char(IAC));
+                m_state = STATE_DATA;
+                break;
+            case WILL:
+            case WONT:
+            case DO:
+            case DONT:
+                m_command = c;
+                m_state = STATE_OPTION;
+                break;
+            case SB:
+                m_sb.clear();
+                m_state = STATE_SB;
+                break;
+            default:
+                // NOP, go ahead and the like
+                m_state = STATE_DATA;
+                break;
+            }
+            break;
+        }
+        case STATE_OPTION:
+            negotiate(m_command, uchar(*p++), reply);
+            m_state = STATE_DATA;
+            break;
+        case STATE_SB: {
+            const char c = *p++;
+            if (uchar(c) == IAC)
+                m_state = STATE_SB_IAC;
+            else if (m_sb.size() < MAX_SUBNEGOTIATION)
+                m_sb.append(c);
+            break;
+        }
+        case STATE_SB_IAC: {
+            const uchar c = uchar(*p++);
+            if (c == SE) {
+                subnegotiation(reply, requests);
+                m_state = STATE_DATA;
+            } else {
+                if (c == IAC && m_sb.size() < MAX_SUBNEGOTIATION)
+                    m_sb.append(char(IAC));
+                m_state = STATE_SB;
+            }
+            break;
+        }
+        }
+    }
+}
+
+/**
+ * Answers a request of the client only if it changes the state of the
+ * option, so acknowledgements don't start a negotiation loop.
+ * \brief Rfc2217Server::negotiate
+ */
+void Rfc2217Server::negotiate(uchar command, uchar option, QByteArray *reply)
+{
+    char answer = 0;
+    switch (command) {
+    case WILL:
+        if (!supportedTheirs(option)) {
+            answer = char(DONT);
+            break;
+        }
+        if (option == OPTION_COM_PORT)
+            m_comPort = true;
+        if (!(m_theirs & optionBit(option))) {
+            m_theirs |= optionBit(option);
+            answer = char(DO);
+        }
+        break;
+    case WONT:
+        if (option == OPTION_COM_PORT)
+            m_comPort = false;
+        if (supportedTheirs(option) && (m_theirs & optionBit(option))) {
+            m_theirs &= ~optionBit(option);
+            answer = char(DONT);
+        }
+        break;
+    case DO:
+        if (!supportedOurs(option)) {
+            answer = char(WONT);
+            break;
+        }
+        if (!(m_ours & optionBit(option))) {
+            m_ours |= optionBit(option);
+            answer = char(WILL);
+        }
+        break;
+    case DONT:
+        if (supportedOurs(option) && (m_ours & optionBit(option))) {
+            m_ours &= ~optionBit(option);
+            answer = char(WONT);
+        }
+        break;
+    }
+    if (answer) {
+        reply->append(char(IAC));
+        reply->append(answer);
+        reply->append(char(option));
+    }
+}
+
+void Rfc2217Server::subnegotiation(QByteArray *reply, QVector<Request> *requests)
+{
+    if (m_sb.size() < 2 || uchar(m_sb.at(0)) != OPTION_COM_PORT)
+        return;
+    m_comPort = true;
+
+    const uchar command = uchar(m_sb.at(1));
+    const QByteArray value = m_sb.mid(2);
+    Request request;
+    request.command = static_cast<Command>(command);
+    request.value = 0;
+    for (int i = 0; i < value.size() && i < 4; i++)
+        request.value = (request.value << 8) | uchar(value.at(i));
+
+    switch (command) {
+    case SIGNATURE:
+        // an empty signature asks for ours
+        if (value.isEmpty())
+            reply->append(frame(SIGNATURE + SERVER_OFFSET, QByteArrayLiteral("CuteCom")));
+        break;
+    case SET_BAUDRATE:
+        if (value.size() == 4)
+            requests->append(request);
+        break;
+    case SET_DATASIZE:
+    case SET_PARITY:
+    case SET_STOPSIZE:
+    case SET_CONTROL:
+    case PURGE_DATA:
+        if (value.size() == 1)
+            requests->append(request);
+        break;
+    case NOTIFY_LINESTATE:
+        // line errors are not reported by QSerialPort in time
+        reply->append(frame(NOTIFY_LINESTATE + SERVER_OFFSET, QByteArray(1, '\0')));
+        break;
+    case NOTIFY_MODEMSTATE:
+        // the client polls the modem lines
+        reply->append(frame(NOTIFY_MODEMSTATE + SERVER_OFFSET,
+                            QByteArray(1, char((m_modemState < 0) ? 0 : m_modemState & m_modemStateMask))));
+        break;
+    case FLOWCONTROL_SUSPEND:
+        m_suspended = true;
+        break;
+    case FLOWCONTROL_RESUME:
+        m_suspended = false;
+        break;
+    case SET_LINESTATE_MASK:
+        reply->append(frame(command + SERVER_OFFSET, value.left(1)));
+        break;
+    case SET_MODEMSTATE_MASK:
+        if (value.size() == 1)
+            m_modemStateMask = quint8(request.value);
+        reply->append(frame(command + SERVER_OFFSET, value.left(1)));
+        break;
+    default:
+        break;
+    }
+}
+
+bool Rfc2217Server::isQuery(const Request &request)
+{
+    switch (request.command) {
+    case SET_BAUDRATE:
+    case SET_DATASIZE:
+    case SET_PARITY:
+    case SET_STOPSIZE:
+        return request.value == 0;
+    case SET_CONTROL:
+        return request.value == CONTROL_FLOW_QUERY || request.value == CONTROL_BREAK_QUERY
+               || request.value == CONTROL_DTR_QUERY || request.value == CONTROL_RTS_QUERY
+               || request.value > CONTROL_RTS_OFF;
+    case PURGE_DATA:
+        return false;
+    default:
+        return true;
+    }
+}
+
+quint32 Rfc2217Server::apply(const Request &request, PortState *port)
+{
+    const quint32 value = request.value;
+    switch (request.command) {
+    case SET_BAUDRATE:
+        if (value)
+            port->baudRate = value;
+        return port->baudRate;
+    case SET_DATASIZE:
+        if (value >= 5 && value <= 8)
+            port->dataSize = quint8(value);
+        return port->dataSize;
+    case SET_PARITY:
+        if (value >= PARITY_NONE && value <= PARITY_SPACE)
+            port->parity = quint8(value);
+        return port->parity;
+    case SET_STOPSIZE:
+        if (value >= STOPSIZE_1 && value <= STOPSIZE_1_5)
+            port->stopSize = quint8(value);
+        return port->stopSize;
+    case SET_CONTROL:
+        switch (value) {
+        case CONTROL_FLOW_QUERY:
+            return port->flowControl;
+        case CONTROL_FLOW_NONE:
+        case CONTROL_FLOW_XONXOFF:
+        case CONTROL_FLOW_HARDWARE:
+            port->flowControl = quint8(value);
+            return value;
+        case CONTROL_BREAK_QUERY:
+            return port->breakOn ? CONTROL_BREAK_ON : CONTROL_BREAK_OFF;
+        case CONTROL_BREAK_ON:
+        case CONTROL_BREAK_OFF:
+            port->breakOn = (value == CONTROL_BREAK_ON);
+            return value;
+        case CONTROL_DTR_QUERY:
+            return port->dtr ? CONTROL_DTR_ON : CONTROL_DTR_OFF;
+        case CONTROL_DTR_ON:
+        case CONTROL_DTR_OFF:
+            port->dtr = (value == CONTROL_DTR_ON);
+            return value;
+        case CONTROL_RTS_QUERY:
+            return port->rts ? CONTROL_RTS_ON : CONTROL_RTS_OFF;
+        case CONTROL_RTS_ON:
+        case CONTROL_RTS_OFF:
+            port->rts = (value == CONTROL_RTS_ON);
+            return value;
+        default:
+            // inbound flow control is not supported
+            return value;
+        }
+    default:
+        return value;
+    }
+}
+
+QByteArray Rfc2217Server::response(Command command, quint32 value)
+{
+    QByteArray bytes;
+    if (command == SET_BAUDRATE) {
+        bytes.append(char(value >> 24));
+        bytes.append(char(value >> 16));
+        bytes.append(char(value >> 8));
+    }
+    bytes.append(char(value));
+    return frame(command + SERVER_OFFSET, bytes);
+}
+
+QByteArray Rfc2217Server::frame(uchar command, const QByteArray &value)
+{
+    QByteArray out;
+    out.reserve(6 + 2 * value.size());
+    out.append(char(IAC));
+    out.append(char(SB));
+    out.append(char(OPTION_COM_PORT));
+    out.append(char(command));
+    escape(value.constData(), value.size(), &out);
+    out.append(char(IAC));
+    out.append(char(SE));
+    return out;
+}
+
+void Rfc2217Server::escape(const char *in, int len, QByteArray *out)
+{
+    const char *p = in;
+    const char *end = in + len;
+    while (p < end) {
+        const char *iac = static_cast<const char *>(memchr(p, IAC, end - p));
+        if (!iac) {
+            out->append(p, end - p);
+            return;
+        }
+        out->append(p, iac + 1 - p);
+        out->append(char(IAC));
+        p = iac + 1;
+    }
+}
+
+QByteArray Rfc2217Server::escape(const QByteArray &data)
+{
+    if (!memchr(data.constData(), IAC, data.size()))
+        return data;
+    QByteArray out;
+    out.reserve(data.size() + 16);
+    escape(data.constData(), data.size(), &out);
+    return out;
+}
+
+quint8 Rfc2217Server::modemState(int lines)
+{
+    quint8 state = 0;
+    if (lines & PINOUT_CTS)
+        state |= MODEM_CTS;
+    if (lines & PINOUT_DSR)
+        state |= MODEM_DSR;
+    if (lines & PINOUT_RI)
+        state |= MODEM_RI;
+    if (lines & PINOUT_DCD)
+        state |= MODEM_CD;
+    return state;
+}
+
+QByteArray Rfc2217Server::notifyModemState(int lines)
+{
+    const int state = modemState(lines);
+    if (state == m_modemState)
+        return QByteArray();
+
+    quint8 deltas = 0;
+    if (m_modemState >= 0) {
+        const int changed = state ^ m_modemState;
+        if (changed & MODEM_CTS)
+            deltas |= MODEM_DELTA_CTS;
+        if (changed & MODEM_DSR)
+            deltas |= MODEM_DELTA_DSR;
+        if (changed & MODEM_CD)
+            deltas |= MODEM_DELTA_CD;
+        if ((m_modemState & MODEM_RI) && !(state & MODEM_RI))
+            deltas |= MODEM_TRAILING_RI;
+    }
+    const int changed = (m_modemState >= 0) ? (state ^ m_modemState) | deltas : 0xff;
+    m_modemState = state;
+    if (!m_comPort || !(changed & m_modemStateMask))
+        return QByteArray();
+    return frame(NOTIFY_MODEMSTATE + SERVER_OFFSET, QByteArray(1, char((state | deltas) & m_modemStateMask)));
+}
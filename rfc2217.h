@@ -0,0 +1,203 @@
+/*
+ * Copyright (c) 2026 CuteCom contributors
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 675 Mass Ave, Cambridge, MA 02139, USA.
+ *
+ * For more information on the GPL, please go to:
+ * http://www.gnu.org/copyleft/gpl.html
+ */
+
+/**
+ * Server side of RFC 2217, the Telnet Com Port Control Option.
+ *
+ * Rfc2217Server parses the Telnet stream of one client: the payload goes to
+ * the serial port, option negotiation is answered right away and the
+ * COM-PORT-OPTION subnegotiations become requests. The caller applies a
+ * request to the port and answers it with response(). Data for the client
+ * have to be passed through escape().
+ *
+ * PortState keeps the settings of the port in RFC 2217 terms, apply()
+ * answers queries from it and records the changes.
+ *
+ * Usage:
+ *   Rfc2217Server telnet;
+ *   socket->write(Rfc2217Server::greeting());
+ *   telnet.feed(in, len, &data, &reply, &requests);
+ *   foreach (request, requests)
+ *       reply += Rfc2217Server::response(request.command, Rfc2217Server::apply(request, &port));
+ */
+
+#ifndef RFC2217_H
+#define RFC2217_H
+
+#include <QByteArray>
+#include <QVector>
+
+class Rfc2217Server
+{
+public:
+    enum Telnet { SE = 240, NOP = 241, SB = 250, WILL = 251, WONT = 252, DO = 253, DONT = 254, IAC = 255 };
+    enum Option { OPTION_BINARY = 0, OPTION_SGA = 3, OPTION_COM_PORT = 44 };
+    /* COM-PORT-OPTION commands of the client, the server answers with
+     * command + SERVER_OFFSET */
+    enum Command {
+        SIGNATURE = 0,
+        SET_BAUDRATE,
+        SET_DATASIZE,
+        SET_PARITY,
+        SET_STOPSIZE,
+        SET_CONTROL,
+        NOTIFY_LINESTATE,
+        NOTIFY_MODEMSTATE,
+        FLOWCONTROL_SUSPEND,
+        FLOWCONTROL_RESUME,
+        SET_LINESTATE_MASK,
+        SET_MODEMSTATE_MASK,
+        PURGE_DATA,
+        SERVER_OFFSET = 100
+    };
+    enum Parity { PARITY_QUERY = 0, PARITY_NONE, PARITY_ODD, PARITY_EVEN, PARITY_MARK, PARITY_SPACE };
+    enum StopSize { STOPSIZE_QUERY = 0, STOPSIZE_1, STOPSIZE_2, STOPSIZE_1_5 };
+    /* values of SET-CONTROL */
+    enum Control {
+        CONTROL_FLOW_QUERY = 0,
+        CONTROL_FLOW_NONE,
+        CONTROL_FLOW_XONXOFF,
+        CONTROL_FLOW_HARDWARE,
+        CONTROL_BREAK_QUERY,
+        CONTROL_BREAK_ON,
+        CONTROL_BREAK_OFF,
+        CONTROL_DTR_QUERY,
+        CONTROL_DTR_ON,
+        CONTROL_DTR_OFF,
+        CONTROL_RTS_QUERY,
+        CONTROL_RTS_ON,
+        CONTROL_RTS_OFF
+    };
+    /* bits of NOTIFY-MODEMSTATE */
+    enum ModemState {
+        MODEM_DELTA_CTS = 0x01,
+        MODEM_DELTA_DSR = 0x02,
+        MODEM_TRAILING_RI = 0x04,
+        MODEM_DELTA_CD = 0x08,
+        MODEM_CTS = 0x10,
+        MODEM_DSR = 0x20,
+        MODEM_RI = 0x40,
+        MODEM_CD = 0x80
+    };
+    /* values of PURGE-DATA */
+    enum Purge { PURGE_RX = 1, PURGE_TX, PURGE_BOTH };
+
+    struct Request {
+        Command command;
+        quint32 value;
+    };
+
+    struct PortState {
+        PortState()
+            : baudRate(9600)
+            , dataSize(8)
+            , parity(PARITY_NONE)
+            , stopSize(STOPSIZE_1)
+            , flowControl(CONTROL_FLOW_NONE)
+            , breakOn(false)
+            , dtr(true)
+            , rts(true)
+        {
+        }
+        quint32 baudRate;
+        quint8 dataSize;
+        quint8 parity;
+        quint8 stopSize;
+        quint8 flowControl;
+        bool breakOn;
+        bool dtr;
+        bool rts;
+    };
+
+    Rfc2217Server();
+
+    /**
+     * @brief The negotiation the server starts a connection with:
+     *  binary transmission in both directions, no go-aheads and the
+     *  request for the com port option.
+     */
+    static QByteArray greeting();
+
+    /**
+     * @brief Parse data of the client, the state is carried over between calls
+     * @param data The payload for the serial port is appended
+     * @param reply Answers to the negotiation are appended
+     * @param requests Requests to apply to the port are appended,
+     *  SET-BAUDRATE, SET-DATASIZE, SET-PARITY, SET-STOPSIZE, SET-CONTROL
+     *  and PURGE-DATA. Everything else is answered in reply.
+     */
+    void feed(const char *in, int len, QByteArray *data, QByteArray *reply, QVector<Request> *requests);
+
+    /**
+     * @brief Apply a request to the port state
+     * @return The value in effect to answer the request with
+     */
+    static quint32 apply(const Request &request, PortState *port);
+    /* the request only asks for the current value */
+    static bool isQuery(const Request &request);
+
+    /**
+     * @brief The answer of the server to a request
+     */
+    static QByteArray response(Command command, quint32 value);
+
+    /**
+     * @brief Append data for the client, IAC is doubled
+     */
+    static void escape(const char *in, int len, QByteArray *out);
+    /* the data themselves as long as there is nothing to escape */
+    static QByteArray escape(const QByteArray &data);
+
+    /**
+     * @brief Notification about changed modem lines
+     * @param lines QSerialPort::PinoutSignals
+     * @return NOTIFY-MODEMSTATE or nothing if the client isn't interested
+     */
+    QByteArray notifyModemState(int lines);
+
+    /* the client accepted the com port option */
+    bool comPortEnabled() const { return m_comPort; }
+    /* the client asked to stop sending data to it */
+    bool suspended() const { return m_suspended; }
+
+private:
+    enum State { STATE_DATA, STATE_IAC, STATE_OPTION, STATE_SB, STATE_SB_IAC };
+    enum { MAX_SUBNEGOTIATION = 256 };
+
+    void negotiate(uchar command, uchar option, QByteArray *reply);
+    void subnegotiation(QByteArray *reply, QVector<Request> *requests);
+    static QByteArray frame(uchar command, const QByteArray &value);
+    static quint8 modemState(int lines);
+
+    State m_state;
+    uchar m_command;
+    QByteArray m_sb;
+    /* options enabled on our side and on the side of the client */
+    quint64 m_ours;
+    quint64 m_theirs;
+    bool m_comPort;
+    bool m_suspended;
+    quint8 m_modemStateMask;
+    /* last modem state reported, -1 before the first one */
+    int m_modemState;
+};
+
+#endif // RFC2217_H
@@ -0,0 +1,284 @@
+/*
+ * Copyright (c) 2026 CuteCom contributors
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 675 Mass Ave, Cambridge, MA 02139, USA.
+ *
+ * For more information on the GPL, please go to:
+ * http://www.gnu.org/copyleft/gpl.html
+ */
+
+#include "sendexpect.h"
+#include "captureclock.h"
+
+#include <QDebug>
+#include <QStringList>
+
+#include <algorithm>
+
+#define TRACE                                                                                                          \
+    if (!debug) {                                                                                                      \
+    } else                                                                                                             \
+        qDebug()
+
+static bool debug = false;
+
+static const int DEFAULT_TIMEOUT_MS = 1000;
+
+SendExpectEngine::SendExpectEngine(QObject *parent)
+    : QObject(parent)
+    , m_running(false)
+    , m_waiting(false)
+    , m_step(0)
+    , m_iteration(0)
+    , m_iterations(0)
+    , m_sentAt(0)
+{
+    m_timeout.setSingleShot(true);
+    m_timeout.setTimerType(Qt::PreciseTimer);
+    connect(&m_timeout, &QTimer::timeout, this, &SendExpectEngine::stepTimeout);
+}
+
+QList<SendExpectEngine::Step> SendExpectEngine::parseScript(QTextStream &in, QString *error)
+{
+    QList<Step> steps;
+    int lineNumber = 0;
+    while (!in.atEnd()) {
+        QString line = in.readLine();
+        lineNumber++;
+        int comment = line.indexOf('#');
+        if (comment >= 0)
+            line = line.left(comment);
+        if (line.trimmed().isEmpty())
+            continue;
+
+        QStringList fields = line.split('|');
+        if (fields.size() > 3) {
+            if (error)
+                *error = QObject::tr("Line %1: too many fields").arg(lineNumber);
+            return QList<Step>();
+        }
+        Step step;
+        step.send = PatternMatcher::fromEscaped(fields.at(0).trimmed());
+        step.expect = (fields.size() > 1) ? PatternMatcher::fromEscaped(fields.at(1).trimmed()) : QByteArray();
+        step.timeoutMs = DEFAULT_TIMEOUT_MS;
+        if (fields.size() > 2) {
+            bool ok = false;
+            step.timeoutMs = fields.at(2).trimmed().toInt(&ok);
+            if (!ok || step.timeoutMs <= 0) {
+                if (error)
+                    *error = QObject::tr("Line %1: invalid timeout").arg(lineNumber);
+                return QList<Step>();
+            }
+        }
+        if (step.send.isEmpty() && step.expect.isEmpty())
+            continue;
+        steps.append(step);
+    }
+    if (steps.isEmpty() && error)
+        *error = QObject::tr("The script does not contain any steps");
+    return steps;
+}
+
+void SendExpectEngine::setSteps(const QList<Step> &steps)
+{
+    stop();
+    m_steps = steps;
+    m_matchers.clear();
+    m_latencies.clear();
+    m_timeouts.clear();
+    foreach (const Step &step, m_steps) {
+        PatternMatcher matcher;
+        matcher.addPattern(step.expect);
+        matcher.build();
+        m_matchers.append(matcher);
+    }
+    m_latencies.resize(m_steps.size());
+    m_timeouts.fill(0, m_steps.size());
+}
+
+/**
+ * @brief Run all steps the given number of times
+ * @param iterations
+ */
+void SendExpectEngine::start(int iterations)
+{
+    if (m_steps.isEmpty() || iterations < 1)
+        return;
+
+    for (int i = 0; i < m_steps.size(); i++) {
+        m_latencies[i].clear();
+        m_latencies[i].reserve(iterations);
+        m_timeouts[i] = 0;
+    }
+    m_iterations = iterations;
+    m_iteration = 0;
+    m_step = 0;
+    m_running = true;
+    sendStep();
+}
+
+void SendExpectEngine::stop()
+{
+    m_timeout.stop();
+    m_waiting = false;
+    m_running = false;
+}
+
+void SendExpectEngine::sendStep()
+{
+    const Step &step = m_steps.at(m_step);
+    m_waiting = !step.expect.isEmpty();
+    m_matchers[m_step].reset();
+
+    m_sentAt = CaptureClock::nsecsElapsed();
+    if (!step.send.isEmpty())
+        emit sendData(step.send);
+
+    if (m_waiting) {
+        m_timeout.start(step.timeoutMs);
+    } else {
+        // do not recurse, steps without expectation could be chained
+        // thousands of times
+        QMetaObject::invokeMethod(this, "advance", Qt::QueuedConnection);
+    }
+}
+
+void SendExpectEngine::processRx(const char *data, int len, qint64 timestamp)
+{
+    // data read before the step has been sent can not be its answer. The
+    // bytes after a match were read before the next step is sent, so they
+    // are dropped as well.
+    if (!m_waiting || timestamp < m_sentAt)
+        return;
+
+    bool matched = false;
+    m_matchers[m_step].feed(data, len, [&matched](int, int) {
+        matched = true;
+        return false;
+    });
+    if (!matched)
+        return;
+
+    m_timeout.stop();
+    m_waiting = false;
+    m_latencies[m_step].append(timestamp - m_sentAt);
+    advance();
+}
+
+void SendExpectEngine::advance()
+{
+    if (!m_running)
+        return;
+
+    if (++m_step >= m_steps.size()) {
+        m_step = 0;
+        emit progress(++m_iteration);
+        if (m_iteration >= m_iterations) {
+            stop();
+            emit finished();
+            return;
+        }
+    }
+    sendStep();
+}
+
+/**
+ * A step did not receive its expected answer in time. The remaining
+ * steps of this iteration probably depend on it so the next iteration
+ * is started.
+ */
+void SendExpectEngine::stepTimeout()
+{
+    if (!m_waiting)
+        return;
+    TRACE << "[SendExpectEngine] timeout in step" << m_step << "iteration" << m_iteration;
+    m_waiting = false;
+    m_timeouts[m_step]++;
+    m_step = m_steps.size() - 1;
+    advance();
+}
+
+SendExpectEngine::StepStatistics SendExpectEngine::statistics(int step) const
+{
+    StepStatistics stats = {0, 0, 0, 0, 0, 0};
+    if (step < 0 || step >= m_steps.size())
+        return stats;
+
+    stats.timeouts = m_timeouts.at(step);
+    QVector<qint64> sorted = m_latencies.at(step);
+    stats.samples = sorted.size();
+    if (sorted.isEmpty())
+        return stats;
+
+    std::sort(sorted.begin(), sorted.end());
+    auto percentile = [&sorted](int p) {
+        int index = (sorted.size() * p + 99) / 100 - 1;
+        return sorted.at(qBound(0, index, sorted.size() - 1));
+    };
+    stats.min = sorted.first();
+    stats.p50 = percentile(50);
+    stats.p99 = percentile(99);
+    stats.max = sorted.last();
+    return stats;
+}
+
+QString SendExpectEngine::report() const
+{
+    auto ms = [](qint64 ns) { return QString::number(ns / 1000000.0, 'f', 3); };
+
+    QString text;
+    QTextStream out(&text);
+    out << tr("%1 of %2 iterations").arg(m_iteration).arg(m_iterations) << "\n";
+    for (int i = 0; i < m_steps.size(); i++) {
+        const Step &step = m_steps.at(i);
+        out << "\n"
+            << tr("Step %1: '%2' -> '%3'")
+                   .arg(i + 1)
+                   .arg(PatternMatcher::toEscaped(step.send))
+                   .arg(PatternMatcher::toEscaped(step.expect))
+            << "\n";
+        if (step.expect.isEmpty())
+            continue;
+
+        const StepStatistics stats = statistics(i);
+        out << tr("  samples: %1  timeouts: %2").arg(stats.samples).arg(stats.timeouts) << "\n";
+        if (stats.samples == 0)
+            continue;
+        out << tr("  min: %1 ms  p50: %2 ms  p99: %3 ms  max: %4 ms")
+                   .arg(ms(stats.min))
+                   .arg(ms(stats.p50))
+                   .arg(ms(stats.p99))
+                   .arg(ms(stats.max))
+            << "\n";
+
+        // power of two buckets in microseconds
+        QVector<int> buckets;
+        foreach (qint64 ns, m_latencies.at(i)) {
+            int bucket = 0;
+            for (qint64 us = ns / 1000; us > 1; us >>= 1)
+                bucket++;
+            if (buckets.size() <= bucket)
+                buckets.resize(bucket + 1);
+            buckets[bucket]++;
+        }
+        for (int b = 0; b < buckets.size(); b++) {
+            if (buckets.at(b) == 0)
+                continue;
+            out << QString("  <= %1 us: %2").arg(Q_INT64_C(2) << b, 8).arg(buckets.at(b), 7) << "\n";
+        }
+    }
+    out.flush();
+    return text;
+}
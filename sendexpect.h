@@ -0,0 +1,134 @@
+/*
+ * Copyright (c) 2026 CuteCom contributors
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 675 Mass Ave, Cambridge, MA 02139, USA.
+ *
+ * For more information on the GPL, please go to:
+ * http://www.gnu.org/copyleft/gpl.html
+ */
+
+/**
+ * The send/expect engine runs a sequence of steps against the device.
+ * Every step sends some bytes and waits (with a timeout) until the
+ * expected pattern has been received. The time between sending and the
+ * arrival of the read containing the end of the pattern is recorded per
+ * step, so the whole sequence can be repeated many times to get a
+ * latency distribution.
+ *
+ * processRx() is meant to be called right after the data has been read
+ * from the device and before it is handed over to the display, so the
+ * measured latency does not depend on rendering. Only data read after
+ * a step has been sent is matched against its expectation.
+ */
+
+#ifndef SENDEXPECT_H
+#define SENDEXPECT_H
+
+#include "patternmatcher.h"
+
+#include <QObject>
+#include <QTextStream>
+#include <QTimer>
+
+class SendExpectEngine : public QObject
+{
+    Q_OBJECT
+
+public:
+    struct Step {
+        QByteArray send;
+        QByteArray expect;
+        int timeoutMs;
+    };
+
+    struct StepStatistics {
+        int samples;
+        int timeouts;
+        qint64 min;
+        qint64 p50;
+        qint64 p99;
+        qint64 max;
+    };
+
+    explicit SendExpectEngine(QObject *parent = 0);
+
+    /**
+     * @brief Parse a script. Each line holds one step:
+     *  send | expect | timeout in ms
+     *  The expect and timeout fields are optional, '#' starts a comment.
+     * @param in The script
+     * @param error Description of the first error found
+     * @return The steps, an empty list on error
+     */
+    static QList<Step> parseScript(QTextStream &in, QString *error);
+
+    void setSteps(const QList<Step> &steps);
+    const QList<Step> &steps() const { return m_steps; }
+
+    bool isRunning() const { return m_running; }
+    int iteration() const { return m_iteration; }
+    int iterations() const { return m_iterations; }
+
+    void start(int iterations);
+    void stop();
+
+    /**
+     * @brief Feed received data into the engine
+     * @param data The data as read from the device
+     * @param len Number of bytes
+     * @param timestamp CaptureClock time the data has been read
+     */
+    void processRx(const char *data, int len, qint64 timestamp);
+
+    StepStatistics statistics(int step) const;
+
+    /**
+     * @brief Human readable report of all steps including a
+     *  histogram of the latencies
+     */
+    QString report() const;
+
+signals:
+    void sendData(const QByteArray &data);
+    void progress(int iteration);
+    void finished();
+
+private slots:
+    void advance();
+    void stepTimeout();
+
+private:
+    void sendStep();
+
+    QList<Step> m_steps;
+    QVector<PatternMatcher> m_matchers;
+
+    /**
+     * Latencies in ns of every step
+     * @brief m_latencies
+     */
+    QVector<QVector<qint64>> m_latencies;
+    QVector<int> m_timeouts;
+
+    QTimer m_timeout;
+    bool m_running;
+    bool m_waiting;
+    int m_step;
+    int m_iteration;
+    int m_iterations;
+    qint64 m_sentAt;
+};
+
+#endif // SENDEXPECT_H
@@ -0,0 +1,168 @@
+/*
+ * Copyright (c) 2026 CuteCom contributors
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 675 Mass Ave, Cambridge, MA 02139, USA.
+ *
+ * For more information on the GPL, please go to:
+ * http://www.gnu.org/copyleft/gpl.html
+ */
+
+#include "sendexpectplugin.h"
+#include "ui_sendexpectplugin.h"
+#include <QFile>
+#include <QFileDialog>
+#include <QFileInfo>
+#include <QMessageBox>
+
+#define TRACE                                                                                                          \
+    if (!debug) {                                                                                                      \
+    } else                                                                                                             \
+        qDebug()
+
+static bool debug = false;
+
+SendExpectPlugin::SendExpectPlugin(QFrame *parent, Settings *settings)
+    : QFrame(parent)
+    , ui(new Ui::SendExpectPlugin)
+    , m_settings(settings)
+    , m_engine(new SendExpectEngine(this))
+{
+    ui->setupUi(this);
+    /* Has QFrame, no injection process cmd, but needs the received data as early as possible */
+    m_plugin = new Plugin(this, "Send/Expect", this);
+    m_plugin->processRx = &SendExpectPlugin::processRx;
+
+    connect(ui->m_bt_unload, &QPushButton::clicked, this, &SendExpectPlugin::removePlugin);
+    connect(ui->m_bt_help, &QPushButton::clicked, this, &SendExpectPlugin::helpMsg);
+    connect(ui->m_bt_load, &QPushButton::clicked, this, &SendExpectPlugin::loadScript);
+    connect(ui->m_bt_run, &QPushButton::toggled, this, &SendExpectPlugin::toggleRun);
+    connect(ui->m_bt_report, &QPushButton::clicked, this, &SendExpectPlugin::showReport);
+
+    connect(m_engine, &SendExpectEngine::sendData, this, &SendExpectPlugin::sendData);
+    connect(m_engine, &SendExpectEngine::finished, this, [=]() {
+        ui->m_bt_run->setChecked(false);
+        showReport();
+    });
+    connect(&m_progressTimer, &QTimer::timeout, this, &SendExpectPlugin::updateProgress);
+
+    TRACE << "[SendExpectPlugin::SendExpectPlugin]";
+}
+
+SendExpectPlugin::~SendExpectPlugin()
+{
+    m_engine->stop();
+    delete ui;
+}
+
+/**
+ * @brief Called by the plugin manager with the data read from the device
+ *  before it is being displayed.
+ */
+void SendExpectPlugin::processRx(QObject *owner, const QByteArray &data, qint64 timestamp)
+{
+    SendExpectPlugin *self = static_cast<SendExpectPlugin *>(owner);
+    self->m_engine->processRx(data.constData(), data.size(), timestamp);
+}
+
+/**
+ * @brief Let the user choose a script and hand the steps over to the engine
+ */
+void SendExpectPlugin::loadScript()
+{
+    QString filename = QFileDialog::getOpenFileName(this, tr("Open send/expect script"), m_settings->getSendStartDir());
+    if (filename.isEmpty())
+        return;
+
+    QFile file(filename);
+    if (!file.open(QIODevice::ReadOnly | QIODevice::Text)) {
+        QMessageBox::warning(this, tr("Opening file failed"), tr("Could not open file %1").arg(filename));
+        return;
+    }
+    QTextStream in(&file);
+    QString error;
+    QList<SendExpectEngine::Step> steps = SendExpectEngine::parseScript(in, &error);
+    if (steps.isEmpty()) {
+        QMessageBox::warning(this, tr("Invalid script"), error);
+        return;
+    }
+    ui->m_bt_run->setChecked(false);
+    m_engine->setSteps(steps);
+    ui->m_lbl_script->setText(QFileInfo(filename).fileName());
+    ui->m_lbl_script->setToolTip(tr("%1 steps").arg(steps.size()));
+    ui->m_bt_run->setEnabled(true);
+    ui->m_bt_report->setEnabled(false);
+}
+
+void SendExpectPlugin::toggleRun(bool run)
+{
+    if (run && !m_engine->isRunning()) {
+        ui->m_bt_run->setText(tr("Stop"));
+        ui->m_bt_load->setEnabled(false);
+        m_progressTimer.start(250);
+        m_engine->start(ui->m_sb_iterations->value());
+        ui->m_bt_report->setEnabled(true);
+    } else if (!run) {
+        m_engine->stop();
+        m_progressTimer.stop();
+        ui->m_bt_run->setText(tr("Run"));
+        ui->m_bt_load->setEnabled(true);
+    }
+    updateProgress();
+}
+
+void SendExpectPlugin::updateProgress()
+{
+    ui->m_lbl_progress->setText(QString("%1/%2").arg(m_engine->iteration()).arg(m_engine->iterations()));
+}
+
+void SendExpectPlugin::showReport()
+{
+    QMessageBox box(QMessageBox::Information, tr("Send/Expect latency"), m_engine->report(), QMessageBox::Ok, this);
+    box.setStyleSheet(QStringLiteral("QLabel{font-family: monospace;}"));
+    box.exec();
+}
+
+/**
+ * @brief Return a pointer to the plugin data
+ * @return
+ */
+const Plugin *SendExpectPlugin::plugin() { return m_plugin; }
+
+/**
+ * @brief [SLOT] Send unload command to the plugin manager
+ */
+void SendExpectPlugin::removePlugin(bool) { emit unload(m_plugin); }
+
+/**
+ * @brief Help message for the send/expect plugin
+ */
+void SendExpectPlugin::helpMsg(void)
+{
+    QString help_str = tr("This plugin runs a send/expect script against the device\n"
+                          "and measures the round trip time of every step.\n\n"
+                          "Each line of the script holds one step:\n"
+                          "    send | expect | timeout in ms\n"
+                          "e.g.\n"
+                          "    AT\\r | OK\\r\\n | 500\n\n"
+                          "Supported escapes are \\r \\n \\t \\0 \\\\ and \\xNN.\n"
+                          "Expect and timeout may be omitted, '#' starts a comment.\n"
+                          "If a step times out, the next iteration is started.\n\n"
+                          "The time is measured from writing the data until the\n"
+                          "expected pattern has been read from the device. After\n"
+                          "all iterations have run, min/p50/p99/max and a histogram\n"
+                          "of the latency are reported for each step.\n");
+
+    QMessageBox::information(this, tr("How to use Send/Expect"), help_str);
+}
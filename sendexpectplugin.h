@@ -0,0 +1,75 @@
+/*
+ * Copyright (c) 2026 CuteCom contributors
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 675 Mass Ave, Cambridge, MA 02139, USA.
+ *
+ * For more information on the GPL, please go to:
+ * http://www.gnu.org/copyleft/gpl.html
+ */
+
+#ifndef SENDEXPECTPLUGIN_H
+#define SENDEXPECTPLUGIN_H
+
+#include "plugin.h"
+#include "sendexpect.h"
+#include "settings.h"
+#include <QDebug>
+#include <QFrame>
+#include <QTimer>
+
+namespace Ui
+{
+class SendExpectPlugin;
+}
+
+class SendExpectPlugin : public QFrame
+{
+    Q_OBJECT
+
+public:
+    explicit SendExpectPlugin(QFrame *parent, Settings *settings);
+    ~SendExpectPlugin();
+    const Plugin *plugin();
+
+signals:
+    void sendData(QByteArray);
+    void unload(Plugin *);
+
+public slots:
+    void removePlugin(bool);
+    void helpMsg(void);
+
+private slots:
+    void loadScript();
+    void toggleRun(bool run);
+    void updateProgress();
+    void showReport();
+
+private:
+    static void processRx(QObject *owner, const QByteArray &data, qint64 timestamp);
+
+    Ui::SendExpectPlugin *ui;
+    Plugin *m_plugin;
+    Settings *m_settings;
+    SendExpectEngine *m_engine;
+    /**
+     * The progress label is updated by this timer instead of
+     * on every iteration
+     * @brief m_progressTimer
+     */
+    QTimer m_progressTimer;
+};
+
+#endif // SENDEXPECTPLUGIN_H
@@ -28,6 +28,7 @@
 #include <qdebug.h>
 
 const QString Settings::DEFAULT_SESSION_NAME = QStringLiteral("Default");
+QHash<QString, Settings::Session> Settings::m_sessions;
 
 Settings::Settings(QObject *parent)
     : QObject(parent)
@@ -92,6 +93,26 @@ void Settings::settingChanged(Settings::Options option, QVariant setting)
         m_character_delay = setting.toUInt();
         sessionSettings = false;
         break;
+    case Linebreak:
+        m_linebreak = setting.toString();
+        sessionSettings = false;
+        break;
+    case Encoding:
+        m_encoding = setting.value<Settings::TextEncoding>();
+        sessionSettings = false;
+        break;
+    case FoldLines:
+        m_fold_lines = setting.toBool();
+        sessionSettings = false;
+        break;
+    case IdleGap:
+        m_idle_gap = setting.toUInt();
+        sessionSettings = false;
+        break;
+    case IdleGapUnit:
+        m_idle_gap_unit = setting.value<Settings::IdleGapUnit>();
+        sessionSettings = false;
+        break;
     case ProtocolOption:
         m_protocol = setting.value<Protocol>();
         sessionSettings = false;
@@ -112,9 +133,27 @@ void Settings::settingChanged(Settings::Options option, QVariant setting)
     case UdpRemotePort:
         session.udpRemotePort = setting.toUInt();
         break;
+    case UdpMaxDatagram:
+        session.udpMaxDatagram = setting.toUInt();
+        break;
+    case UdpMaxLatency:
+        session.udpMaxLatency = setting.toUInt();
+        break;
+    case UdpHeader:
+        session.udpHeader = setting.toBool();
+        break;
     case TcpLocalPort:
         session.tcpLocalPort = setting.toUInt();
         break;
+    case TcpQueuePolicy:
+        session.tcpQueuePolicy = setting.toInt();
+        break;
+    case TcpQueueLimit:
+        session.tcpQueueLimit = setting.toUInt();
+        break;
+    case TcpRfc2217:
+        session.tcpRfc2217 = setting.toBool();
+        break;
     case CurrentSession:
         m_current_session = setting.toString();
         emit sessionChanged(getCurrentSession());
@@ -196,7 +235,13 @@ void Settings::readSessionSettings(QSettings &settings)
         session.udpLocalPort = settings.value("UdpLocalPort", 7755).toUInt();
         session.udpRemoteHost = settings.value("UdpRemoteHost", "").toString();
         session.udpRemotePort = settings.value("UdpRemotePort", 7756).toUInt();
+        session.udpMaxDatagram = settings.value("UdpMaxDatagram", 1472).toUInt();
+        session.udpMaxLatency = settings.value("UdpMaxLatency", 0).toUInt();
+        session.udpHeader = settings.value("UdpHeader", false).toBool();
         session.tcpLocalPort = settings.value("TcpLocalPort", 7755).toUInt();
+        session.tcpQueuePolicy = settings.value("TcpQueuePolicy", 0).toInt();
+        session.tcpQueueLimit = settings.value("TcpQueueLimit", 256).toUInt();
+        session.tcpRfc2217 = settings.value("TcpRfc2217", false).toBool();
 
         m_sessions.insert(name, session);
     }
@@ -251,6 +296,17 @@ void Settings::readSettings(const QString &session)
 
     m_character_delay = settings.value("CharacterDelay", 0).toUInt();
 
+    m_linebreak = settings.value("Linebreak", QString()).toString();
+
+    m_encoding = static_cast<Settings::TextEncoding>(
+        settings.value("Encoding", QVariant::fromValue(Settings::LATIN1)).toUInt());
+
+    m_fold_lines = settings.value("FoldLines", false).toBool();
+
+    m_idle_gap = settings.value("IdleGap", 0).toUInt();
+    m_idle_gap_unit = static_cast<Settings::IdleGapUnit>(
+        settings.value("IdleGapUnit", QVariant::fromValue(Settings::MICROSECONDS)).toUInt());
+
     settings.endGroup();
     readSessionSettings(settings);
 }
@@ -275,6 +331,27 @@ const Settings::Session Settings::getCurrentSession()
     return m_sessions.value(m_current_session);
 }
 
+double Settings::Session::bitsPerCharacter() const
+{
+    double bits = 1 + dataBits;
+    if (parity != QSerialPort::NoParity)
+        bits += 1;
+    if (stopBits == QSerialPort::OneAndHalfStop)
+        bits += 1.5;
+    else if (stopBits == QSerialPort::TwoStop)
+        bits += 2;
+    else
+        bits += 1;
+    return bits;
+}
+
+qint64 Settings::Session::characterTime() const
+{
+    if (!baudRate)
+        return 0;
+    return static_cast<qint64>(bitsPerCharacter() * 1e9 / baudRate);
+}
+
 void Settings::saveGenericSettings()
 {
     QSettings settings(this->parent());
@@ -294,6 +371,15 @@ void Settings::saveGenericSettings()
 
     settings.setValue("CharacterDelay", m_character_delay);
 
+    settings.setValue("Linebreak", m_linebreak);
+
+    settings.setValue("Encoding", m_encoding);
+
+    settings.setValue("FoldLines", m_fold_lines);
+
+    settings.setValue("IdleGap", m_idle_gap);
+    settings.setValue("IdleGapUnit", m_idle_gap_unit);
+
     settings.setValue("Protocol", m_protocol);
 
     settings.setValue("SendingStartDir", m_sendingStartDir);
@@ -328,7 +414,13 @@ void Settings::saveSessionSettings()
             settings.setValue("UdpLocalPort", session.udpLocalPort);
             settings.setValue("UdpRemoteHost", session.udpRemoteHost);
             settings.setValue("UdpRemotePort", session.udpRemotePort);
+            settings.setValue("UdpMaxDatagram", session.udpMaxDatagram);
+            settings.setValue("UdpMaxLatency", session.udpMaxLatency);
+            settings.setValue("UdpHeader", session.udpHeader);
             settings.setValue("TcpLocalPort", session.tcpLocalPort);
+            settings.setValue("TcpQueuePolicy", session.tcpQueuePolicy);
+            settings.setValue("TcpQueueLimit", session.tcpQueueLimit);
+            settings.setValue("TcpRfc2217", session.tcpRfc2217);
         }
         settings.endArray();
     }
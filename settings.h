@@ -46,13 +46,24 @@ public:
         LogFileLocation,
         LineTermination,
         CharacterDelay,
+        Linebreak,
+        Encoding,
+        FoldLines,
+        IdleGap,
+        IdleGapUnit,
         SendStartDir,
         ProtocolOption,
         MacroFile,
         UdpLocalPort,
         UdpRemoteHost,
         UdpRemotePort,
+        UdpMaxDatagram,
+        UdpMaxLatency,
+        UdpHeader,
         TcpLocalPort,
+        TcpQueuePolicy,
+        TcpQueueLimit,
+        TcpRfc2217,
         CurrentSession
     };
 
@@ -71,12 +82,35 @@ public:
         quint16 udpLocalPort;
         QString udpRemoteHost;
         quint16 udpRemotePort;
+        /* coalescing of the datagrams: max. bytes and max. ms the data are
+         * held back, 0 ms sends right away; header with sequence and time */
+        quint16 udpMaxDatagram;
+        quint16 udpMaxLatency;
+        bool udpHeader;
         quint16 tcpLocalPort;
+        /* NetProxyBridge::QueuePolicy and max. KB queued per TCP client */
+        int tcpQueuePolicy;
+        quint32 tcpQueueLimit;
+        /* the TCP server talks RFC 2217 */
+        bool tcpRfc2217;
+
+        /* bits on the line per character, including start, parity and stop bits */
+        double bitsPerCharacter() const;
+        /* time to transmit one character in ns */
+        qint64 characterTime() const;
     };
 
     enum LineTerminator { LF = 0, CR, CRLF, NONE, HEX };
     Q_ENUMS(LineTerminator)
 
+    /* encoding of the text received */
+    enum TextEncoding { LATIN1 = 0, UTF8 };
+    Q_ENUMS(TextEncoding)
+
+    /* unit of the idle gap that splits the output into rows */
+    enum IdleGapUnit { MICROSECONDS = 0, CHARACTERS };
+    Q_ENUMS(IdleGapUnit)
+
     enum Protocol { PLAIN, SCRIPT, XMODEM, YMODEM, ZMODEM, ONEKXMODEM, PROTOCOL_MAX };
     Q_ENUMS(Protocol)
 
@@ -97,6 +131,16 @@ public:
 
     quint8 getCharacterDelay() const { return m_character_delay; }
 
+    QString getLinebreak() const { return m_linebreak; }
+
+    Settings::TextEncoding getEncoding() const { return m_encoding; }
+
+    bool getFoldLines() const { return m_fold_lines; }
+
+    quint32 getIdleGap() const { return m_idle_gap; }
+
+    Settings::IdleGapUnit getIdleGapUnit() const { return m_idle_gap_unit; }
+
     Settings::Protocol getProtocol() const { return m_protocol; }
 
     QString getSendStartDir() const { return m_sendingStartDir; }
@@ -142,7 +186,30 @@ private:
      */
     quint8 m_character_delay;
 
-    QHash<QString, Session> m_sessions;
+    /**
+     * Delimiters the output is split into lines at, as
+     * taken by DataDisplay::setLinebreak(). Empty to follow
+     * the line termination
+     * @brief m_linebreak
+     */
+    QString m_linebreak;
+    Settings::TextEncoding m_encoding;
+    bool m_fold_lines;
+
+    /**
+     * Idle time after which the output starts a new row,
+     * 0 if the output is split at line breaks
+     * @brief m_idle_gap
+     */
+    quint32 m_idle_gap;
+    Settings::IdleGapUnit m_idle_gap_unit;
+
+    /**
+     * The sessions are shared by all windows of the process,
+     * so no window writes back an outdated copy of the others
+     * @brief m_sessions
+     */
+    static QHash<QString, Session> m_sessions;
     QString m_current_session;
     static const QString DEFAULT_SESSION_NAME;
 };
@@ -150,5 +217,7 @@ private:
 Q_DECLARE_METATYPE(Settings::Session)
 Q_DECLARE_METATYPE(Settings::LineTerminator)
 Q_DECLARE_METATYPE(Settings::Protocol)
+Q_DECLARE_METATYPE(Settings::TextEncoding)
+Q_DECLARE_METATYPE(Settings::IdleGapUnit)
 
 #endif // SETTINGS_H
@@ -0,0 +1,658 @@
+/*
+ * Copyright (c) 2026 CuteCom contributors
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 675 Mass Ave, Cambridge, MA 02139, USA.
+ *
+ * For more information on the GPL, please go to:
+ * http://www.gnu.org/copyleft/gpl.html
+ */
+
+#include "terminalemulator.h"
+
+#include <algorithm>
+
+TerminalEmulator::TerminalEmulator(int columns, int rows)
+    : m_columns(0)
+    , m_rows(0)
+    , m_column(0)
+    , m_row(0)
+    , m_damaged(false)
+{
+    resize(columns, rows);
+    reset();
+}
+
+void TerminalEmulator::resize(int columns, int rows)
+{
+    columns = qMax(columns, 2);
+    rows = qMax(rows, 2);
+    QVector<Cell> cells(columns * rows);
+    for (int row = 0; row < qMin(rows, m_rows); row++) {
+        for (int column = 0; column < qMin(columns, m_columns); column++)
+            cells[row * columns + column] = cell(column, row);
+    }
+    m_cells = cells;
+    m_otherCells = QVector<Cell>(columns * rows);
+    m_columns = columns;
+    m_rows = rows;
+
+    m_tabStops = QVector<bool>(columns, false);
+    for (int column = 8; column < columns; column += 8)
+        m_tabStops[column] = true;
+
+    m_column = qMin(m_column, columns - 1);
+    m_row = qMin(m_row, rows - 1);
+    m_wrapPending = false;
+    m_scrollTop = 0;
+    m_scrollBottom = rows - 1;
+    m_damage = QVector<Damage>(rows);
+    markAllDamaged();
+}
+
+void TerminalEmulator::reset()
+{
+    m_style = Cell();
+    m_cells.fill(Cell());
+    m_otherCells.fill(Cell());
+    m_alternateScreen = false;
+    for (int column = 0; column < m_columns; column++)
+        m_tabStops[column] = column && column % 8 == 0;
+    m_column = 0;
+    m_row = 0;
+    m_wrapPending = false;
+    m_savedCursor = SavedCursor();
+    m_savedCursor.originMode = false;
+    m_scrollTop = 0;
+    m_scrollBottom = m_rows - 1;
+    m_autoWrap = true;
+    m_originMode = false;
+    m_insertMode = false;
+    m_cursorVisible = true;
+    m_state = GROUND;
+    m_parameterCount = 0;
+    m_private = 0;
+    m_intermediate = 0;
+    m_utf8.reset();
+    markAllDamaged();
+}
+
+QByteArray TerminalEmulator::takeResponse()
+{
+    QByteArray response = m_response;
+    m_response.clear();
+    return response;
+}
+
+void TerminalEmulator::clearDamage()
+{
+    for (int row = 0; row < m_rows; row++)
+        m_damage[row] = Damage();
+    m_damaged = false;
+}
+
+void TerminalEmulator::markDamaged(int row, int first, int last)
+{
+    Damage &damage = m_damage[row];
+    damage.first = qMin(damage.first, first);
+    damage.last = qMax(damage.last, last);
+    m_damaged = true;
+}
+
+void TerminalEmulator::markAllDamaged()
+{
+    for (int row = 0; row < m_rows; row++)
+        markDamaged(row, 0, m_columns - 1);
+}
+
+/**
+ * @brief An empty cell, erased areas take the current background color
+ */
+TerminalEmulator::Cell TerminalEmulator::blank() const
+{
+    Cell cell;
+    cell.background = m_style.background;
+    return cell;
+}
+
+void TerminalEmulator::feed(const char *data, int len)
+{
+    const uchar *p = reinterpret_cast<const uchar *>(data);
+    for (int i = 0; i < len; i++) {
+        const uchar b = p[i];
+
+        if (m_state == STRING) {
+            // OSC, DCS and friends are not interpreted, they end with BEL or ST (ESC \)
+            if (b == 0x07)
+                m_state = GROUND;
+            else if (b == 0x1b)
+                m_state = ESCAPE;
+            continue;
+        }
+
+        if (m_state == GROUND && (b >= 0x80 || m_utf8.isPending())) {
+            if (m_utf8.feed(b, [this](uint character) { print(character); }, [this](uchar) { print(0xfffd); }))
+                continue;
+        }
+
+        // control characters are executed in the middle of sequences as well
+        if (b < 0x20 || b == 0x7f) {
+            control(b);
+            continue;
+        }
+
+        switch (m_state) {
+        case GROUND:
+            print(b);
+            break;
+        case ESCAPE:
+            if (b >= 0x20 && b <= 0x2f) {
+                m_intermediate = b;
+                m_state = ESCAPE_INTERMEDIATE;
+            } else if (b == '[') {
+                m_parameterCount = 0;
+                m_parameters[0] = 0;
+                m_private = 0;
+                m_intermediate = 0;
+                m_state = CSI;
+            } else if (b == ']' || b == 'P' || b == 'X' || b == '^' || b == '_') {
+                m_state = STRING;
+            } else {
+                m_state = GROUND;
+                escapeDispatch(b);
+            }
+            break;
+        case ESCAPE_INTERMEDIATE:
+            // character set designations and the like, nothing to do
+            if (b >= 0x30)
+                m_state = GROUND;
+            break;
+        case CSI:
+            if (b >= '0' && b <= '9') {
+                if (!m_parameterCount)
+                    m_parameterCount = 1;
+                int &value = m_parameters[m_parameterCount - 1];
+                value = qMin(value * 10 + (b - '0'), 99999);
+            } else if (b == ';' || b == ':') {
+                if (!m_parameterCount)
+                    m_parameterCount = 1;
+                if (m_parameterCount < MAX_PARAMETERS)
+                    m_parameters[m_parameterCount++] = 0;
+            } else if (b >= '<' && b <= '?') {
+                m_private = b;
+            } else if (b >= 0x20 && b <= 0x2f) {
+                m_intermediate = b;
+            } else {
+                m_state = GROUND;
+                if (b >= 0x40 && b <= 0x7e)
+                    csiDispatch(b);
+            }
+            break;
+        case STRING:
+            break;
+        }
+    }
+}
+
+void TerminalEmulator::print(uint character)
+{
+    if (m_wrapPending) {
+        m_column = 0;
+        lineFeed();
+        m_wrapPending = false;
+    }
+    if (m_insertMode)
+        insertCells(1);
+
+    Cell &cell = cellAt(m_column, m_row);
+    cell = m_style;
+    cell.character = character;
+    markDamaged(m_row, m_column, m_column);
+
+    if (m_column < m_columns - 1)
+        m_column++;
+    else if (m_autoWrap)
+        m_wrapPending = true;
+}
+
+void TerminalEmulator::control(uchar byte)
+{
+    switch (byte) {
+    case 0x08: // BS
+        setCursor(m_column - 1, m_row);
+        break;
+    case 0x09: { // HT
+        int column = m_column + 1;
+        while (column < m_columns - 1 && !m_tabStops.at(column))
+            column++;
+        setCursor(column, m_row);
+        break;
+    }
+    case 0x0a: // LF
+    case 0x0b: // VT
+    case 0x0c: // FF
+        m_wrapPending = false;
+        lineFeed();
+        break;
+    case 0x0d: // CR
+        setCursor(0, m_row);
+        break;
+    case 0x18: // CAN
+    case 0x1a: // SUB
+        m_state = GROUND;
+        break;
+    case 0x1b: // ESC
+        m_state = ESCAPE;
+        m_intermediate = 0;
+        break;
+    default: // BEL, SO, SI, ... are ignored
+        break;
+    }
+}
+
+void TerminalEmulator::escapeDispatch(uchar final)
+{
+    switch (final) {
+    case '7': // DECSC
+        m_savedCursor.column = m_column;
+        m_savedCursor.row = m_row;
+        m_savedCursor.style = m_style;
+        m_savedCursor.originMode = m_originMode;
+        break;
+    case '8': // DECRC
+        m_style = m_savedCursor.style;
+        m_originMode = m_savedCursor.originMode;
+        setCursor(m_savedCursor.column, m_savedCursor.row);
+        break;
+    case 'D': // IND
+        m_wrapPending = false;
+        lineFeed();
+        break;
+    case 'E': // NEL
+        setCursor(0, m_row);
+        lineFeed();
+        break;
+    case 'H': // HTS
+        m_tabStops[m_column] = true;
+        break;
+    case 'M': // RI
+        m_wrapPending = false;
+        reverseIndex();
+        break;
+    case 'c': // RIS
+        reset();
+        break;
+    default:
+        break;
+    }
+}
+
+/**
+ * @brief The CSI parameter at index, defaultValue if it is missing or 0
+ */
+int TerminalEmulator::parameter(int index, int defaultValue) const
+{
+    if (index >= m_parameterCount || m_parameters[index] == 0)
+        return defaultValue;
+    return m_parameters[index];
+}
+
+void TerminalEmulator::csiDispatch(uchar final)
+{
+    if (m_intermediate)
+        return;
+    if (m_private && m_private != '?' && final != 'c')
+        return;
+
+    const int n = parameter(0, 1);
+    const int top = m_originMode ? m_scrollTop : 0;
+    switch (final) {
+    case '@': // ICH
+        insertCells(n);
+        break;
+    case 'A': // CUU
+        setCursor(m_column, m_row < m_scrollTop ? qMax(0, m_row - n) : qMax(m_scrollTop, m_row - n));
+        break;
+    case 'B': // CUD
+    case 'e': // VPR
+        setCursor(m_column, m_row > m_scrollBottom ? m_row + n : qMin(m_scrollBottom, m_row + n));
+        break;
+    case 'C': // CUF
+    case 'a': // HPR
+        setCursor(m_column + n, m_row);
+        break;
+    case 'D': // CUB
+        setCursor(m_column - n, m_row);
+        break;
+    case 'E': // CNL
+        setCursor(0, qMin(m_scrollBottom, m_row + n));
+        break;
+    case 'F': // CPL
+        setCursor(0, qMax(m_scrollTop, m_row - n));
+        break;
+    case 'G': // CHA
+    case '`': // HPA
+        setCursor(n - 1, m_row);
+        break;
+    case 'H': // CUP
+    case 'f': // HVP
+        setCursor(parameter(1, 1) - 1, top + n - 1);
+        break;
+    case 'd': // VPA
+        setCursor(m_column, top + n - 1);
+        break;
+    case 'J': // ED
+        switch (parameter(0, 0)) {
+        case 0:
+            eraseCells(m_row, m_column, m_columns - 1);
+            for (int row = m_row + 1; row < m_rows; row++)
+                eraseCells(row, 0, m_columns - 1);
+            break;
+        case 1:
+            for (int row = 0; row < m_row; row++)
+                eraseCells(row, 0, m_columns - 1);
+            eraseCells(m_row, 0, m_column);
+            break;
+        default:
+            for (int row = 0; row < m_rows; row++)
+                eraseCells(row, 0, m_columns - 1);
+            break;
+        }
+        break;
+    case 'K': // EL
+        switch (parameter(0, 0)) {
+        case 0:
+            eraseCells(m_row, m_column, m_columns - 1);
+            break;
+        case 1:
+            eraseCells(m_row, 0, m_column);
+            break;
+        default:
+            eraseCells(m_row, 0, m_columns - 1);
+            break;
+        }
+        break;
+    case 'L': // IL
+        if (m_row >= m_scrollTop && m_row <= m_scrollBottom) {
+            scrollDown(m_row, m_scrollBottom, n);
+            setCursor(0, m_row);
+        }
+        break;
+    case 'M': // DL
+        if (m_row >= m_scrollTop && m_row <= m_scrollBottom) {
+            scrollUp(m_row, m_scrollBottom, n);
+            setCursor(0, m_row);
+        }
+        break;
+    case 'P': // DCH
+        deleteCells(n);
+        break;
+    case 'X': // ECH
+        eraseCells(m_row, m_column, qMin(m_columns - 1, m_column + n - 1));
+        break;
+    case 'S': // SU
+        scrollUp(m_scrollTop, m_scrollBottom, n);
+        break;
+    case 'T': // SD
+        scrollDown(m_scrollTop, m_scrollBottom, n);
+        break;
+    case 'g': // TBC
+        if (parameter(0, 0) == 0)
+            m_tabStops[m_column] = false;
+        else if (parameter(0, 0) == 3)
+            m_tabStops.fill(false);
+        break;
+    case 'h': // SM
+        setMode(true);
+        break;
+    case 'l': // RM
+        setMode(false);
+        break;
+    case 'm': // SGR
+        selectGraphicRendition();
+        break;
+    case 'n': // DSR
+        if (parameter(0, 0) == 5)
+            m_response += "\x1b[0n";
+        else if (parameter(0, 0) == 6)
+            m_response += QByteArray("\x1b[") + QByteArray::number(m_row - top + 1) + ';'
+                          + QByteArray::number(m_column + 1) + 'R';
+        break;
+    case 'c': // DA
+        if (!m_private)
+            m_response += "\x1b[?1;2c"; // VT100 with advanced video option
+        break;
+    case 'r': { // DECSTBM
+        const int first = parameter(0, 1) - 1;
+        const int last = qMin(parameter(1, m_rows), m_rows) - 1;
+        if (first < last) {
+            m_scrollTop = first;
+            m_scrollBottom = last;
+            setCursor(0, m_originMode ? m_scrollTop : 0);
+        }
+        break;
+    }
+    case 's': // SCOSC
+        escapeDispatch('7');
+        break;
+    case 'u': // SCORC
+        escapeDispatch('8');
+        break;
+    default:
+        break;
+    }
+}
+
+void TerminalEmulator::setMode(bool set)
+{
+    for (int i = 0; i < qMax(m_parameterCount, 1); i++) {
+        const int mode = m_parameterCount ? m_parameters[i] : 0;
+        if (m_private == '?') {
+            switch (mode) {
+            case 6: // DECOM
+                m_originMode = set;
+                setCursor(0, set ? m_scrollTop : 0);
+                break;
+            case 7: // DECAWM
+                m_autoWrap = set;
+                m_wrapPending = false;
+                break;
+            case 25: // DECTCEM
+                m_cursorVisible = set;
+                markDamaged(m_row, m_column, m_column);
+                break;
+            case 47:
+            case 1047:
+                switchScreen(set);
+                break;
+            case 1049:
+                // save the cursor and switch to a cleared alternate screen
+                if (set) {
+                    escapeDispatch('7');
+                    switchScreen(true);
+                    for (int row = 0; row < m_rows; row++)
+                        eraseCells(row, 0, m_columns - 1);
+                } else {
+                    switchScreen(false);
+                    escapeDispatch('8');
+                }
+                break;
+            default:
+                break;
+            }
+        } else if (mode == 4) { // IRM
+            m_insertMode = set;
+        }
+    }
+}
+
+void TerminalEmulator::switchScreen(bool alternate)
+{
+    if (alternate == m_alternateScreen)
+        return;
+    m_cells.swap(m_otherCells);
+    m_alternateScreen = alternate;
+    markAllDamaged();
+}
+
+/**
+ * @brief Map a 24 bit color onto the 6x6x6 color cube of the palette
+ */
+static quint16 colorCube(int red, int green, int blue)
+{
+    auto level = [](int value) { return value < 48 ? 0 : value < 115 ? 1 : (value - 35) / 40; };
+    return 16 + 36 * level(red) + 6 * level(green) + level(blue);
+}
+
+void TerminalEmulator::selectGraphicRendition()
+{
+    if (!m_parameterCount) {
+        m_style = Cell();
+        return;
+    }
+    for (int i = 0; i < m_parameterCount; i++) {
+        const int value = m_parameters[i];
+        if (value == 0) {
+            m_style = Cell();
+        } else if (value == 1) {
+            m_style.attributes |= BOLD;
+        } else if (value == 2) {
+            m_style.attributes |= DIM;
+        } else if (value == 4) {
+            m_style.attributes |= UNDERLINE;
+        } else if (value == 5) {
+            m_style.attributes |= BLINK;
+        } else if (value == 7) {
+            m_style.attributes |= REVERSE;
+        } else if (value == 8) {
+            m_style.attributes |= INVISIBLE;
+        } else if (value == 22) {
+            m_style.attributes &= ~(BOLD | DIM);
+        } else if (value == 24) {
+            m_style.attributes &= ~UNDERLINE;
+        } else if (value == 25) {
+            m_style.attributes &= ~BLINK;
+        } else if (value == 27) {
+            m_style.attributes &= ~REVERSE;
+        } else if (value == 28) {
+            m_style.attributes &= ~INVISIBLE;
+        } else if (value >= 30 && value <= 37) {
+            m_style.foreground = value - 30;
+        } else if (value == 39) {
+            m_style.foreground = DEFAULT_COLOR;
+        } else if (value >= 40 && value <= 47) {
+            m_style.background = value - 40;
+        } else if (value == 49) {
+            m_style.background = DEFAULT_COLOR;
+        } else if (value >= 90 && value <= 97) {
+            m_style.foreground = value - 90 + 8;
+        } else if (value >= 100 && value <= 107) {
+            m_style.background = value - 100 + 8;
+        } else if (value == 38 || value == 48) {
+            // 38;5;n picks from the palette, 38;2;r;g;b is approximated with it
+            quint16 color = DEFAULT_COLOR;
+            if (i + 2 < m_parameterCount && m_parameters[i + 1] == 5) {
+                color = qMin(m_parameters[i + 2], 255);
+                i += 2;
+            } else if (i + 4 < m_parameterCount && m_parameters[i + 1] == 2) {
+                color = colorCube(m_parameters[i + 2], m_parameters[i + 3], m_parameters[i + 4]);
+                i += 4;
+            } else {
+                break;
+            }
+            if (value == 38)
+                m_style.foreground = color;
+            else
+                m_style.background = color;
+        }
+    }
+}
+
+void TerminalEmulator::setCursor(int column, int row)
+{
+    // the old and the new position need to be repainted
+    markDamaged(m_row, m_column, m_column);
+    m_column = qBound(0, column, m_columns - 1);
+    m_row = qBound(0, row, m_rows - 1);
+    m_wrapPending = false;
+    markDamaged(m_row, m_column, m_column);
+}
+
+void TerminalEmulator::lineFeed()
+{
+    if (m_row == m_scrollBottom)
+        scrollUp(m_scrollTop, m_scrollBottom, 1);
+    else if (m_row < m_rows - 1)
+        setCursor(m_column, m_row + 1);
+}
+
+void TerminalEmulator::reverseIndex()
+{
+    if (m_row == m_scrollTop)
+        scrollDown(m_scrollTop, m_scrollBottom, 1);
+    else if (m_row > 0)
+        setCursor(m_column, m_row - 1);
+}
+
+/**
+ * @brief Move the rows top to bottom up by count rows, blank rows come in at the bottom
+ */
+void TerminalEmulator::scrollUp(int top, int bottom, int count)
+{
+    count = qMin(count, bottom - top + 1);
+    Cell *cells = m_cells.data();
+    std::copy(cells + (top + count) * m_columns, cells + (bottom + 1) * m_columns, cells + top * m_columns);
+    std::fill(cells + (bottom + 1 - count) * m_columns, cells + (bottom + 1) * m_columns, blank());
+    for (int row = top; row <= bottom; row++)
+        markDamaged(row, 0, m_columns - 1);
+}
+
+/**
+ * @brief Move the rows top to bottom down by count rows, blank rows come in at the top
+ */
+void TerminalEmulator::scrollDown(int top, int bottom, int count)
+{
+    count = qMin(count, bottom - top + 1);
+    Cell *cells = m_cells.data();
+    std::copy_backward(cells + top * m_columns, cells + (bottom + 1 - count) * m_columns,
+                       cells + (bottom + 1) * m_columns);
+    std::fill(cells + top * m_columns, cells + (top + count) * m_columns, blank());
+    for (int row = top; row <= bottom; row++)
+        markDamaged(row, 0, m_columns - 1);
+}
+
+void TerminalEmulator::eraseCells(int row, int first, int last)
+{
+    Cell *cells = m_cells.data() + row * m_columns;
+    std::fill(cells + first, cells + last + 1, blank());
+    markDamaged(row, first, last);
+}
+
+void TerminalEmulator::insertCells(int count)
+{
+    count = qMin(count, m_columns - m_column);
+    Cell *cells = m_cells.data() + m_row * m_columns;
+    std::copy_backward(cells + m_column, cells + m_columns - count, cells + m_columns);
+    std::fill(cells + m_column, cells + m_column + count, blank());
+    markDamaged(m_row, m_column, m_columns - 1);
+}
+
+void TerminalEmulator::deleteCells(int count)
+{
+    count = qMin(count, m_columns - m_column);
+    Cell *cells = m_cells.data() + m_row * m_columns;
+    std::copy(cells + m_column + count, cells + m_columns, cells + m_column);
+    std::fill(cells + m_columns - count, cells + m_columns, blank());
+    markDamaged(m_row, m_column, m_columns - 1);
+}
@@ -0,0 +1,198 @@
+/*
+ * Copyright (c) 2026 CuteCom contributors
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 675 Mass Ave, Cambridge, MA 02139, USA.
+ *
+ * For more information on the GPL, please go to:
+ * http://www.gnu.org/copyleft/gpl.html
+ */
+
+/**
+ * VT100/ANSI terminal emulation on a fixed size grid of cells.
+ *
+ * The received bytes run through a state machine modelled after the DEC
+ * VT parser (ground, escape, CSI, OSC and other strings). Printable
+ * characters are decoded as UTF-8 and written into the grid with the
+ * current attributes, control functions move the cursor, erase or
+ * scroll. Changed cells are recorded as a dirty column range per row,
+ * so a view only needs to repaint what has changed since the damage
+ * was taken the last time.
+ *
+ * The emulator has no notion of a widget, answers to requests of the
+ * device (cursor position, device attributes) are collected and handed
+ * out by takeResponse().
+ */
+
+#ifndef TERMINALEMULATOR_H
+#define TERMINALEMULATOR_H
+
+#include "utf8decoder.h"
+
+#include <QByteArray>
+#include <QVector>
+
+#include <climits>
+
+class TerminalEmulator
+{
+public:
+    enum Attribute { BOLD = 0x01, DIM = 0x02, UNDERLINE = 0x04, BLINK = 0x08, REVERSE = 0x10, INVISIBLE = 0x20 };
+    /* colors 0 - 255 are the xterm palette, DEFAULT_COLOR leaves the color to the view */
+    enum { DEFAULT_COLOR = 256 };
+
+    struct Cell {
+        Cell()
+            : character(' ')
+            , foreground(DEFAULT_COLOR)
+            , background(DEFAULT_COLOR)
+            , attributes(0)
+        {
+        }
+        uint character;
+        quint16 foreground;
+        quint16 background;
+        quint8 attributes;
+        bool sameStyle(const Cell &other) const
+        {
+            return foreground == other.foreground && background == other.background
+                   && attributes == other.attributes;
+        }
+    };
+
+    /* changed columns of a row, first > last if the row is unchanged */
+    struct Damage {
+        Damage()
+            : first(INT_MAX)
+            , last(-1)
+        {
+        }
+        int first;
+        int last;
+        bool isEmpty() const { return first > last; }
+    };
+
+    explicit TerminalEmulator(int columns = 80, int rows = 24);
+
+    /**
+     * @brief Change the size of the grid, the content is kept top left
+     */
+    void resize(int columns, int rows);
+
+    /**
+     * @brief Back to the power on state: empty screen, default attributes
+     */
+    void reset();
+
+    int columns() const { return m_columns; }
+    int rows() const { return m_rows; }
+    const Cell &cell(int column, int row) const { return m_cells.at(row * m_columns + column); }
+
+    int cursorColumn() const { return m_column; }
+    int cursorRow() const { return m_row; }
+    bool cursorVisible() const { return m_cursorVisible; }
+
+    /**
+     * @brief Run received data through the emulation
+     */
+    void feed(const char *data, int len);
+
+    /**
+     * @brief Answers to requests of the device, to be written to it
+     */
+    QByteArray takeResponse();
+
+    /**
+     * @brief The damage of each row since clearDamage()
+     */
+    const QVector<Damage> &damage() const { return m_damage; }
+    bool isDamaged() const { return m_damaged; }
+    void clearDamage();
+
+private:
+    enum State { GROUND, ESCAPE, ESCAPE_INTERMEDIATE, CSI, STRING };
+    enum { MAX_PARAMETERS = 16 };
+
+    struct SavedCursor {
+        SavedCursor()
+            : column(0)
+            , row(0)
+        {
+        }
+        int column;
+        int row;
+        Cell style;
+        bool originMode;
+    };
+
+    Cell &cellAt(int column, int row) { return m_cells[row * m_columns + column]; }
+    Cell blank() const;
+
+    void print(uint character);
+    void control(uchar byte);
+    void escapeDispatch(uchar final);
+    void csiDispatch(uchar final);
+    void setMode(bool set);
+    void selectGraphicRendition();
+    int parameter(int index, int defaultValue) const;
+
+    void setCursor(int column, int row);
+    void lineFeed();
+    void reverseIndex();
+    void scrollUp(int top, int bottom, int count);
+    void scrollDown(int top, int bottom, int count);
+    void eraseCells(int row, int first, int last);
+    void insertCells(int count);
+    void deleteCells(int count);
+    void switchScreen(bool alternate);
+    void markDamaged(int row, int first, int last);
+    void markAllDamaged();
+
+    int m_columns;
+    int m_rows;
+    QVector<Cell> m_cells;
+    /* the other screen while the alternate screen is active */
+    QVector<Cell> m_otherCells;
+    bool m_alternateScreen;
+    QVector<bool> m_tabStops;
+
+    int m_column;
+    int m_row;
+    /* a character has been written to the last column, the next one wraps */
+    bool m_wrapPending;
+    /* attributes and colors for new characters */
+    Cell m_style;
+    SavedCursor m_savedCursor;
+    int m_scrollTop;
+    int m_scrollBottom;
+
+    bool m_autoWrap;
+    bool m_originMode;
+    bool m_insertMode;
+    bool m_cursorVisible;
+
+    State m_state;
+    int m_parameters[MAX_PARAMETERS];
+    int m_parameterCount;
+    /* '?' or '>' in front of the CSI parameters */
+    uchar m_private;
+    uchar m_intermediate;
+    Utf8Decoder m_utf8;
+
+    QVector<Damage> m_damage;
+    bool m_damaged;
+    QByteArray m_response;
+};
+
+#endif // TERMINALEMULATOR_H
@@ -0,0 +1,250 @@
+/*
+ * Copyright (c) 2026 CuteCom contributors
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 675 Mass Ave, Cambridge, MA 02139, USA.
+ *
+ * For more information on the GPL, please go to:
+ * http://www.gnu.org/copyleft/gpl.html
+ */
+
+#include "terminalview.h"
+
+#include <QDebug>
+#include <QKeyEvent>
+#include <QPainter>
+
+#define TRACE                                                                                                          \
+    if (!debug) {                                                                                                      \
+    } else                                                                                                             \
+        qDebug()
+
+static bool debug = false;
+
+TerminalView::TerminalView(QWidget *parent)
+    : QWidget(parent)
+    , m_cursorColumn(0)
+    , m_cursorRow(0)
+{
+    QFont font(QStringLiteral("Monospace"));
+    font.setStyleHint(QFont::TypeWriter);
+    setFont(font);
+    QFontMetrics metrics(font);
+    m_cellWidth = metrics.width(QLatin1Char('M'));
+    m_cellHeight = metrics.height();
+    m_ascent = metrics.ascent();
+
+    setFocusPolicy(Qt::StrongFocus);
+    setAttribute(Qt::WA_OpaquePaintEvent);
+    setAutoFillBackground(false);
+    setSizePolicy(QSizePolicy::Expanding, QSizePolicy::Expanding);
+
+    m_repaintTimer.setSingleShot(true);
+    m_repaintTimer.setInterval(10);
+    connect(&m_repaintTimer, &QTimer::timeout, this, &TerminalView::repaintDamage);
+}
+
+QSize TerminalView::sizeHint() const
+{
+    return QSize(m_emulator.columns() * m_cellWidth, m_emulator.rows() * m_cellHeight);
+}
+
+void TerminalView::feed(const QByteArray &data)
+{
+    m_emulator.feed(data.constData(), data.size());
+    const QByteArray response = m_emulator.takeResponse();
+    if (!response.isEmpty())
+        emit sendData(response);
+    if (m_emulator.isDamaged() && !m_repaintTimer.isActive())
+        m_repaintTimer.start();
+}
+
+void TerminalView::clear()
+{
+    m_emulator.reset();
+    update();
+}
+
+QRect TerminalView::cellRect(int column, int row, int count) const
+{
+    return QRect(column * m_cellWidth, row * m_cellHeight, count * m_cellWidth, m_cellHeight);
+}
+
+/**
+ * @brief Schedule the repaint of the cells changed since the last time
+ *  and of the old and new cursor position
+ */
+void TerminalView::repaintDamage()
+{
+    const QVector<TerminalEmulator::Damage> &damage = m_emulator.damage();
+    QRegion region = cellRect(m_cursorColumn, m_cursorRow);
+    for (int row = 0; row < damage.size(); row++) {
+        if (!damage.at(row).isEmpty())
+            region += cellRect(damage.at(row).first, row, damage.at(row).last - damage.at(row).first + 1);
+    }
+    m_cursorColumn = m_emulator.cursorColumn();
+    m_cursorRow = m_emulator.cursorRow();
+    region += cellRect(m_cursorColumn, m_cursorRow);
+    m_emulator.clearDamage();
+    TRACE << "[TerminalView::repaintDamage]" << region.boundingRect();
+    update(region);
+}
+
+/**
+ * @brief The xterm palette: 16 system colors, a 6x6x6 cube and 24 grays
+ */
+QColor TerminalView::color(int index, bool foreground) const
+{
+    static const QRgb system[16] = {0x000000, 0xcd0000, 0x00cd00, 0xcdcd00, 0x0000ee, 0xcd00cd, 0x00cdcd, 0xe5e5e5,
+                                    0x7f7f7f, 0xff0000, 0x00ff00, 0xffff00, 0x5c5cff, 0xff00ff, 0x00ffff, 0xffffff};
+    if (index >= TerminalEmulator::DEFAULT_COLOR)
+        return foreground ? palette().color(QPalette::Text) : palette().color(QPalette::Base);
+    if (index < 16)
+        return QColor(system[index]);
+    if (index < 232) {
+        index -= 16;
+        auto level = [](int value) { return value ? 55 + value * 40 : 0; };
+        return QColor(level(index / 36), level(index / 6 % 6), level(index % 6));
+    }
+    const int gray = 8 + (index - 232) * 10;
+    return QColor(gray, gray, gray);
+}
+
+void TerminalView::paintEvent(QPaintEvent *event)
+{
+    QPainter painter(this);
+    const QRect area = event->rect();
+    painter.fillRect(area, palette().color(QPalette::Base));
+
+    const int firstRow = qMax(0, area.top() / m_cellHeight);
+    const int lastRow = qMin(m_emulator.rows() - 1, area.bottom() / m_cellHeight);
+    const int firstColumn = qMax(0, area.left() / m_cellWidth);
+    const int lastColumn = qMin(m_emulator.columns() - 1, area.right() / m_cellWidth);
+    const bool showCursor = m_emulator.cursorVisible() && hasFocus();
+
+    QFont font = painter.font();
+    for (int row = firstRow; row <= lastRow; row++) {
+        // draw runs of cells with the same style in one go
+        int column = firstColumn;
+        while (column <= lastColumn) {
+            const TerminalEmulator::Cell &style = m_emulator.cell(column, row);
+            const bool cursor = showCursor && row == m_cursorRow && column == m_cursorColumn;
+            QString text;
+            int end = column;
+            while (end <= lastColumn) {
+                const TerminalEmulator::Cell &cell = m_emulator.cell(end, row);
+                if (!cell.sameStyle(style) || (end != column && showCursor && row == m_cursorRow
+                                               && (end == m_cursorColumn || end - 1 == m_cursorColumn)))
+                    break;
+                text += QString::fromUcs4(&cell.character, 1);
+                end++;
+            }
+
+            QColor foreground = color(style.foreground, true);
+            QColor background = color(style.background, false);
+            if (style.attributes & TerminalEmulator::BOLD && style.foreground < 8)
+                foreground = color(style.foreground + 8, true);
+            if (style.attributes & TerminalEmulator::DIM)
+                foreground = foreground.darker(150);
+            if (bool(style.attributes & TerminalEmulator::REVERSE) != cursor)
+                qSwap(foreground, background);
+
+            const QRect rect = cellRect(column, row, end - column);
+            painter.fillRect(rect, background);
+            if (!(style.attributes & TerminalEmulator::INVISIBLE)) {
+                font.setBold(style.attributes & TerminalEmulator::BOLD);
+                font.setUnderline(style.attributes & TerminalEmulator::UNDERLINE);
+                painter.setFont(font);
+                painter.setPen(foreground);
+                painter.drawText(rect.left(), rect.top() + m_ascent, text);
+            }
+            column = end;
+        }
+    }
+}
+
+/**
+ * @brief Tab belongs to the device, not to the focus chain
+ */
+bool TerminalView::focusNextPrevChild(bool) { return false; }
+
+void TerminalView::keyPressEvent(QKeyEvent *event)
+{
+    QByteArray data;
+    switch (event->key()) {
+    case Qt::Key_Up:
+        data = "\x1b[A";
+        break;
+    case Qt::Key_Down:
+        data = "\x1b[B";
+        break;
+    case Qt::Key_Right:
+        data = "\x1b[C";
+        break;
+    case Qt::Key_Left:
+        data = "\x1b[D";
+        break;
+    case Qt::Key_Home:
+        data = "\x1b[H";
+        break;
+    case Qt::Key_End:
+        data = "\x1b[F";
+        break;
+    case Qt::Key_Insert:
+        data = "\x1b[2~";
+        break;
+    case Qt::Key_Delete:
+        data = "\x1b[3~";
+        break;
+    case Qt::Key_PageUp:
+        data = "\x1b[5~";
+        break;
+    case Qt::Key_PageDown:
+        data = "\x1b[6~";
+        break;
+    case Qt::Key_Return:
+    case Qt::Key_Enter:
+        data = "\r";
+        break;
+    case Qt::Key_Backspace:
+        data = "\x7f";
+        break;
+    case Qt::Key_Tab:
+        data = "\t";
+        break;
+    case Qt::Key_Escape:
+        data = "\x1b";
+        break;
+    default:
+        if (event->key() >= Qt::Key_F1 && event->key() <= Qt::Key_F4) {
+            data = "\x1bO";
+            data += char('P' + event->key() - Qt::Key_F1);
+        } else if (event->key() >= Qt::Key_F5 && event->key() <= Qt::Key_F12) {
+            static const char *const codes[] = {"15", "17", "18", "19", "20", "21", "23", "24"};
+            data = QByteArray("\x1b[") + codes[event->key() - Qt::Key_F5] + '~';
+        } else if (event->modifiers() & Qt::ControlModifier && event->key() >= Qt::Key_A
+                   && event->key() <= Qt::Key_Z) {
+            data += char(event->key() - Qt::Key_A + 1);
+        } else {
+            data = event->text().toUtf8();
+        }
+        break;
+    }
+
+    if (data.isEmpty()) {
+        QWidget::keyPressEvent(event);
+        return;
+    }
+    emit sendData(data);
+}
@@ -0,0 +1,73 @@
+/*
+ * Copyright (c) 2026 CuteCom contributors
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 675 Mass Ave, Cambridge, MA 02139, USA.
+ *
+ * For more information on the GPL, please go to:
+ * http://www.gnu.org/copyleft/gpl.html
+ */
+
+#ifndef TERMINALVIEW_H
+#define TERMINALVIEW_H
+
+#include "terminalemulator.h"
+
+#include <QTimer>
+#include <QWidget>
+
+/**
+ * Shows the cell grid of a TerminalEmulator. Received data is fed with
+ * feed(), only the damaged cells are repainted. Key presses are turned
+ * into the byte sequences of a VT100 keyboard and handed out by
+ * sendData(), as are the answers of the emulator to device requests.
+ */
+class TerminalView : public QWidget
+{
+    Q_OBJECT
+
+public:
+    explicit TerminalView(QWidget *parent = 0);
+
+    void feed(const QByteArray &data);
+    void clear();
+
+    QSize sizeHint() const Q_DECL_OVERRIDE;
+
+signals:
+    void sendData(const QByteArray &data);
+
+protected:
+    void paintEvent(QPaintEvent *event) Q_DECL_OVERRIDE;
+    void keyPressEvent(QKeyEvent *event) Q_DECL_OVERRIDE;
+    bool focusNextPrevChild(bool next) Q_DECL_OVERRIDE;
+
+private slots:
+    void repaintDamage();
+
+private:
+    QColor color(int index, bool foreground) const;
+    QRect cellRect(int column, int row, int count = 1) const;
+
+    TerminalEmulator m_emulator;
+    /* coalesces the repaints of several reads */
+    QTimer m_repaintTimer;
+    int m_cursorColumn;
+    int m_cursorRow;
+    int m_cellWidth;
+    int m_cellHeight;
+    int m_ascent;
+};
+
+#endif // TERMINALVIEW_H
@@ -0,0 +1,69 @@
+/*
+ * Copyright (c) 2026 CuteCom contributors
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 675 Mass Ave, Cambridge, MA 02139, USA.
+ *
+ * For more information on the GPL, please go to:
+ * http://www.gnu.org/copyleft/gpl.html
+ */
+
+#include "autoresponder.h"
+#include <QtTest>
+
+class AutoResponderTest : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void writeParseRoundTrip();
+};
+
+/**
+ * Rules holding the field separator, the comment character and spaces at
+ * the ends of a field are read back as they have been written
+ */
+void AutoResponderTest::writeParseRoundTrip()
+{
+    QVector<AutoResponder::Rule> rules;
+    AutoResponder::Rule rule;
+    rule.pattern = "AT#X";
+    rule.response = "OK|1 # done";
+    rules.append(rule);
+    rule.pattern = "  leading";
+    rule.response = "trailing  ";
+    rules.append(rule);
+    rule.pattern = "\r\n\\";
+    rule.response = "   ";
+    rules.append(rule);
+
+    QString text;
+    QTextStream out(&text);
+    AutoResponder::writeRules(out, rules);
+    out.flush();
+
+    QTextStream in(&text);
+    QString error;
+    const QVector<AutoResponder::Rule> parsed = AutoResponder::parseRules(in, &error);
+    QVERIFY2(error.isEmpty(), qPrintable(error));
+    QCOMPARE(parsed.size(), rules.size());
+    for (int i = 0; i < rules.size(); i++) {
+        QCOMPARE(parsed.at(i).pattern, rules.at(i).pattern);
+        QCOMPARE(parsed.at(i).response, rules.at(i).response);
+    }
+}
+
+QTEST_GUILESS_MAIN(AutoResponderTest)
+
+#include "autoresponder_test.moc"
@@ -0,0 +1,66 @@
+/*
+ * Copyright (c) 2026 CuteCom contributors
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 675 Mass Ave, Cambridge, MA 02139, USA.
+ *
+ * For more information on the GPL, please go to:
+ * http://www.gnu.org/copyleft/gpl.html
+ */
+
+#include "modbusrtu.h"
+#include <QtTest>
+
+class ModbusRtuTest : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void frameInTwoReads();
+};
+
+/**
+ * One request arrives in two reads, the flush timer fires after the
+ * first one and the second one is fed later, e.g. from the worker queue
+ */
+void ModbusRtuTest::frameInTwoReads()
+{
+    // read holding register 0 of slave 1
+    const QByteArray request("\x01\x03\x00\x00\x00\x01\x84\x0a", 8);
+    const qint64 characterTime = 11 * Q_INT64_C(1000000000) / 9600;
+
+    ModbusRtuFramer framer;
+    framer.setLine(9600, characterTime);
+    QList<ModbusRtu::Frame> frames;
+    auto onFrame = [&](const ModbusRtu::Frame &frame) { frames.append(frame); };
+
+    const qint64 firstRead = Q_INT64_C(1000000000);
+    framer.feed(request.constData(), 4, firstRead, onFrame);
+    // longer than the gap, but within the read latency
+    framer.flush(firstRead + framer.gapTime() + 1000000, onFrame);
+    QCOMPARE(frames.size(), 0);
+
+    const qint64 secondRead = firstRead + 4 * characterTime;
+    framer.feed(request.constData() + 4, 4, secondRead, onFrame);
+    QCOMPARE(frames.size(), 0);
+
+    framer.flush(secondRead + framer.gapTime() + framer.readLatency(), onFrame);
+    QCOMPARE(frames.size(), 1);
+    QVERIFY(frames.at(0).crcOk);
+    QCOMPARE(frames.at(0).data, request);
+}
+
+QTEST_APPLESS_MAIN(ModbusRtuTest)
+
+#include "modbusrtu_test.moc"
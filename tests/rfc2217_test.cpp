@@ -0,0 +1,212 @@
+/*
+ * Copyright (c) 2026 CuteCom contributors
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 675 Mass Ave, Cambridge, MA 02139, USA.
+ *
+ * For more information on the GPL, please go to:
+ * http://www.gnu.org/copyleft/gpl.html
+ */
+
+/**
+ * RFC 2217 server mode of the net proxy: the Telnet codec reads back what
+ * it has escaped, also when the stream is cut at any byte, and
+ * NetProxyBridge answers a client on 127.0.0.1.
+ */
+
+#include "captureclock.h"
+#include "netproxybridge.h"
+#include "plugin.h"
+#include "rfc2217.h"
+#include <QElapsedTimer>
+#include <QSerialPort>
+#include <QSignalSpy>
+#include <QTcpSocket>
+#include <QtTest>
+
+class Rfc2217Test : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void initTestCase();
+    void escapeParseRoundTrip_data();
+    void escapeParseRoundTrip();
+    void negotiation();
+    void controlQueries();
+
+private:
+    static void connectClient(NetProxyBridge &bridge, QTcpSocket &client, bool telnet);
+    static QByteArray receive(QTcpSocket &client, int size);
+    static QByteArray subnegotiation(uchar command, const QByteArray &value);
+
+    QByteArray m_data;
+    QTimer m_wakeup;
+};
+
+void Rfc2217Test::initTestCase()
+{
+    qsrand(1);
+    m_data.resize(64 * 1024);
+    for (int i = 0; i < m_data.size(); i++)
+        m_data[i] = static_cast<char>(qrand());
+    // runs of IAC, escaped as IAC IAC
+    m_data.append(QByteArray(5, char(Rfc2217Server::IAC)));
+    // processEvents() below waits for events, this makes sure there are some
+    m_wakeup.start(100);
+}
+
+void Rfc2217Test::escapeParseRoundTrip_data()
+{
+    QTest::addColumn<int>("chunk");
+
+    const int chunks[] = {1, 2, 3, 512, 4096};
+    for (int chunk : chunks)
+        QTest::newRow(qPrintable(QString::number(chunk))) << chunk;
+}
+
+void Rfc2217Test::escapeParseRoundTrip()
+{
+    QFETCH(int, chunk);
+
+    QByteArray stream;
+    for (int pos = 0; pos < m_data.size(); pos += chunk)
+        Rfc2217Server::escape(m_data.constData() + pos, qMin(chunk, m_data.size() - pos), &stream);
+    QCOMPARE(stream, Rfc2217Server::escape(m_data));
+
+    Rfc2217Server server;
+    QByteArray data;
+    QByteArray reply;
+    QVector<Rfc2217Server::Request> requests;
+    for (int pos = 0; pos < stream.size(); pos += chunk)
+        server.feed(stream.constData() + pos, qMin(chunk, stream.size() - pos), &data, &reply, &requests);
+    QCOMPARE(data, m_data);
+    QVERIFY(reply.isEmpty());
+    QVERIFY(requests.isEmpty());
+}
+
+QByteArray Rfc2217Test::subnegotiation(uchar command, const QByteArray &value)
+{
+    QByteArray out;
+    out.append(char(Rfc2217Server::IAC));
+    out.append(char(Rfc2217Server::SB));
+    out.append(char(Rfc2217Server::OPTION_COM_PORT));
+    out.append(char(command));
+    Rfc2217Server::escape(value.constData(), value.size(), &out);
+    out.append(char(Rfc2217Server::IAC));
+    out.append(char(Rfc2217Server::SE));
+    return out;
+}
+
+QByteArray Rfc2217Test::receive(QTcpSocket &client, int size)
+{
+    QByteArray data;
+    QElapsedTimer timer;
+    timer.start();
+    while (data.size() < size && timer.elapsed() < 5000) {
+        QCoreApplication::processEvents(QEventLoop::WaitForMoreEvents);
+        data.append(client.readAll());
+    }
+    return data;
+}
+
+void Rfc2217Test::connectClient(NetProxyBridge &bridge, QTcpSocket &client, bool telnet)
+{
+    bridge.setRfc2217(telnet);
+    bridge.startTcpServer(0);
+    QVERIFY(bridge.tcpPort() != 0);
+
+    client.connectToHost(QHostAddress::LocalHost, bridge.tcpPort());
+    QElapsedTimer timer;
+    timer.start();
+    while (client.state() != QAbstractSocket::ConnectedState && timer.elapsed() < 5000)
+        QCoreApplication::processEvents(QEventLoop::WaitForMoreEvents);
+    QCOMPARE(client.state(), QAbstractSocket::ConnectedState);
+    if (telnet)
+        QCOMPARE(receive(client, Rfc2217Server::greeting().size()), Rfc2217Server::greeting());
+}
+
+void Rfc2217Test::negotiation()
+{
+    NetProxyBridge bridge;
+    QSignalSpy controls(&bridge, &NetProxyBridge::controlPort);
+    QSignalSpy commands(&bridge, &NetProxyBridge::sendCmd);
+    QTcpSocket client;
+    connectClient(bridge, client, true);
+
+    // accept the option, change baud rate and DTR and send some data
+    QByteArray request;
+    request.append(char(Rfc2217Server::IAC));
+    request.append(char(Rfc2217Server::WILL));
+    request.append(char(Rfc2217Server::OPTION_COM_PORT));
+    request.append(subnegotiation(Rfc2217Server::SET_BAUDRATE, QByteArray("\x00\x01\xc2\x00", 4)));
+    request.append(subnegotiation(Rfc2217Server::SET_CONTROL, QByteArray(1, char(Rfc2217Server::CONTROL_DTR_OFF))));
+    request.append("AT\xff\xff\r");
+    client.write(request);
+
+    const QByteArray expected = Rfc2217Server::response(Rfc2217Server::SET_BAUDRATE, 115200)
+                                + Rfc2217Server::response(Rfc2217Server::SET_CONTROL, Rfc2217Server::CONTROL_DTR_OFF);
+    QCOMPARE(receive(client, expected.size()), expected);
+    QCOMPARE(controls.count(), 2);
+    QCOMPARE(controls.at(0).at(0).toInt(), int(Plugin::PORT_BAUD_RATE));
+    QCOMPARE(controls.at(0).at(1).toInt(), 115200);
+    QCOMPARE(controls.at(1).at(0).toInt(), int(Plugin::PORT_DTR));
+    QCOMPARE(controls.at(1).at(1).toInt(), 0);
+    QCOMPARE(commands.count(), 1);
+    QCOMPARE(commands.at(0).at(0).toByteArray(), QByteArray("AT\xff\r"));
+
+    // CTS and DCD on, as QSerialPort::PinoutSignals
+    bridge.controlLines(0x80 | 0x08);
+    const QByteArray state(1, char(Rfc2217Server::MODEM_CTS | Rfc2217Server::MODEM_CD));
+    const QByteArray notification
+        = subnegotiation(Rfc2217Server::NOTIFY_MODEMSTATE + Rfc2217Server::SERVER_OFFSET, state);
+    QCOMPARE(receive(client, notification.size()), notification);
+
+    // serial data are escaped
+    bridge.proxyCmd(QByteArray("\xff\x01", 2), CaptureClock::nsecsElapsed());
+    QCOMPARE(receive(client, 3), QByteArray("\xff\xff\x01", 3));
+}
+
+/**
+ * DTR, RTS and break queries are answered with the state of the device,
+ * not with the one a client set last
+ */
+void Rfc2217Test::controlQueries()
+{
+    NetProxyBridge bridge;
+    // DTR and RTS turned off in the control panel, CTS on
+    bridge.controlLines(QSerialPort::ClearToSendSignal);
+    bridge.setBreakEnabled(true);
+    QTcpSocket client;
+    connectClient(bridge, client, true);
+
+    QByteArray request;
+    request.append(char(Rfc2217Server::IAC));
+    request.append(char(Rfc2217Server::WILL));
+    request.append(char(Rfc2217Server::OPTION_COM_PORT));
+    const Rfc2217Server::Control queries[]
+        = {Rfc2217Server::CONTROL_DTR_QUERY, Rfc2217Server::CONTROL_RTS_QUERY, Rfc2217Server::CONTROL_BREAK_QUERY};
+    for (Rfc2217Server::Control query : queries)
+        request.append(subnegotiation(Rfc2217Server::SET_CONTROL, QByteArray(1, char(query))));
+    client.write(request);
+
+    const QByteArray expected = Rfc2217Server::response(Rfc2217Server::SET_CONTROL, Rfc2217Server::CONTROL_DTR_OFF)
+                                + Rfc2217Server::response(Rfc2217Server::SET_CONTROL, Rfc2217Server::CONTROL_RTS_OFF)
+                                + Rfc2217Server::response(Rfc2217Server::SET_CONTROL, Rfc2217Server::CONTROL_BREAK_ON);
+    QCOMPARE(receive(client, expected.size()), expected);
+}
+
+QTEST_GUILESS_MAIN(Rfc2217Test)
+
+#include "rfc2217_test.moc"
@@ -0,0 +1,98 @@
+/*
+ * Copyright (c) 2026 CuteCom contributors
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 675 Mass Ave, Cambridge, MA 02139, USA.
+ *
+ * For more information on the GPL, please go to:
+ * http://www.gnu.org/copyleft/gpl.html
+ */
+
+#include "captureclock.h"
+#include "sendexpect.h"
+#include <QSignalSpy>
+#include <QtTest>
+
+class SendExpectTest : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void oneAnswerPerRead();
+    void staleAnswerIgnored();
+};
+
+static QList<SendExpectEngine::Step> twoSteps()
+{
+    QList<SendExpectEngine::Step> steps;
+    SendExpectEngine::Step step;
+    step.timeoutMs = 1000;
+    step.send = "A";
+    step.expect = "OK1";
+    steps.append(step);
+    step.send = "B";
+    step.expect = "OK2";
+    steps.append(step);
+    return steps;
+}
+
+void SendExpectTest::oneAnswerPerRead()
+{
+    SendExpectEngine engine;
+    engine.setSteps(twoSteps());
+    QSignalSpy sent(&engine, &SendExpectEngine::sendData);
+    QSignalSpy finished(&engine, &SendExpectEngine::finished);
+
+    engine.start(1);
+    QCOMPARE(sent.count(), 1);
+    engine.processRx("OK1", 3, CaptureClock::nsecsElapsed());
+    QCOMPARE(sent.count(), 2);
+    engine.processRx("OK2", 3, CaptureClock::nsecsElapsed());
+    QCOMPARE(finished.count(), 1);
+    QCOMPARE(engine.statistics(0).samples, 1);
+    QCOMPARE(engine.statistics(1).samples, 1);
+}
+
+/**
+ * The answer of the second step arrives in the read of the first one,
+ * before the second step has been sent. It must not complete the step,
+ * only the answer read later does.
+ */
+void SendExpectTest::staleAnswerIgnored()
+{
+    SendExpectEngine engine;
+    engine.setSteps(twoSteps());
+    QSignalSpy sent(&engine, &SendExpectEngine::sendData);
+    QSignalSpy finished(&engine, &SendExpectEngine::finished);
+
+    engine.start(1);
+    const qint64 firstRead = CaptureClock::nsecsElapsed();
+    engine.processRx("OK1\r\nOK2\r\n", 10, firstRead);
+    QCOMPARE(sent.count(), 2);
+    QCOMPARE(finished.count(), 0);
+    QCOMPARE(engine.statistics(1).samples, 0);
+
+    QTest::qWait(2);
+    const qint64 secondRead = CaptureClock::nsecsElapsed();
+    engine.processRx("OK2\r\n", 5, secondRead);
+    QCOMPARE(finished.count(), 1);
+    QCOMPARE(engine.statistics(1).samples, 1);
+    QVERIFY(engine.statistics(1).min > 0);
+    QVERIFY(engine.statistics(1).min <= secondRead - firstRead);
+    QCOMPARE(engine.statistics(1).timeouts, 0);
+}
+
+QTEST_GUILESS_MAIN(SendExpectTest)
+
+#include "sendexpect_test.moc"
@@ -0,0 +1,72 @@
+/*
+ * Copyright (c) 2026 CuteCom contributors
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 675 Mass Ave, Cambridge, MA 02139, USA.
+ *
+ * For more information on the GPL, please go to:
+ * http://www.gnu.org/copyleft/gpl.html
+ */
+
+#include "triggercapture.h"
+#include <QtTest>
+
+class TriggerCaptureTest : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void postTriggerExceedsRing();
+};
+
+/**
+ * More data arrive after the trigger than the ring holds, the capture
+ * still has the data before the trigger and the trigger itself
+ */
+void TriggerCaptureTest::postTriggerExceedsRing()
+{
+    TriggerCapture capture;
+    capture.setCapacity(1000);
+    QVector<TriggerCapture::Rule> rules(1);
+    rules[0].argument = QStringLiteral("BOOM");
+    QVERIFY(capture.setRules(rules, 0));
+
+    qint64 timestamp = 0;
+    auto onTrigger = [&](int rule) {
+        QCOMPARE(rule, 0);
+        capture.beginCapture(timestamp);
+    };
+    for (int i = 0; i < 5; i++)
+        capture.recordRx(QByteArray(100, 'a'), ++timestamp, onTrigger);
+    capture.recordRx(QByteArrayLiteral("BOOM"), ++timestamp, onTrigger);
+    QVERIFY(capture.isCapturing());
+    const qint64 triggerTime = timestamp;
+    for (int i = 0; i < 30; i++)
+        capture.recordRx(QByteArray(100, 'b'), ++timestamp, onTrigger);
+    // the ring has moved on
+    QVERIFY(capture.snapshot(timestamp).first().timestamp > triggerTime);
+
+    const QList<TriggerCapture::Record> records = capture.takeCapture(timestamp);
+    QVERIFY(!capture.isCapturing());
+    QCOMPARE(records.first().timestamp, qint64(1));
+    QCOMPARE(records.at(5).timestamp, triggerTime);
+    QCOMPARE(records.at(5).data, QByteArrayLiteral("BOOM"));
+    // the data after the trigger are bounded by the capacity
+    QCOMPARE(records.size(), 5 + 1 + 10);
+    QCOMPARE(records.last().data, QByteArray(100, 'b'));
+}
+
+QTEST_APPLESS_MAIN(TriggerCaptureTest)
+
+#include "triggercapture_test.moc"
@@ -0,0 +1,53 @@
+/*
+ * Copyright (c) 2026 CuteCom contributors
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 675 Mass Ave, Cambridge, MA 02139, USA.
+ *
+ * For more information on the GPL, please go to:
+ * http://www.gnu.org/copyleft/gpl.html
+ */
+
+#include "throughputmeter.h"
+
+ThroughputMeter::ThroughputMeter(qint64 windowNs)
+    : m_bytes(0)
+    , m_frames(0)
+    , m_windowNs(windowNs)
+    , m_bytesPerSecond(0)
+    , m_framesPerSecond(0)
+    , m_peakBytesPerSecond(0)
+{
+}
+
+void ThroughputMeter::sample(qint64 now)
+{
+    Sample current = {now, bytes(), frames()};
+    m_samples.enqueue(current);
+    // keep the newest sample that is at least one window old as reference
+    while (m_samples.size() > 2 && now - m_samples.at(1).time >= m_windowNs)
+        m_samples.dequeue();
+
+    const Sample &oldest = m_samples.head();
+    const qint64 elapsed = now - oldest.time;
+    if (elapsed <= 0) {
+        m_bytesPerSecond = 0;
+        m_framesPerSecond = 0;
+        return;
+    }
+    m_bytesPerSecond = (current.bytes - oldest.bytes) * 1e9 / elapsed;
+    m_framesPerSecond = (current.frames - oldest.frames) * 1e9 / elapsed;
+    if (m_bytesPerSecond > m_peakBytesPerSecond)
+        m_peakBytesPerSecond = m_bytesPerSecond;
+}
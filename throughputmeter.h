@@ -0,0 +1,79 @@
+/*
+ * Copyright (c) 2026 CuteCom contributors
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 675 Mass Ave, Cambridge, MA 02139, USA.
+ *
+ * For more information on the GPL, please go to:
+ * http://www.gnu.org/copyleft/gpl.html
+ */
+
+/**
+ * Byte and frame counter with moving-window rates. add() is cheap and may
+ * be called from any thread for every chunk, everything else is meant for
+ * the thread that renders the values, which calls sample() periodically.
+ */
+
+#ifndef THROUGHPUTMETER_H
+#define THROUGHPUTMETER_H
+
+#include <QAtomicInteger>
+#include <QQueue>
+
+class ThroughputMeter
+{
+public:
+    /**
+     * @param windowNs Width of the moving window the rates are averaged over
+     */
+    explicit ThroughputMeter(qint64 windowNs = 1000000000);
+
+    /**
+     * @brief Count one frame, i.e. one chunk read or written
+     */
+    void add(qint64 bytes)
+    {
+        m_bytes.fetchAndAddRelaxed(bytes);
+        m_frames.fetchAndAddRelaxed(1);
+    }
+    qint64 bytes() const { return m_bytes.load(); }
+    qint64 frames() const { return m_frames.load(); }
+
+    /**
+     * @brief Take a sample of the counters and update the rates
+     * @param now CaptureClock time of the sample
+     */
+    void sample(qint64 now);
+    double bytesPerSecond() const { return m_bytesPerSecond; }
+    double framesPerSecond() const { return m_framesPerSecond; }
+    double peakBytesPerSecond() const { return m_peakBytesPerSecond; }
+    void clearPeak() { m_peakBytesPerSecond = 0; }
+
+private:
+    struct Sample {
+        qint64 time;
+        qint64 bytes;
+        qint64 frames;
+    };
+
+    QAtomicInteger<qint64> m_bytes;
+    QAtomicInteger<qint64> m_frames;
+    qint64 m_windowNs;
+    QQueue<Sample> m_samples;
+    double m_bytesPerSecond;
+    double m_framesPerSecond;
+    double m_peakBytesPerSecond;
+};
+
+#endif // THROUGHPUTMETER_H
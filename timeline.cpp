@@ -0,0 +1,270 @@
+/*
+ * Copyright (c) 2026 CuteCom contributors
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 675 Mass Ave, Cambridge, MA 02139, USA.
+ *
+ * For more information on the GPL, please go to:
+ * http://www.gnu.org/copyleft/gpl.html
+ */
+
+#include "timeline.h"
+
+#include <algorithm>
+
+TimelineIndex::TimelineIndex()
+    : m_firstLine(0)
+    , m_dropped(0)
+    , m_lineOpen(false)
+    , m_begin(0)
+    , m_end(0)
+    , m_capacity(64 * 1024 * 1024)
+{
+}
+
+void TimelineIndex::setCapacity(qint64 bytes)
+{
+    m_capacity = qMax<qint64>(bytes, CHUNK_SIZE);
+    dropChunks();
+}
+
+void TimelineIndex::clear()
+{
+    m_dropped += lineCount();
+    m_lines.clear();
+    m_firstLine = 0;
+    m_lineOpen = false;
+    m_chunks.clear();
+    m_begin = m_end;
+}
+
+void TimelineIndex::append(const QByteArray &data, qint64 timestamp)
+{
+    int start = 0;
+    while (start < data.size()) {
+        if (!m_lineOpen) {
+            Line line = {timestamp, m_end};
+            m_lines.append(line);
+            m_lineOpen = true;
+        }
+        const int end = data.indexOf('\n', start);
+        const int stop = end < 0 ? data.size() : end + 1;
+        store(data.constData() + start, stop - start);
+        if (end >= 0)
+            m_lineOpen = false;
+        start = stop;
+    }
+    dropChunks();
+}
+
+void TimelineIndex::store(const char *data, int size)
+{
+    while (size > 0) {
+        if (m_chunks.isEmpty() || m_chunks.last().size() == CHUNK_SIZE) {
+            m_chunks.append(QByteArray());
+            m_chunks.last().reserve(CHUNK_SIZE);
+        }
+        QByteArray &chunk = m_chunks.last();
+        const int n = qMin(size, CHUNK_SIZE - chunk.size());
+        chunk.append(data, n);
+        m_end += n;
+        data += n;
+        size -= n;
+    }
+}
+
+/**
+ * @brief With short lines the index takes more than the data, so both
+ *  count against the capacity
+ */
+void TimelineIndex::dropChunks()
+{
+    if (size() <= m_capacity)
+        return;
+    while (size() > m_capacity && m_chunks.size() > 1) {
+        m_begin += m_chunks.takeFirst().size();
+        dropLines();
+    }
+    // the lines of the last chunk alone may still be too many, their bytes stay until the chunk goes
+    const qint64 excess = size() - m_capacity;
+    if (excess > 0) {
+        const qint64 lineSize = sizeof(Line);
+        const int lines = int(qMin<qint64>((excess + lineSize - 1) / lineSize, lineCount() - 1));
+        m_firstLine += lines;
+        m_dropped += lines;
+    }
+    if (m_firstLine > 4096 && m_firstLine > m_lines.size() / 2) {
+        m_lines.remove(0, m_firstLine);
+        m_firstLine = 0;
+    }
+}
+
+/**
+ * @brief Lines starting in a dropped chunk go as well, only a line still
+ *  being received loses its beginning instead
+ */
+void TimelineIndex::dropLines()
+{
+    while (m_firstLine < m_lines.size() && m_lines.at(m_firstLine).offset < m_begin) {
+        if (m_lineOpen && m_firstLine == m_lines.size() - 1) {
+            m_lines[m_firstLine].offset = m_begin;
+            break;
+        }
+        m_firstLine++;
+        m_dropped++;
+    }
+}
+
+QByteArray TimelineIndex::line(int line) const
+{
+    const int i = m_firstLine + line;
+    qint64 begin = m_lines.at(i).offset;
+    qint64 end = i + 1 < m_lines.size() ? m_lines.at(i + 1).offset : m_end;
+
+    QByteArray bytes;
+    bytes.reserve(int(end - begin));
+    int chunk = int((begin - m_begin) / CHUNK_SIZE);
+    qint64 chunkBegin = m_begin + qint64(chunk) * CHUNK_SIZE;
+    while (begin < end) {
+        const QByteArray &data = m_chunks.at(chunk);
+        const int from = int(begin - chunkBegin);
+        const int n = int(qMin<qint64>(end - begin, data.size() - from));
+        bytes.append(data.constData() + from, n);
+        begin += n;
+        chunkBegin += data.size();
+        chunk++;
+    }
+    if (bytes.endsWith('\n'))
+        bytes.chop(1);
+    if (bytes.endsWith('\r'))
+        bytes.chop(1);
+    return bytes;
+}
+
+int TimelineIndex::lowerBound(qint64 timestamp) const
+{
+    const Line *first = m_lines.constData() + m_firstLine;
+    const Line *last = m_lines.constData() + m_lines.size();
+    const Line *it = std::lower_bound(first, last, timestamp,
+                                      [](const Line &line, qint64 t) { return line.timestamp < t; });
+    return int(it - first);
+}
+
+TimelineMerge::TimelineMerge()
+    : m_cursorRow(-1)
+{
+}
+
+void TimelineMerge::setSources(const QVector<const TimelineIndex *> &sources)
+{
+    m_sources = sources;
+    m_cursor.fill(0, m_sources.size());
+    invalidate();
+}
+
+qint64 TimelineMerge::rowCount() const
+{
+    qint64 count = 0;
+    foreach (const TimelineIndex *source, m_sources)
+        count += source->lineCount();
+    return count;
+}
+
+qint64 TimelineMerge::countBefore(qint64 timestamp) const
+{
+    qint64 count = 0;
+    foreach (const TimelineIndex *source, m_sources)
+        count += source->lowerBound(timestamp);
+    return count;
+}
+
+/**
+ * @brief Position the cursor at a row of the merge. The binary search
+ *  finds the latest time with at most \a row lines before it, the lines
+ *  at that very time are merged one by one.
+ */
+void TimelineMerge::seek(qint64 row)
+{
+    qint64 low = 0;
+    qint64 high = 0;
+    bool first = true;
+    foreach (const TimelineIndex *source, m_sources) {
+        if (source->lineCount() == 0)
+            continue;
+        const qint64 begin = source->timestamp(0);
+        const qint64 end = source->timestamp(source->lineCount() - 1) + 1;
+        low = first ? begin : qMin(low, begin);
+        high = first ? end : qMax(high, end);
+        first = false;
+    }
+    // countBefore(low) <= row < countBefore(high)
+    while (high - low > 1) {
+        const qint64 middle = low + (high - low) / 2;
+        if (countBefore(middle) <= row)
+            low = middle;
+        else
+            high = middle;
+    }
+    for (int i = 0; i < m_sources.size(); i++)
+        m_cursor[i] = m_sources.at(i)->lowerBound(low);
+    m_cursorRow = countBefore(low);
+
+    Row skipped;
+    while (m_cursorRow < row && next(&skipped)) {
+    }
+}
+
+/**
+ * @brief Take the next row of the merge. There are only a few sources,
+ *  a linear search for the earliest one beats a heap.
+ */
+bool TimelineMerge::next(Row *row)
+{
+    int source = -1;
+    qint64 earliest = 0;
+    for (int i = 0; i < m_sources.size(); i++) {
+        if (m_cursor.at(i) >= m_sources.at(i)->lineCount())
+            continue;
+        const qint64 timestamp = m_sources.at(i)->timestamp(m_cursor.at(i));
+        if (source < 0 || timestamp < earliest) {
+            source = i;
+            earliest = timestamp;
+        }
+    }
+    if (source < 0)
+        return false;
+    row->source = source;
+    row->line = m_cursor[source]++;
+    m_cursorRow++;
+    return true;
+}
+
+QVector<TimelineMerge::Row> TimelineMerge::rows(qint64 first, int count)
+{
+    QVector<Row> rows;
+    if (first < 0 || first >= rowCount())
+        return rows;
+
+    // continue from the last request if it ended a little before, e.g.
+    // while scrolling down, otherwise search
+    if (m_cursorRow < 0 || first < m_cursorRow || first - m_cursorRow > qMax(count, 1024))
+        seek(first);
+    Row row;
+    while (m_cursorRow < first && next(&row)) {
+    }
+    rows.reserve(count);
+    while (rows.size() < count && next(&row))
+        rows.append(row);
+    return rows;
+}
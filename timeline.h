@@ -0,0 +1,164 @@
+/*
+ * Copyright (c) 2026 CuteCom contributors
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 675 Mass Ave, Cambridge, MA 02139, USA.
+ *
+ * For more information on the GPL, please go to:
+ * http://www.gnu.org/copyleft/gpl.html
+ */
+
+/**
+ * Lines received from several ports, merged by time.
+ *
+ * A TimelineIndex keeps the data received from one port in chunks and
+ * an index of the lines with the CaptureClock time their first byte has
+ * been read. The data are appended once and never copied around, old
+ * chunks are dropped once the data and the index exceed the capacity.
+ *
+ * A TimelineMerge interleaves the lines of several indexes by timestamp
+ * (ties in the order of the sources) without materialising the merged
+ * sequence: a row of the merge is found by a binary search over the time
+ * of all indexes, the rows following it by a k-way merge from there. The
+ * position of the last request is kept, so scrolling through the merge
+ * only merges the rows that are shown.
+ */
+
+#ifndef TIMELINE_H
+#define TIMELINE_H
+
+#include <QByteArray>
+#include <QList>
+#include <QVector>
+
+class TimelineIndex
+{
+public:
+    TimelineIndex();
+
+    /**
+     * @brief Bytes of data and line index kept, the oldest lines are dropped
+     */
+    void setCapacity(qint64 bytes);
+    qint64 capacity() const { return m_capacity; }
+
+    /**
+     * @brief Bytes of data and line index in use
+     */
+    qint64 size() const { return m_end - m_begin + qint64(lineCount()) * qint64(sizeof(Line)); }
+
+    void append(const QByteArray &data, qint64 timestamp);
+    void clear();
+
+    /**
+     * @brief Number of lines kept, the last one may still be incomplete.
+     *  Line numbers start with the oldest line kept.
+     */
+    int lineCount() const { return m_lines.size() - m_firstLine; }
+
+    qint64 timestamp(int line) const { return m_lines.at(m_firstLine + line).timestamp; }
+
+    /**
+     * @brief The bytes of a line without the line break
+     */
+    QByteArray line(int line) const;
+
+    /**
+     * @brief Number of the first line with a timestamp of at least \a timestamp
+     */
+    int lowerBound(qint64 timestamp) const;
+
+    /**
+     * @brief Number of lines dropped so far, changes the line numbers
+     */
+    quint64 dropped() const { return m_dropped; }
+
+    /**
+     * @brief Number of bytes appended so far, changes with every append
+     */
+    qint64 appended() const { return m_end; }
+
+private:
+    enum { CHUNK_SIZE = 1024 * 1024 };
+
+    struct Line {
+        qint64 timestamp;
+        /* position of the first byte, counted from the first byte ever appended */
+        qint64 offset;
+    };
+
+    void store(const char *data, int size);
+    void dropChunks();
+    void dropLines();
+
+    QVector<Line> m_lines;
+    /* lines before this one have been dropped and wait to be compacted */
+    int m_firstLine;
+    quint64 m_dropped;
+    /* the last line has not been terminated yet */
+    bool m_lineOpen;
+
+    QList<QByteArray> m_chunks;
+    /* position of the first byte of m_chunks.first() and after the last byte */
+    qint64 m_begin;
+    qint64 m_end;
+    qint64 m_capacity;
+};
+
+class TimelineMerge
+{
+public:
+    struct Row {
+        int source;
+        int line;
+    };
+
+    TimelineMerge();
+
+    /**
+     * @brief The indexes to merge, the merge does not own them
+     */
+    void setSources(const QVector<const TimelineIndex *> &sources);
+    const QVector<const TimelineIndex *> &sources() const { return m_sources; }
+
+    /**
+     * @brief Forget the position of the last request, needed whenever
+     *  lines have been added to or dropped from a source
+     */
+    void invalidate() { m_cursorRow = -1; }
+
+    qint64 rowCount() const;
+
+    /**
+     * @brief Number of rows before the lines at \a timestamp
+     */
+    qint64 countBefore(qint64 timestamp) const;
+
+    /**
+     * @brief Rows \a first up to \a first + \a count - 1 of the merge,
+     *  less at the end of the merge
+     */
+    QVector<Row> rows(qint64 first, int count);
+
+private:
+    void seek(qint64 row);
+    bool next(Row *row);
+
+    QVector<const TimelineIndex *> m_sources;
+    /* next line of each source and the row of the merge it is at, -1 if unknown */
+    QVector<int> m_cursor;
+    qint64 m_cursorRow;
+};
+
+#endif // TIMELINE_H
@@ -0,0 +1,278 @@
+/*
+ * Copyright (c) 2026 CuteCom contributors
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 675 Mass Ave, Cambridge, MA 02139, USA.
+ *
+ * For more information on the GPL, please go to:
+ * http://www.gnu.org/copyleft/gpl.html
+ */
+
+#include "timelinewindow.h"
+#include "captureclock.h"
+#include "mainwindow.h"
+
+#include <QHeaderView>
+#include <QPointer>
+
+#include <limits>
+
+TimelineModel::TimelineModel(QObject *parent)
+    : QAbstractTableModel(parent)
+    , m_windowFirst(0)
+    , m_rowCount(0)
+    , m_appended(0)
+    , m_dropped(0)
+{
+}
+
+void TimelineModel::changes(qint64 *appended, quint64 *dropped) const
+{
+    *appended = 0;
+    *dropped = 0;
+    foreach (const Source &source, m_sources) {
+        *appended += source.index->appended();
+        *dropped += source.index->dropped();
+    }
+}
+
+void TimelineModel::setSources(const QVector<Source> &sources)
+{
+    beginResetModel();
+    m_sources = sources;
+    QVector<const TimelineIndex *> indexes;
+    foreach (const Source &source, m_sources)
+        indexes.append(source.index);
+    m_merge.setSources(indexes);
+    m_window.clear();
+    m_rowCount = int(qMin<qint64>(m_merge.rowCount(), std::numeric_limits<int>::max()));
+    m_lineCounts.clear();
+    m_sourceAppended.clear();
+    foreach (const Source &source, m_sources) {
+        m_lineCounts.append(source.index->lineCount());
+        m_sourceAppended.append(source.index->appended());
+    }
+    changes(&m_appended, &m_dropped);
+    endResetModel();
+}
+
+/**
+ * @brief Dropped lines renumber all rows. Otherwise a port only appends
+ *  to its last line or adds lines at least as late, so the rows before
+ *  the last line it had keep their contents and only the rows from there
+ *  on are reported as changed; rows added at the end are inserted.
+ */
+void TimelineModel::refresh()
+{
+    qint64 appended;
+    quint64 dropped;
+    changes(&appended, &dropped);
+    if (appended == m_appended && dropped == m_dropped)
+        return;
+    const bool renumbered = dropped != m_dropped;
+    m_appended = appended;
+    m_dropped = dropped;
+
+    m_merge.invalidate();
+    m_window.clear();
+    qint64 firstChanged = renumbered ? 0 : std::numeric_limits<qint64>::max();
+    for (int i = 0; i < m_sources.size(); i++) {
+        const TimelineIndex *source = m_sources.at(i).index;
+        if (!renumbered && source->appended() != m_sourceAppended.at(i) && source->lineCount() > 0) {
+            const int line = qBound(0, m_lineCounts.at(i) - 1, source->lineCount() - 1);
+            firstChanged = qMin(firstChanged, m_merge.countBefore(source->timestamp(line)));
+        }
+        m_lineCounts[i] = source->lineCount();
+        m_sourceAppended[i] = source->appended();
+    }
+    const int oldCount = m_rowCount;
+    const int count = int(qMin<qint64>(m_merge.rowCount(), std::numeric_limits<int>::max()));
+    if (count > m_rowCount) {
+        beginInsertRows(QModelIndex(), m_rowCount, count - 1);
+        m_rowCount = count;
+        endInsertRows();
+    } else if (count < m_rowCount) {
+        beginRemoveRows(QModelIndex(), count, m_rowCount - 1);
+        m_rowCount = count;
+        endRemoveRows();
+    }
+    const int lastChanged = qMin(oldCount, m_rowCount) - 1;
+    if (firstChanged <= lastChanged)
+        emit dataChanged(index(int(firstChanged), 0), index(lastChanged, COL_COUNT - 1));
+}
+
+int TimelineModel::rowCount(const QModelIndex &parent) const { return parent.isValid() ? 0 : m_rowCount; }
+
+int TimelineModel::columnCount(const QModelIndex &parent) const { return parent.isValid() ? 0 : COL_COUNT; }
+
+const TimelineMerge::Row *TimelineModel::row(int row) const
+{
+    if (m_window.isEmpty() || row < m_windowFirst || row >= m_windowFirst + m_window.size()) {
+        m_windowFirst = qMax(0, row - WINDOW_BEFORE);
+        m_window = m_merge.rows(m_windowFirst, WINDOW_SIZE);
+    }
+    const qint64 i = row - m_windowFirst;
+    return i < m_window.size() ? &m_window.at(int(i)) : nullptr;
+}
+
+QVariant TimelineModel::data(const QModelIndex &index, int role) const
+{
+    if (!index.isValid() || (role != Qt::DisplayRole && role != Qt::ForegroundRole))
+        return QVariant();
+    const TimelineMerge::Row *merged = row(index.row());
+    if (!merged)
+        return QVariant();
+    const Source &source = m_sources.at(merged->source);
+
+    if (role == Qt::ForegroundRole)
+        return source.color;
+
+    switch (index.column()) {
+    case COL_TIME: {
+        const qint64 timestamp = source.index->timestamp(merged->line);
+        const int usecs = int(CaptureClock::toUSecsSinceEpoch(timestamp) % 1000);
+        return CaptureClock::toTime(timestamp).toString(QStringLiteral("hh:mm:ss.zzz")) +
+               QStringLiteral("%1").arg(usecs, 3, 10, QLatin1Char('0'));
+    }
+    case COL_PORT:
+        return source.name;
+    case COL_DATA:
+        return QString::fromUtf8(source.index->line(merged->line));
+    default:
+        return QVariant();
+    }
+}
+
+QVariant TimelineModel::headerData(int section, Qt::Orientation orientation, int role) const
+{
+    if (orientation != Qt::Horizontal || role != Qt::DisplayRole)
+        return QVariant();
+    switch (section) {
+    case COL_TIME:
+        return tr("Time");
+    case COL_PORT:
+        return tr("Port");
+    case COL_DATA:
+        return tr("Line");
+    default:
+        return QVariant();
+    }
+}
+
+void TimelineWindow::showTimeline()
+{
+    static QPointer<TimelineWindow> timeline;
+    if (timeline.isNull()) {
+        timeline = new TimelineWindow();
+        timeline->setAttribute(Qt::WA_DeleteOnClose);
+    }
+    timeline->show();
+    timeline->raise();
+    timeline->activateWindow();
+}
+
+TimelineWindow::TimelineWindow(QWidget *parent)
+    : QWidget(parent)
+    , m_model(new TimelineModel(this))
+    , m_nextHue(0)
+{
+    setupUi(this);
+
+    m_splitter->setSizes(QList<int>() << 160 << 640);
+    m_table->setModel(m_model);
+    // rows of one height don't need to be measured, millions of them stay cheap
+    m_table->verticalHeader()->setSectionResizeMode(QHeaderView::Fixed);
+    m_table->verticalHeader()->setDefaultSectionSize(m_table->fontMetrics().height() + 4);
+    m_table->verticalHeader()->hide();
+    m_table->horizontalHeader()->setStretchLastSection(true);
+    const int timeWidth = m_table->fontMetrics().width(QStringLiteral("00:00:00.000000"));
+    m_table->setColumnWidth(TimelineModel::COL_TIME, timeWidth + 16);
+
+    connect(m_list_ports, &QListWidget::itemChanged, this, &TimelineWindow::updateSources);
+    connect(m_bt_close, &QPushButton::clicked, this, &QWidget::close);
+    connect(&m_refreshTimer, &QTimer::timeout, this, &TimelineWindow::refresh);
+    m_refreshTimer.start(250);
+
+    MainWindow::setTimelineRecording(true);
+    updatePorts();
+    refresh();
+}
+
+TimelineWindow::~TimelineWindow() { MainWindow::setTimelineRecording(false); }
+
+/**
+ * @brief List the ports of the open windows. A new port is merged right
+ *  away and keeps its colour as long as the timeline is shown.
+ */
+void TimelineWindow::updatePorts()
+{
+    const QList<MainWindow *> windows = MainWindow::windows();
+    // the pointers of closed windows are compared, never used
+    bool changed = windows != m_windows;
+    for (int i = 0; !changed && i < m_windows.size(); i++)
+        changed = m_list_ports->item(i)->text() != m_windows.at(i)->portLabel();
+    if (!changed)
+        return;
+
+    QList<MainWindow *> unchecked;
+    for (int i = 0; i < m_windows.size(); i++) {
+        if (m_list_ports->item(i)->checkState() == Qt::Unchecked)
+            unchecked.append(m_windows.at(i));
+    }
+
+    QHash<MainWindow *, QColor> colors;
+    m_list_ports->blockSignals(true);
+    m_list_ports->clear();
+    foreach (MainWindow *window, windows) {
+        if (!m_windows.contains(window))
+            connect(window, &QObject::destroyed, this, &TimelineWindow::updatePorts);
+        QColor color = m_colors.value(window);
+        if (!color.isValid())
+            color = QColor::fromHsv((m_nextHue += 137) % 360, 255, 160);
+        colors.insert(window, color);
+
+        QListWidgetItem *item = new QListWidgetItem(window->portLabel(), m_list_ports);
+        item->setFlags(item->flags() | Qt::ItemIsUserCheckable);
+        item->setCheckState(unchecked.contains(window) ? Qt::Unchecked : Qt::Checked);
+        item->setForeground(color);
+    }
+    m_list_ports->blockSignals(false);
+    m_windows = windows;
+    m_colors = colors;
+    updateSources();
+}
+
+void TimelineWindow::updateSources()
+{
+    QVector<TimelineModel::Source> sources;
+    for (int i = 0; i < m_windows.size(); i++) {
+        const QListWidgetItem *item = m_list_ports->item(i);
+        if (item->checkState() != Qt::Checked)
+            continue;
+        TimelineModel::Source source = {&m_windows.at(i)->timeline(), item->text(), m_colors.value(m_windows.at(i))};
+        sources.append(source);
+    }
+    m_model->setSources(sources);
+    if (m_check_follow->isChecked())
+        m_table->scrollToBottom();
+}
+
+void TimelineWindow::refresh()
+{
+    updatePorts();
+    m_model->refresh();
+    m_lb_lines->setText(tr("%1 lines").arg(m_model->rowCount()));
+    if (m_check_follow->isChecked())
+        m_table->scrollToBottom();
+}
@@ -0,0 +1,117 @@
+/*
+ * Copyright (c) 2026 CuteCom contributors
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 675 Mass Ave, Cambridge, MA 02139, USA.
+ *
+ * For more information on the GPL, please go to:
+ * http://www.gnu.org/copyleft/gpl.html
+ */
+
+#ifndef TIMELINEWINDOW_H
+#define TIMELINEWINDOW_H
+
+#include "timeline.h"
+#include "ui_timelinewindow.h"
+
+#include <QAbstractTableModel>
+#include <QColor>
+#include <QHash>
+#include <QTimer>
+
+class MainWindow;
+
+/**
+ * Rows of a TimelineMerge for a view. Only the rows around the one
+ * asked for are merged and kept, so the view costs the same no matter
+ * how many lines the ports have received.
+ */
+class TimelineModel : public QAbstractTableModel
+{
+    Q_OBJECT
+
+public:
+    enum Columns { COL_TIME, COL_PORT, COL_DATA, COL_COUNT };
+
+    struct Source {
+        const TimelineIndex *index;
+        QString name;
+        QColor color;
+    };
+
+    explicit TimelineModel(QObject *parent = 0);
+
+    void setSources(const QVector<Source> &sources);
+
+    /**
+     * @brief Pick up the lines received since the last refresh
+     */
+    void refresh();
+
+    int rowCount(const QModelIndex &parent = QModelIndex()) const Q_DECL_OVERRIDE;
+    int columnCount(const QModelIndex &parent = QModelIndex()) const Q_DECL_OVERRIDE;
+    QVariant data(const QModelIndex &index, int role = Qt::DisplayRole) const Q_DECL_OVERRIDE;
+    QVariant headerData(int section, Qt::Orientation orientation, int role = Qt::DisplayRole) const Q_DECL_OVERRIDE;
+
+private:
+    enum { WINDOW_SIZE = 256, WINDOW_BEFORE = 64 };
+
+    const TimelineMerge::Row *row(int row) const;
+    void changes(qint64 *appended, quint64 *dropped) const;
+
+    QVector<Source> m_sources;
+    mutable TimelineMerge m_merge;
+    /* the merged rows starting at m_windowFirst */
+    mutable QVector<TimelineMerge::Row> m_window;
+    mutable qint64 m_windowFirst;
+    int m_rowCount;
+    /* per source: lines and bytes at the last refresh */
+    QVector<int> m_lineCounts;
+    QVector<qint64> m_sourceAppended;
+    qint64 m_appended;
+    quint64 m_dropped;
+};
+
+/**
+ * The lines received by the ports of all windows interleaved by the
+ * time they have been read, each port in a colour of its own. The lines
+ * are recorded from the time the timeline is shown until it is closed.
+ */
+class TimelineWindow : public QWidget, private Ui::TimelineWindow
+{
+    Q_OBJECT
+
+public:
+    /**
+     * @brief Show the timeline, there is one for the whole process
+     */
+    static void showTimeline();
+
+private:
+    explicit TimelineWindow(QWidget *parent = 0);
+    ~TimelineWindow();
+
+    void updatePorts();
+    void updateSources();
+    void refresh();
+
+    TimelineModel *m_model;
+    /* the windows listed in m_list_ports, in that order */
+    QList<MainWindow *> m_windows;
+    QHash<MainWindow *, QColor> m_colors;
+    int m_nextHue;
+    QTimer m_refreshTimer;
+};
+
+#endif // TIMELINEWINDOW_H
@@ -0,0 +1,263 @@
+/*
+ * Copyright (c) 2026 CuteCom contributors
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 675 Mass Ave, Cambridge, MA 02139, USA.
+ *
+ * For more information on the GPL, please go to:
+ * http://www.gnu.org/copyleft/gpl.html
+ */
+
+#include "triggercapture.h"
+#include "captureclock.h"
+
+#include <QObject>
+#include <QStringList>
+
+static const struct {
+    TriggerCapture::ControlLine line;
+    const char *name;
+} controlLineNames[] = {{TriggerCapture::LINE_DTR, "DTR"}, {TriggerCapture::LINE_RTS, "RTS"},
+                        {TriggerCapture::LINE_CTS, "CTS"}, {TriggerCapture::LINE_DSR, "DSR"},
+                        {TriggerCapture::LINE_DCD, "DCD"}, {TriggerCapture::LINE_RI, "RI"}};
+
+TriggerCapture::TriggerCapture()
+    : m_capacity(4 * 1024 * 1024)
+    , m_size(0)
+    , m_capturing(false)
+    , m_capturedSize(0)
+    , m_lines(-1)
+{
+}
+
+QString TriggerCapture::ruleTypeName(RuleType type)
+{
+    switch (type) {
+    case RULE_PATTERN:
+        return QObject::tr("Pattern");
+    case RULE_REGEX:
+        return QObject::tr("Regex");
+    case RULE_CONTROL_LINES:
+        return QObject::tr("Control lines");
+    case RULE_SERIAL_ERROR:
+        return QObject::tr("Serial error");
+    }
+    return QString();
+}
+
+QString TriggerCapture::controlLinesName(int lines)
+{
+    QStringList names;
+    for (const auto &entry : controlLineNames) {
+        if (lines & entry.line)
+            names << QLatin1String(entry.name);
+    }
+    return names.join(' ');
+}
+
+void TriggerCapture::setCapacity(qint64 bytes)
+{
+    m_capacity = bytes;
+    while (m_size > m_capacity && !m_records.isEmpty())
+        m_size -= m_records.takeFirst().data.size();
+}
+
+bool TriggerCapture::setRules(const QVector<Rule> &rules, QString *error)
+{
+    PatternMatcher matcher;
+    QVector<int> ruleOfPattern;
+    QVector<QRegularExpression> expressions;
+    QVector<int> ruleOfExpression;
+    QVector<int> lineMasks(rules.size(), -1);
+
+    for (int i = 0; i < rules.size(); i++) {
+        const Rule &rule = rules.at(i);
+        if (!rule.enabled)
+            continue;
+        switch (rule.type) {
+        case RULE_PATTERN: {
+            const int id = matcher.addPattern(PatternMatcher::fromEscaped(rule.argument));
+            if (id < 0) {
+                if (error)
+                    *error = QObject::tr("Rule %1: empty pattern").arg(i + 1);
+                return false;
+            }
+            // the same pattern twice fires the first rule only
+            if (id == ruleOfPattern.size())
+                ruleOfPattern.append(i);
+            break;
+        }
+        case RULE_REGEX: {
+            QRegularExpression expression(rule.argument);
+            if (!expression.isValid()) {
+                if (error)
+                    *error = QObject::tr("Rule %1: %2").arg(i + 1).arg(expression.errorString());
+                return false;
+            }
+            expression.optimize();
+            expressions.append(expression);
+            ruleOfExpression.append(i);
+            break;
+        }
+        case RULE_CONTROL_LINES: {
+            int mask = 0;
+            const QStringList names = rule.argument.split(QRegularExpression("[\\s,|+]+"), QString::SkipEmptyParts);
+            foreach (const QString &name, names) {
+                int line = 0;
+                for (const auto &entry : controlLineNames) {
+                    if (name.compare(QLatin1String(entry.name), Qt::CaseInsensitive) == 0)
+                        line = entry.line;
+                }
+                if (!line) {
+                    if (error)
+                        *error = QObject::tr("Rule %1: unknown control line %2").arg(i + 1).arg(name);
+                    return false;
+                }
+                mask |= line;
+            }
+            lineMasks[i] = mask ? mask : LINE_DTR | LINE_RTS | LINE_CTS | LINE_DSR | LINE_DCD | LINE_RI;
+            break;
+        }
+        case RULE_SERIAL_ERROR:
+            break;
+        }
+    }
+    matcher.build();
+
+    m_rules = rules;
+    for (int i = 0; i < m_rules.size(); i++)
+        m_rules[i].hits = 0;
+    m_matcher = matcher;
+    m_ruleOfPattern = ruleOfPattern;
+    m_expressions = expressions;
+    m_ruleOfExpression = ruleOfExpression;
+    m_lineMasks = lineMasks;
+    m_line.clear();
+    return true;
+}
+
+void TriggerCapture::append(Direction direction, const QByteArray &data, qint64 timestamp)
+{
+    Record record;
+    record.timestamp = timestamp;
+    record.direction = direction;
+    record.data = data;
+    m_records.append(record);
+    m_size += data.size();
+    if (m_capturing && m_capturedSize < m_capacity) {
+        m_captured.append(record);
+        m_capturedSize += data.size();
+    }
+    while (m_size > m_capacity && m_records.size() > 1)
+        m_size -= m_records.takeFirst().data.size();
+}
+
+void TriggerCapture::fire(int rule) { m_rules[rule].hits++; }
+
+void TriggerCapture::recordTx(const QByteArray &data, qint64 timestamp) { append(TX, data, timestamp); }
+
+int TriggerCapture::recordControlLines(int lines, qint64 timestamp)
+{
+    if (lines == m_lines)
+        return -1;
+    append(EVENT, QObject::tr("control lines: %1").arg(controlLinesName(lines)).toLatin1(), timestamp);
+    const int changed = m_lines < 0 ? 0 : lines ^ m_lines;
+    m_lines = lines;
+
+    int fired = -1;
+    for (int i = 0; i < m_lineMasks.size(); i++) {
+        if (m_lineMasks.at(i) >= 0 && (changed & m_lineMasks.at(i))) {
+            fire(i);
+            if (fired < 0)
+                fired = i;
+        }
+    }
+    return fired;
+}
+
+int TriggerCapture::recordError(const QString &message, qint64 timestamp)
+{
+    append(EVENT, QObject::tr("error: %1").arg(message).toLatin1(), timestamp);
+
+    int fired = -1;
+    for (int i = 0; i < m_rules.size(); i++) {
+        const Rule &rule = m_rules.at(i);
+        if (rule.enabled && rule.type == RULE_SERIAL_ERROR && message.contains(rule.argument, Qt::CaseInsensitive)) {
+            fire(i);
+            if (fired < 0)
+                fired = i;
+        }
+    }
+    return fired;
+}
+
+QList<TriggerCapture::Record> TriggerCapture::snapshot(qint64 until) const
+{
+    int count = m_records.size();
+    while (count > 0 && m_records.at(count - 1).timestamp > until)
+        count--;
+    return m_records.mid(0, count);
+}
+
+void TriggerCapture::beginCapture(qint64 triggerTime)
+{
+    // the records share the data with the ring, nothing is copied
+    m_captured = snapshot(triggerTime);
+    m_capturedSize = 0;
+    m_capturing = true;
+}
+
+QList<TriggerCapture::Record> TriggerCapture::takeCapture(qint64 until)
+{
+    QList<Record> records;
+    records.swap(m_captured);
+    m_capturing = false;
+    int count = records.size();
+    while (count > 0 && records.at(count - 1).timestamp > until)
+        count--;
+    return records.mid(0, count);
+}
+
+void TriggerCapture::writeDump(QTextStream &out, const QList<Record> &records, qint64 triggerTime,
+                               const QString &reason)
+{
+    static const char *const directions[] = {"RX", "TX", "EV"};
+
+    out << "# CuteCom trigger capture\n";
+    out << "# trigger: " << reason << "\n";
+    out << "# time: " << CaptureClock::toDateTime(triggerTime).toString(QStringLiteral("yyyy-MM-dd HH:mm:ss.zzz"))
+        << "\n";
+    out << "# offset [ms]  dir  data\n";
+
+    foreach (const Record &record, records) {
+        const QString offset = QString::number((record.timestamp - triggerTime) / 1e6, 'f', 3).rightJustified(13);
+        if (record.direction == EVENT) {
+            out << offset << "  " << directions[EVENT] << "  " << QString::fromLatin1(record.data) << "\n";
+            continue;
+        }
+        // 16 bytes per line, continuation lines have no offset
+        for (int pos = 0; pos < record.data.size(); pos += 16) {
+            const QByteArray bytes = record.data.mid(pos, 16);
+            QString hex;
+            QString ascii;
+            for (char c : bytes) {
+                const uchar b = static_cast<uchar>(c);
+                hex += QString("%1 ").arg(static_cast<uint>(b), 2, 16, QChar('0'));
+                ascii += (b >= 0x20 && b < 0x7f) ? QChar(b) : QChar('.');
+            }
+            out << (pos ? QString(13, ' ') : offset) << "  " << directions[record.direction] << "  "
+                << hex.leftJustified(48) << " |" << ascii << "|\n";
+        }
+    }
+}
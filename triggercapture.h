@@ -0,0 +1,240 @@
+/*
+ * Copyright (c) 2026 CuteCom contributors
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 675 Mass Ave, Cambridge, MA 02139, USA.
+ *
+ * For more information on the GPL, please go to:
+ * http://www.gnu.org/copyleft/gpl.html
+ */
+
+/**
+ * Always-on capture of the recent traffic of a device with triggers.
+ *
+ * Every chunk read from or written to the device is kept in a ring
+ * bounded by the number of bytes, along with control line changes and
+ * errors of the device. The chunks are shared with the read buffers, so
+ * recording does not copy any data.
+ *
+ * The received data are checked against the trigger rules while being
+ * recorded: byte patterns are compiled into one PatternMatcher, so the
+ * data are scanned exactly once no matter how many rules there are.
+ * Regular expressions are applied to complete lines. A trigger only
+ * reports the rule, the caller starts a capture with beginCapture(): the
+ * records up to the trigger are kept from then on, even when the ring
+ * drops them, and the following ones are collected until takeCapture().
+ */
+
+#ifndef TRIGGERCAPTURE_H
+#define TRIGGERCAPTURE_H
+
+#include "patternmatcher.h"
+
+#include <QIODevice>
+#include <QList>
+#include <QRegularExpression>
+#include <QTextStream>
+#include <QVector>
+
+class TriggerCapture
+{
+public:
+    enum Direction { RX, TX, EVENT };
+
+    struct Record {
+        qint64 timestamp;
+        Direction direction;
+        /* the bytes, a description for events */
+        QByteArray data;
+    };
+
+    enum RuleType {
+        RULE_PATTERN,       /* argument: bytes with the escapes of PatternMatcher::fromEscaped() */
+        RULE_REGEX,         /* argument: regular expression, applied to each received line */
+        RULE_CONTROL_LINES, /* argument: lines to watch, e.g. "CTS,DCD", empty for all */
+        RULE_SERIAL_ERROR   /* argument: text the error message must contain, empty for all */
+    };
+
+    struct Rule {
+        Rule()
+            : type(RULE_PATTERN)
+            , enabled(true)
+            , hits(0)
+        {
+        }
+        RuleType type;
+        QString argument;
+        /* disabled rules never fire, e.g. a row being edited */
+        bool enabled;
+        quint64 hits;
+    };
+
+    /* the control lines as reported by QSerialPort::pinoutSignals() */
+    enum ControlLine {
+        LINE_DTR = 0x04,
+        LINE_DCD = 0x08,
+        LINE_DSR = 0x10,
+        LINE_RI = 0x20,
+        LINE_RTS = 0x40,
+        LINE_CTS = 0x80
+    };
+
+    TriggerCapture();
+
+    static QString ruleTypeName(RuleType type);
+    static QString controlLinesName(int lines);
+
+    /**
+     * @brief Bytes of data kept, older records are dropped
+     */
+    void setCapacity(qint64 bytes);
+    qint64 capacity() const { return m_capacity; }
+    qint64 size() const { return m_size; }
+
+    /**
+     * @brief Replace the rules. This resets the hit counters.
+     * @return false if a rule is invalid, the old rules stay in place then
+     */
+    bool setRules(const QVector<Rule> &rules, QString *error);
+    const QVector<Rule> &rules() const { return m_rules; }
+
+    /**
+     * @brief Record received data and check the triggers
+     * @param onTrigger Called as onTrigger(int rule) for every rule that fired
+     */
+    template <typename OnTrigger> void recordRx(const QByteArray &data, qint64 timestamp, OnTrigger onTrigger);
+
+    void recordTx(const QByteArray &data, qint64 timestamp);
+
+    /**
+     * @brief Record the state of the control lines. The first state
+     *  recorded is taken as is, later ones are checked against the rules.
+     * @param lines Combination of ControlLine
+     * @return Index of the first rule that fired or -1
+     */
+    int recordControlLines(int lines, qint64 timestamp);
+
+    /**
+     * @brief Forget about the state of the control lines, e.g. after
+     *  the device has been closed
+     */
+    void resetControlLines() { m_lines = -1; }
+
+    /**
+     * @brief Record an error of the device
+     * @return Index of the first rule that fired or -1
+     */
+    int recordError(const QString &message, qint64 timestamp);
+
+    /**
+     * @brief The records up to and including \a until
+     */
+    QList<Record> snapshot(qint64 until) const;
+
+    /**
+     * @brief Keep the records up to and including \a triggerTime and collect
+     *  all records from now on until takeCapture(). The records after the
+     *  trigger are bounded by the capacity as well.
+     */
+    void beginCapture(qint64 triggerTime);
+    bool isCapturing() const { return m_capturing; }
+
+    /**
+     * @brief End the capture
+     * @return The records of the capture up to and including \a until
+     */
+    QList<Record> takeCapture(qint64 until);
+
+    /**
+     * @brief Write records in a readable form: time relative to the
+     *  trigger, direction, hex bytes and the ASCII representation
+     */
+    static void writeDump(QTextStream &out, const QList<Record> &records, qint64 triggerTime,
+                          const QString &reason);
+
+private:
+    enum { MAX_LINE_LENGTH = 4096 };
+
+    void append(Direction direction, const QByteArray &data, qint64 timestamp);
+    void fire(int rule);
+    template <typename OnTrigger> void matchLine(OnTrigger onTrigger);
+
+    QList<Record> m_records;
+    qint64 m_capacity;
+    qint64 m_size;
+
+    /* the records of a capture, independent of the ring */
+    bool m_capturing;
+    QList<Record> m_captured;
+    /* bytes recorded after the trigger */
+    qint64 m_capturedSize;
+
+    QVector<Rule> m_rules;
+    PatternMatcher m_matcher;
+    /* maps the pattern ids of the matcher to rules */
+    QVector<int> m_ruleOfPattern;
+    QVector<QRegularExpression> m_expressions;
+    QVector<int> m_ruleOfExpression;
+    /* the received line the expressions are applied to */
+    QByteArray m_line;
+    /* watched control lines of each rule, -1 if the rule is not about control lines */
+    QVector<int> m_lineMasks;
+    int m_lines;
+};
+
+template <typename OnTrigger>
+void TriggerCapture::recordRx(const QByteArray &data, qint64 timestamp, OnTrigger onTrigger)
+{
+    append(RX, data, timestamp);
+
+    if (!m_matcher.isEmpty()) {
+        m_matcher.feed(data.constData(), data.size(), [&](int id, int) {
+            fire(m_ruleOfPattern.at(id));
+            onTrigger(m_ruleOfPattern.at(id));
+            return true;
+        });
+    }
+
+    if (!m_expressions.isEmpty()) {
+        int start = 0;
+        while (start < data.size()) {
+            const int end = data.indexOf('\n', start);
+            if (end < 0) {
+                m_line.append(data.constData() + start, data.size() - start);
+                if (m_line.size() >= MAX_LINE_LENGTH)
+                    matchLine(onTrigger);
+                break;
+            }
+            m_line.append(data.constData() + start, end - start);
+            matchLine(onTrigger);
+            start = end + 1;
+        }
+    }
+}
+
+template <typename OnTrigger> void TriggerCapture::matchLine(OnTrigger onTrigger)
+{
+    if (m_line.endsWith('\r'))
+        m_line.chop(1);
+    const QString line = QString::fromLatin1(m_line);
+    for (int i = 0; i < m_expressions.size(); i++) {
+        if (m_expressions.at(i).match(line).hasMatch()) {
+            fire(m_ruleOfExpression.at(i));
+            onTrigger(m_ruleOfExpression.at(i));
+        }
+    }
+    m_line.clear();
+}
+
+#endif // TRIGGERCAPTURE_H
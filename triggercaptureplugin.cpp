@@ -0,0 +1,346 @@
+/*
+ * Copyright (c) 2026 CuteCom contributors
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 675 Mass Ave, Cambridge, MA 02139, USA.
+ *
+ * For more information on the GPL, please go to:
+ * http://www.gnu.org/copyleft/gpl.html
+ */
+
+#include "triggercaptureplugin.h"
+#include "captureclock.h"
+#include "ui_triggercaptureplugin.h"
+#include <QComboBox>
+#include <QDir>
+#include <QFile>
+#include <QFileDialog>
+#include <QFileInfo>
+#include <QHeaderView>
+#include <QMessageBox>
+#include <QRunnable>
+
+#include <algorithm>
+
+#define TRACE                                                                                                          \
+    if (!debug) {                                                                                                      \
+    } else                                                                                                             \
+        qDebug()
+
+static bool debug = false;
+
+/**
+ * Writes one capture file on a thread of the dump pool, so
+ * neither the reception nor the GUI wait for the disk
+ */
+class TriggerCapturePlugin::DumpTask : public QRunnable
+{
+public:
+    DumpTask(TriggerCapturePlugin *plugin, const QString &fileName, const QList<TriggerCapture::Record> &records,
+             qint64 triggerTime, const QString &reason)
+        : m_plugin(plugin)
+        , m_fileName(fileName)
+        , m_records(records)
+        , m_triggerTime(triggerTime)
+        , m_reason(reason)
+    {
+    }
+
+    void run() override
+    {
+        QString error;
+        QFile file(m_fileName);
+        if (file.open(QIODevice::WriteOnly | QIODevice::Text | QIODevice::Truncate)) {
+            QTextStream out(&file);
+            TriggerCapture::writeDump(out, m_records, m_triggerTime, m_reason);
+            out.flush();
+            if (file.error() != QFile::NoError)
+                error = file.errorString();
+        } else {
+            error = file.errorString();
+        }
+        // the plugin waits for the pool before it goes away
+        QMetaObject::invokeMethod(m_plugin, "dumpFinished", Qt::QueuedConnection, Q_ARG(QString, m_fileName),
+                                  Q_ARG(QString, error));
+    }
+
+private:
+    TriggerCapturePlugin *m_plugin;
+    QString m_fileName;
+    QList<TriggerCapture::Record> m_records;
+    qint64 m_triggerTime;
+    QString m_reason;
+};
+
+TriggerCapturePlugin::TriggerCapturePlugin(QFrame *parent, Settings *settings)
+    : QFrame(parent)
+    , ui(new Ui::TriggerCapturePlugin)
+    , m_settings(settings)
+    , m_triggered(false)
+    , m_triggerTime(0)
+    , m_captures(0)
+{
+    ui->setupUi(this);
+    /* Has QFrame, records the data to send without changing them, matches the
+     * received data right in the read handler */
+    m_plugin = new Plugin(this, "Trigger capture", this, &TriggerCapturePlugin::processTx);
+    m_plugin->processRx = &TriggerCapturePlugin::processRx;
+    m_plugin->processEvent = &TriggerCapturePlugin::processEvent;
+
+    ui->m_table_rules->horizontalHeader()->setSectionResizeMode(QHeaderView::Stretch);
+    ui->m_table_rules->verticalHeader()->hide();
+    ui->m_edit_directory->setText(QFileInfo(m_settings->getLogFileLocation()).absolutePath());
+    m_capture.setCapacity(qint64(ui->m_sb_ring->value()) * 1024 * 1024);
+    m_dumpPool.setMaxThreadCount(1);
+
+    connect(ui->m_bt_unload, &QPushButton::clicked, this, &TriggerCapturePlugin::removePlugin);
+    connect(ui->m_bt_help, &QPushButton::clicked, this, &TriggerCapturePlugin::helpMsg);
+    connect(ui->m_bt_add, &QPushButton::clicked, this, &TriggerCapturePlugin::addRule);
+    connect(ui->m_bt_remove, &QPushButton::clicked, this, &TriggerCapturePlugin::removeRules);
+    connect(ui->m_bt_directory, &QToolButton::clicked, this, &TriggerCapturePlugin::chooseDirectory);
+    connect(ui->m_table_rules, &QTableWidget::itemChanged, this, &TriggerCapturePlugin::rulesEdited);
+    connect(ui->m_sb_ring, static_cast<void (QSpinBox::*)(int)>(&QSpinBox::valueChanged),
+            [=](int megabytes) { m_capture.setCapacity(qint64(megabytes) * 1024 * 1024); });
+    connect(ui->m_cb_armed, &QCheckBox::toggled, this, &TriggerCapturePlugin::updateStatus);
+
+    m_postTriggerTimer.setSingleShot(true);
+    connect(&m_postTriggerTimer, &QTimer::timeout, this, &TriggerCapturePlugin::dump);
+    connect(&m_statusTimer, &QTimer::timeout, this, &TriggerCapturePlugin::updateStatus);
+    m_statusTimer.start(250);
+    updateStatus();
+
+    TRACE << "[TriggerCapturePlugin::TriggerCapturePlugin]";
+}
+
+TriggerCapturePlugin::~TriggerCapturePlugin()
+{
+    m_dumpPool.waitForDone();
+    delete ui;
+}
+
+/**
+ * @brief Called by the plugin manager with the data read from the device
+ *  before it is being displayed
+ */
+void TriggerCapturePlugin::processRx(QObject *owner, const QByteArray &data, qint64 timestamp)
+{
+    TriggerCapturePlugin *self = static_cast<TriggerCapturePlugin *>(owner);
+    self->m_capture.recordRx(data, timestamp, [self, timestamp](int rule) { self->trigger(rule, timestamp); });
+}
+
+/**
+ * @brief Called by the plugin manager with the data about to be written
+ */
+Plugin::TxResult TriggerCapturePlugin::processTx(QObject *owner, QByteArray &data)
+{
+    TriggerCapturePlugin *self = static_cast<TriggerCapturePlugin *>(owner);
+    self->m_capture.recordTx(data, CaptureClock::nsecsElapsed());
+    return Plugin::TX_UNCHANGED;
+}
+
+/**
+ * @brief Called by the plugin manager with changes of the control lines
+ *  and errors of the device
+ */
+void TriggerCapturePlugin::processEvent(QObject *owner, Plugin::DeviceEvent event, int value,
+                                        const QString &message, qint64 timestamp)
+{
+    TriggerCapturePlugin *self = static_cast<TriggerCapturePlugin *>(owner);
+    int rule = -1;
+    if (event == Plugin::EVENT_CONTROL_LINES)
+        rule = self->m_capture.recordControlLines(value, timestamp);
+    else if (event == Plugin::EVENT_ERROR)
+        rule = self->m_capture.recordError(message, timestamp);
+    if (rule >= 0)
+        self->trigger(rule, timestamp);
+}
+
+/**
+ * @brief A rule fired: collect the data after it for the post-trigger
+ *  time, further triggers until then go into the same capture
+ */
+void TriggerCapturePlugin::trigger(int rule, qint64 timestamp)
+{
+    if (m_triggered || !ui->m_cb_armed->isChecked())
+        return;
+    const TriggerCapture::Rule &fired = m_capture.rules().at(rule);
+    m_triggered = true;
+    m_triggerTime = timestamp;
+    m_triggerReason = QString("%1 %2").arg(TriggerCapture::ruleTypeName(fired.type)).arg(fired.argument).trimmed();
+    // the ring may drop the data before the trigger until the post-trigger time is over
+    m_capture.beginCapture(timestamp);
+    m_postTriggerTimer.start(ui->m_sb_post->value());
+    TRACE << "[TriggerCapturePlugin::trigger]" << m_triggerReason;
+}
+
+/**
+ * @brief The post-trigger time is over, hand the capture to the dump pool
+ */
+void TriggerCapturePlugin::dump()
+{
+    const qint64 until = m_triggerTime + qint64(ui->m_sb_post->value()) * 1000000;
+    const QString stamp = CaptureClock::toDateTime(m_triggerTime).toString(QStringLiteral("yyyyMMdd-HHmmss-zzz"));
+    const QString fileName
+        = QDir(ui->m_edit_directory->text()).filePath(QStringLiteral("cutecom-trigger-%1.txt").arg(stamp));
+    m_dumpPool.start(new DumpTask(this, fileName, m_capture.takeCapture(until), m_triggerTime, m_triggerReason));
+    m_triggered = false;
+    updateStatus();
+}
+
+void TriggerCapturePlugin::dumpFinished(const QString &fileName, const QString &error)
+{
+    if (error.isEmpty()) {
+        m_captures++;
+        m_lastMessage = tr("last: %1").arg(QFileInfo(fileName).fileName());
+    } else {
+        m_lastMessage = tr("writing %1 failed: %2").arg(fileName).arg(error);
+    }
+    updateStatus();
+}
+
+void TriggerCapturePlugin::updateStatus()
+{
+    const QVector<TriggerCapture::Rule> &rules = m_capture.rules();
+    ui->m_table_rules->blockSignals(true);
+    for (int row = 0; row < rules.size() && row < ui->m_table_rules->rowCount(); row++)
+        ui->m_table_rules->item(row, COL_HITS)->setText(QString::number(rules.at(row).hits));
+    ui->m_table_rules->blockSignals(false);
+
+    QString state;
+    if (m_triggered)
+        state = tr("Triggered by %1").arg(m_triggerReason);
+    else if (ui->m_cb_armed->isChecked())
+        state = tr("Armed");
+    else
+        state = tr("Not armed");
+    ui->m_lbl_status->setText(tr("%1, ring %2 of %3 MB, %4 captures %5")
+                                  .arg(state)
+                                  .arg(m_capture.size() / (1024.0 * 1024.0), 0, 'f', 1)
+                                  .arg(m_capture.capacity() / (1024 * 1024))
+                                  .arg(m_captures)
+                                  .arg(m_lastMessage));
+}
+
+void TriggerCapturePlugin::appendRow(const TriggerCapture::Rule &rule)
+{
+    const int row = ui->m_table_rules->rowCount();
+    ui->m_table_rules->insertRow(row);
+
+    QComboBox *type = new QComboBox(ui->m_table_rules);
+    for (int i = TriggerCapture::RULE_PATTERN; i <= TriggerCapture::RULE_SERIAL_ERROR; i++)
+        type->addItem(TriggerCapture::ruleTypeName(static_cast<TriggerCapture::RuleType>(i)), i);
+    type->setCurrentIndex(type->findData(rule.type));
+    connect(type, static_cast<void (QComboBox::*)(int)>(&QComboBox::currentIndexChanged), this,
+            &TriggerCapturePlugin::rulesEdited);
+    ui->m_table_rules->setCellWidget(row, COL_TYPE, type);
+
+    ui->m_table_rules->setItem(row, COL_ARGUMENT, new QTableWidgetItem(rule.argument));
+    QTableWidgetItem *hits = new QTableWidgetItem();
+    hits->setFlags(hits->flags() & ~Qt::ItemIsEditable);
+    ui->m_table_rules->setItem(row, COL_HITS, hits);
+}
+
+void TriggerCapturePlugin::addRule()
+{
+    ui->m_table_rules->blockSignals(true);
+    appendRow(TriggerCapture::Rule());
+    ui->m_table_rules->blockSignals(false);
+    ui->m_table_rules->editItem(ui->m_table_rules->item(ui->m_table_rules->rowCount() - 1, COL_ARGUMENT));
+}
+
+void TriggerCapturePlugin::removeRules()
+{
+    QList<QTableWidgetSelectionRange> ranges = ui->m_table_rules->selectedRanges();
+    // remove from the bottom, so the row numbers stay valid
+    std::sort(ranges.begin(), ranges.end(), [](const QTableWidgetSelectionRange &a,
+                                               const QTableWidgetSelectionRange &b) { return a.topRow() > b.topRow(); });
+    ui->m_table_rules->blockSignals(true);
+    foreach (const QTableWidgetSelectionRange &range, ranges) {
+        for (int row = range.bottomRow(); row >= range.topRow(); row--)
+            ui->m_table_rules->removeRow(row);
+    }
+    ui->m_table_rules->blockSignals(false);
+    rulesEdited();
+}
+
+/**
+ * @brief A trigger has been changed: recompile all rules. Invalid
+ *  rules are reported and leave the previous rules active.
+ */
+void TriggerCapturePlugin::rulesEdited()
+{
+    QVector<TriggerCapture::Rule> rules;
+    for (int row = 0; row < ui->m_table_rules->rowCount(); row++) {
+        const QComboBox *type = static_cast<QComboBox *>(ui->m_table_rules->cellWidget(row, COL_TYPE));
+        TriggerCapture::Rule rule;
+        rule.type = static_cast<TriggerCapture::RuleType>(type->currentData().toInt());
+        rule.argument = ui->m_table_rules->item(row, COL_ARGUMENT)->text();
+        // a new pattern rule has no argument yet, it keeps its row nevertheless
+        rule.enabled = !(rule.type == TriggerCapture::RULE_PATTERN && rule.argument.isEmpty());
+        rules.append(rule);
+    }
+    QString error;
+    if (!m_capture.setRules(rules, &error)) {
+        m_lastMessage = error;
+        updateStatus();
+        return;
+    }
+    m_lastMessage.clear();
+    updateStatus();
+}
+
+void TriggerCapturePlugin::chooseDirectory()
+{
+    QString directory
+        = QFileDialog::getExistingDirectory(this, tr("Directory for capture files"), ui->m_edit_directory->text());
+    if (!directory.isEmpty())
+        ui->m_edit_directory->setText(directory);
+}
+
+/**
+ * @brief Return a pointer to the plugin data
+ * @return
+ */
+const Plugin *TriggerCapturePlugin::plugin() { return m_plugin; }
+
+/**
+ * @brief [SLOT] Send unload command to the plugin manager
+ */
+void TriggerCapturePlugin::removePlugin(bool) { emit unload(m_plugin); }
+
+/**
+ * @brief Help message for the trigger capture plugin
+ */
+void TriggerCapturePlugin::helpMsg(void)
+{
+    QString help_str = tr("This plugin keeps the data received from and sent to the\n"
+                          "device in memory, along with changes of the control lines\n"
+                          "and errors of the device. Only the last megabytes are kept.\n\n"
+                          "When a trigger fires, the data are collected for the\n"
+                          "post-trigger time. Then everything kept, from before and\n"
+                          "after the trigger, is written to a file in the directory:\n"
+                          "    cutecom-trigger-<date>-<time>.txt\n\n"
+                          "Triggers:\n"
+                          "    Pattern: received bytes, supports the escapes\n"
+                          "        \\r \\n \\t \\0 \\\\ and \\xNN\n"
+                          "    Regex: regular expression applied to each received line\n"
+                          "    Control lines: a change of the given lines,\n"
+                          "        e.g. CTS,DCD, empty for all\n"
+                          "    Serial error: an error of the device whose message\n"
+                          "        contains the argument, empty for all\n\n"
+                          "The data sent are recorded as they are handed to the\n"
+                          "plugins loaded after this one.\n");
+
+    QMessageBox::information(this, tr("How to use the trigger capture"), help_str);
+}
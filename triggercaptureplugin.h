@@ -0,0 +1,99 @@
+/*
+ * Copyright (c) 2026 CuteCom contributors
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 675 Mass Ave, Cambridge, MA 02139, USA.
+ *
+ * For more information on the GPL, please go to:
+ * http://www.gnu.org/copyleft/gpl.html
+ */
+
+#ifndef TRIGGERCAPTUREPLUGIN_H
+#define TRIGGERCAPTUREPLUGIN_H
+
+#include "plugin.h"
+#include "settings.h"
+#include "triggercapture.h"
+#include <QDebug>
+#include <QFrame>
+#include <QThreadPool>
+#include <QTimer>
+
+namespace Ui
+{
+class TriggerCapturePlugin;
+}
+
+class TriggerCapturePlugin : public QFrame
+{
+    Q_OBJECT
+
+public:
+    explicit TriggerCapturePlugin(QFrame *parent, Settings *settings);
+    ~TriggerCapturePlugin();
+    const Plugin *plugin();
+
+signals:
+    void unload(Plugin *);
+
+public slots:
+    void removePlugin(bool);
+    void helpMsg(void);
+
+private slots:
+    void addRule();
+    void removeRules();
+    void rulesEdited();
+    void chooseDirectory();
+    void updateStatus();
+    void dump();
+    void dumpFinished(const QString &fileName, const QString &error);
+
+private:
+    enum Columns { COL_TYPE, COL_ARGUMENT, COL_HITS };
+    class DumpTask;
+
+    static void processRx(QObject *owner, const QByteArray &data, qint64 timestamp);
+    static Plugin::TxResult processTx(QObject *owner, QByteArray &data);
+    static void processEvent(QObject *owner, Plugin::DeviceEvent event, int value, const QString &message,
+                             qint64 timestamp);
+    void trigger(int rule, qint64 timestamp);
+    void appendRow(const TriggerCapture::Rule &rule);
+
+    Ui::TriggerCapturePlugin *ui;
+    Plugin *m_plugin;
+    Settings *m_settings;
+    TriggerCapture m_capture;
+    /**
+     * A trigger fired, the data after it are collected until
+     * m_postTriggerTimer runs out
+     * @brief m_triggered
+     */
+    bool m_triggered;
+    qint64 m_triggerTime;
+    QString m_triggerReason;
+    QTimer m_postTriggerTimer;
+    /**
+     * The hit counters are updated on every trigger,
+     * the table is refreshed by this timer only
+     * @brief m_statusTimer
+     */
+    QTimer m_statusTimer;
+    /* writes the capture files, one at a time */
+    QThreadPool m_dumpPool;
+    int m_captures;
+    QString m_lastMessage;
+};
+
+#endif // TRIGGERCAPTUREPLUGIN_H
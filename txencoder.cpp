@@ -0,0 +1,118 @@
+/*
+ * Copyright (c) 2026 CuteCom contributors
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 675 Mass Ave, Cambridge, MA 02139, USA.
+ *
+ * For more information on the GPL, please go to:
+ * http://www.gnu.org/copyleft/gpl.html
+ */
+
+#include "txencoder.h"
+
+#include <QObject>
+#include <QRegExp>
+
+bool TxEncoder::encode(const QString &input, Settings::LineTerminator lineMode, QByteArray *bytes, QString *error)
+{
+    if (lineMode == Settings::HEX)
+        return encodeHex(input, bytes, error);
+
+    // converts QString into QByteArray, this supports converting control characters being shown in input field
+    // as QChars of Control Pictures from Unicode block.
+    QByteArray data;
+    data.reserve(input.size() + 2);
+    for (auto &c : input) {
+        data.append(static_cast<char>(c.unicode()));
+    }
+
+    switch (lineMode) {
+    case Settings::LF:
+        data.append('\n');
+        break;
+    case Settings::CR:
+        data.append('\r');
+        break;
+    case Settings::CRLF:
+        data.append("\r\n", 2);
+        break;
+    default:
+        break;
+    }
+    *bytes = data;
+    return true;
+}
+
+bool TxEncoder::encodeHex(const QString &input, QByteArray *bytes, QString *error)
+{
+    QString hex = input;
+    hex.remove(QRegExp("\\s+(?=(?:[^\"]*\"[^\"]*\")*[^\"]*$)")); // spaces except that in quotes
+    if ((hex.startsWith("0x")) || (hex.startsWith("0X"))) {
+        hex = hex.mid(2);
+    }
+
+    bool ascii = false;
+    for (int i = 0; i < hex.length();) {
+        QString nextByte = hex.mid(i, ascii ? 1 : 2);
+        i += ascii ? 1 : 2;
+        if (nextByte.left(1) == "\"") {
+            if (!ascii)
+                ascii = true;
+            else {
+                ascii = false;
+                continue;
+            }
+        }
+        if (ascii)
+            continue;
+        bool ok = true;
+        nextByte.toUInt(&ok, 16);
+        if (!ok) {
+            if (error)
+                *error = QObject::tr("The input string contains invalid hex characters: 0x%1").arg(nextByte);
+            return false;
+        }
+    }
+
+    if (ascii) {
+        if (error)
+            *error = QObject::tr("No closing quote");
+        return false;
+    }
+
+    QByteArray data;
+    data.reserve(hex.length() / 2);
+    for (int i = 0; i < hex.length();) {
+        QString nextByte = hex.mid(i, ascii ? 1 : 2);
+        i += ascii ? 1 : 2;
+        if (nextByte.left(1) == "\"") {
+            if (!ascii) {
+                ascii = true;
+                nextByte = nextByte.right(1);
+            } else {
+                ascii = false;
+                continue;
+            }
+        }
+        unsigned int byte;
+        if (ascii)
+            byte = nextByte.at(0).unicode() & 0xFF;
+        else
+            byte = nextByte.toUInt(0, 16);
+
+        data.append(static_cast<char>(byte & 0xff));
+    }
+    *bytes = data;
+    return true;
+}
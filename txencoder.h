@@ -0,0 +1,49 @@
+/*
+ * Copyright (c) 2026 CuteCom contributors
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 675 Mass Ave, Cambridge, MA 02139, USA.
+ *
+ * For more information on the GPL, please go to:
+ * http://www.gnu.org/copyleft/gpl.html
+ */
+
+#ifndef TXENCODER_H
+#define TXENCODER_H
+
+#include "settings.h"
+
+#include <QByteArray>
+#include <QString>
+
+/**
+ * Turns a line of the input field into the bytes written to the device:
+ * hex bytes with optional quoted ASCII, e.g. 0x01 "AT" 0d, or the text
+ * followed by the line terminator.
+ */
+class TxEncoder
+{
+public:
+    /**
+     * @brief Encode a line of input
+     * @param error Set to the reason if the input is invalid
+     * @return false if the input is invalid, \a bytes is left alone then
+     */
+    static bool encode(const QString &input, Settings::LineTerminator lineMode, QByteArray *bytes, QString *error);
+
+private:
+    static bool encodeHex(const QString &input, QByteArray *bytes, QString *error);
+};
+
+#endif // TXENCODER_H
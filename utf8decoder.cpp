@@ -0,0 +1,55 @@
+/*
+ * Copyright (c) 2026 CuteCom contributors
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 675 Mass Ave, Cambridge, MA 02139, USA.
+ *
+ * For more information on the GPL, please go to:
+ * http://www.gnu.org/copyleft/gpl.html
+ */
+
+#include "utf8decoder.h"
+
+#include <cstring>
+
+/*
+ * Byte wise tests on 64 bit words, see "Bit Twiddling Hacks":
+ * hasLess() is non zero if any byte of x is below n (n <= 128)
+ */
+static inline quint64 hasLess(quint64 x, quint64 n)
+{
+    const quint64 ones = Q_UINT64_C(0x0101010101010101);
+    return (x - ones * n) & ~x & (ones * 0x80);
+}
+
+static inline bool isPrintableAscii(quint64 x)
+{
+    const quint64 ones = Q_UINT64_C(0x0101010101010101);
+    // no high bit, nothing below ' ' and no DEL
+    return !((x & (ones * 0x80)) | hasLess(x, 0x20) | hasLess(x ^ (ones * 0x7f), 1));
+}
+
+int Utf8Decoder::printableAsciiRun(const char *data, int len)
+{
+    int i = 0;
+    for (; i + 16 <= len; i += 16) {
+        quint64 words[2];
+        memcpy(words, data + i, sizeof(words));
+        if (!isPrintableAscii(words[0]) || !isPrintableAscii(words[1]))
+            break;
+    }
+    while (i < len && static_cast<uchar>(data[i]) >= 0x20 && static_cast<uchar>(data[i]) < 0x7f)
+        i++;
+    return i;
+}
@@ -0,0 +1,153 @@
+/*
+ * Copyright (c) 2026 CuteCom contributors
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 675 Mass Ave, Cambridge, MA 02139, USA.
+ *
+ * For more information on the GPL, please go to:
+ * http://www.gnu.org/copyleft/gpl.html
+ */
+
+/**
+ * Incremental UTF-8 decoder for the text display.
+ *
+ * The data read from the device is split at arbitrary positions, so a
+ * multi byte sequence may start in one chunk and end in the next one.
+ * The decoder keeps the bytes of an incomplete sequence until it is
+ * either completed or broken by a byte that does not fit. Overlong
+ * encodings, surrogates and code points beyond U+10FFFF are rejected,
+ * the bytes of rejected sequences are reported one by one.
+ *
+ * Usage:
+ *   if (!decoder.feed(byte, onCharacter, onInvalid))
+ *       handleAscii(byte);
+ */
+
+#ifndef UTF8DECODER_H
+#define UTF8DECODER_H
+
+#include <QtGlobal>
+
+class Utf8Decoder
+{
+public:
+    Utf8Decoder() { reset(); }
+
+    /**
+     * @brief Forget about an incomplete sequence
+     */
+    void reset()
+    {
+        m_needed = 0;
+        m_seen = 0;
+    }
+
+    /**
+     * @brief The last bytes fed are the start of an incomplete sequence
+     */
+    bool isPending() const { return m_seen != 0; }
+
+    /**
+     * @brief Number of printable ASCII characters (0x20 - 0x7e) at the
+     *  start of data. Checks 16 bytes at a time.
+     */
+    static int printableAsciiRun(const char *data, int len);
+
+    /**
+     * @brief Feed one byte
+     * @param onCharacter Called as onCharacter(uint codePoint) for each completed character
+     * @param onInvalid Called as onInvalid(uchar byte) for each byte which
+     *  is not part of a valid sequence
+     * @return false if the byte is ASCII and has not been consumed. The
+     *  bytes of an incomplete sequence in front of it are reported invalid.
+     */
+    template <typename OnCharacter, typename OnInvalid>
+    bool feed(uchar byte, OnCharacter onCharacter, OnInvalid onInvalid);
+
+    /**
+     * @brief Report the bytes of an incomplete sequence as invalid, e.g.
+     *  at the end of a line
+     */
+    template <typename OnInvalid> void flush(OnInvalid onInvalid);
+
+private:
+    uint m_codePoint;
+    /* continuation bytes still missing */
+    int m_needed;
+    /* bytes of the incomplete sequence */
+    int m_seen;
+    uchar m_pending[3];
+    /* range of the next continuation byte */
+    uchar m_lower;
+    uchar m_upper;
+};
+
+template <typename OnCharacter, typename OnInvalid>
+bool Utf8Decoder::feed(uchar byte, OnCharacter onCharacter, OnInvalid onInvalid)
+{
+    if (m_needed) {
+        if (byte >= m_lower && byte <= m_upper) {
+            m_codePoint = (m_codePoint << 6) | (byte & 0x3f);
+            m_pending[m_seen++] = byte;
+            m_lower = 0x80;
+            m_upper = 0xbf;
+            if (--m_needed == 0) {
+                m_seen = 0;
+                onCharacter(m_codePoint);
+            }
+            return true;
+        }
+        // broken sequence, the byte may start a new one
+        flush(onInvalid);
+    }
+
+    if (byte < 0x80)
+        return false;
+
+    m_lower = 0x80;
+    m_upper = 0xbf;
+    if (byte >= 0xc2 && byte <= 0xdf) {
+        m_needed = 1;
+        m_codePoint = byte & 0x1f;
+    } else if (byte >= 0xe0 && byte <= 0xef) {
+        m_needed = 2;
+        m_codePoint = byte & 0x0f;
+        if (byte == 0xe0)
+            m_lower = 0xa0; // overlong
+        else if (byte == 0xed)
+            m_upper = 0x9f; // surrogates
+    } else if (byte >= 0xf0 && byte <= 0xf4) {
+        m_needed = 3;
+        m_codePoint = byte & 0x07;
+        if (byte == 0xf0)
+            m_lower = 0x90; // overlong
+        else if (byte == 0xf4)
+            m_upper = 0x8f; // beyond U+10FFFF
+    } else {
+        onInvalid(byte);
+        return true;
+    }
+    m_pending[0] = byte;
+    m_seen = 1;
+    return true;
+}
+
+template <typename OnInvalid> void Utf8Decoder::flush(OnInvalid onInvalid)
+{
+    for (int i = 0; i < m_seen; i++)
+        onInvalid(m_pending[i]);
+    reset();
+}
+
+#endif // UTF8DECODER_H